@@ -0,0 +1,190 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katefiletreemodel.h"
+
+#include "document_dummy.h"
+
+#include <QtTest>
+
+/**
+ * Opening a large session: documents one by one vs. one batch.
+ * Switching views in a large session: shading updates per activation.
+ */
+class FileTreeModelBench : public QObject
+{
+  Q_OBJECT
+
+  private Q_SLOTS:
+    void cleanup();
+
+    void openDocuments_data();
+    void openDocuments();
+
+    void activateDocuments();
+
+  private:
+    QList<DummyDocument *> m_docs;
+};
+
+QTEST_GUILESS_MAIN(FileTreeModelBench)
+
+static const int DocumentCount = 5000;
+
+/**
+ * some deep trees, some roots that get merged later on
+ */
+static QList<DummyDocument *> createDocuments()
+{
+  QList<DummyDocument *> docs;
+  for (int i = 0; i < DocumentCount; ++i) {
+    const QString url = (i % 10 == 0)
+      ? QStringLiteral("file:///bench/p%1/file%2.txt").arg(i % 13).arg(i)
+      : QStringLiteral("file:///bench/p%1/sub%2/deep%3/file%4.txt").arg(i % 13).arg(i % 7).arg(i % 3).arg(i);
+    docs << new DummyDocument(url);
+  }
+  return docs;
+}
+
+static void dumpTree(const QAbstractItemModel &model, const QModelIndex &parent, const QString &indent, QString &out)
+{
+  for (int i = 0; i < model.rowCount(parent); ++i) {
+    const QModelIndex idx = model.index(i, 0, parent);
+    out += indent + idx.data().toString() + QLatin1Char('\n');
+    dumpTree(model, idx, indent + QLatin1Char(' '), out);
+  }
+}
+
+void FileTreeModelBench::cleanup()
+{
+  qDeleteAll(m_docs);
+  m_docs.clear();
+}
+
+void FileTreeModelBench::openDocuments_data()
+{
+  QTest::addColumn<bool>("batch");
+
+  QTest::newRow("single") << false;
+  QTest::newRow("batch") << true;
+}
+
+void FileTreeModelBench::openDocuments()
+{
+  QFETCH(bool, batch);
+
+  m_docs = createDocuments();
+  QList<KTextEditor::Document *> list;
+  foreach(DummyDocument *doc, m_docs) {
+    list << doc;
+  }
+
+  KateFileTreeModel model(this);
+  QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+  QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+  QSignalSpy reset(&model, SIGNAL(modelReset()));
+
+  QBENCHMARK_ONCE {
+    if (batch) {
+      model.documentsOpened(list);
+    } else {
+      foreach(KTextEditor::Document *doc, list) {
+        model.documentOpened(doc);
+      }
+    }
+  }
+
+  qDebug() << "rowsInserted:" << inserted.count() << "rowsRemoved:" << removed.count() << "modelReset:" << reset.count();
+
+  if (batch) {
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(reset.count(), 1);
+  } else {
+    QVERIFY(inserted.count() >= DocumentCount);
+    QCOMPARE(reset.count(), 0);
+  }
+
+  // both ways end up with the same tree
+  KateFileTreeModel reference(this);
+  foreach(KTextEditor::Document *doc, list) {
+    reference.documentOpened(doc);
+  }
+
+  QString tree, referenceTree;
+  dumpTree(model, QModelIndex(), QString(), tree);
+  dumpTree(reference, QModelIndex(), QString(), referenceTree);
+  QCOMPARE(tree, referenceTree);
+}
+
+void FileTreeModelBench::activateDocuments()
+{
+  const int documentCount = 2000;
+  const int activations = 100000;
+
+  QList<DummyDocument *> docs;
+  KateFileTreeModel model(this);
+  for (int i = 0; i < documentCount; ++i) {
+    docs << new DummyDocument(QStringLiteral("file:///bench/p%1/file%2.txt").arg(i % 13).arg(i));
+  }
+  m_docs = docs;
+
+  QList<KTextEditor::Document *> list;
+  foreach(DummyDocument *doc, docs) {
+    list << doc;
+  }
+  model.documentsOpened(list);
+
+  QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+  // mostly switching between a few recent documents, sometimes another one, sometimes an edit
+  quint32 seed = 42;
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+  };
+
+  QElapsedTimer timer;
+  QBENCHMARK_ONCE {
+    timer.start();
+    for (int i = 0; i < activations; ++i) {
+      const int r = next();
+      const int index = (r % 4) ? (r % 12) : (r % documentCount);
+      model.documentActivated(docs[index]);
+      if (r % 16 == 0) {
+        model.documentEdited(docs[index]);
+      }
+    }
+  }
+
+  const qint64 elapsed = timer.nsecsElapsed();
+  qDebug() << "ns per activation:" << (elapsed / activations) << "dataChanged per activation:" << (double(changed.count()) / activations);
+
+  // never more than both histories shaded
+  int shaded = 0;
+  foreach(DummyDocument *doc, docs) {
+    if (model.docIndex(doc).data(Qt::BackgroundRole).isValid()) {
+      ++shaded;
+    }
+  }
+  QVERIFY(shaded > 0 && shaded <= 20);
+}
+
+#include "filetree_model_bench.moc"
@@ -460,6 +460,49 @@ void FileTreeModelTest::buildTreeBatchPrefill()
   qDeleteAll(documents);
 }
 
+void FileTreeModelTest::shading()
+{
+  KateFileTreeModel m(this);
+  m.setViewShade(Qt::red);
+  m.setEditShade(Qt::blue);
+
+  QList<DummyDocument *> documents;
+  for (int i = 0; i < 12; ++i) {
+    documents << new DummyDocument(QStringLiteral("file:///a/foo%1.txt").arg(i));
+    m.documentOpened(documents.last());
+  }
+
+  // fill the view history, it keeps the last ten
+  for (int i = 0; i < 10; ++i) {
+    m.documentActivated(documents[i]);
+  }
+
+  QSignalSpy changed(&m, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+  // already the latest one: nothing to repaint
+  m.documentActivated(documents[9]);
+  QCOMPARE(changed.count(), 0);
+
+  // fifth one to the front, only the four in front of it move down
+  m.documentActivated(documents[5]);
+  QCOMPARE(changed.count(), 5);
+  changed.clear();
+
+  // new one: all ranks change, the oldest one looses its shading
+  m.documentActivated(documents[11]);
+  QCOMPARE(changed.count(), 11);
+  QVERIFY(!m.docIndex(documents[0]).data(Qt::BackgroundRole).isValid());
+  QVERIFY(m.docIndex(documents[11]).data(Qt::BackgroundRole).isValid());
+  QVERIFY(m.docIndex(documents[11]).data(Qt::BackgroundRole) != m.docIndex(documents[5]).data(Qt::BackgroundRole));
+  changed.clear();
+
+  // the edit shade only mixes into the edited one
+  m.documentEdited(documents[11]);
+  QCOMPARE(changed.count(), 1);
+
+  qDeleteAll(documents);
+}
+
 void FileTreeModelTest::walkTree(KateFileTreeModel &model, const QModelIndex &rootIndex, ResultNode &rootNode)
 {
   if (!model.hasChildren(rootIndex)) {
@@ -851,6 +894,57 @@ void FileTreeModelTest::deleteDocumentBatch()
   qDeleteAll(documents);
 }
 
+void FileTreeModelTest::deleteDocumentBatchRows()
+{
+  KateFileTreeModel m(this);
+  QList<DummyDocument *> documents;
+  for (int i = 0; i < 8; ++i) {
+    documents << new DummyDocument(QStringLiteral("file:///a/foo%1.txt").arg(i));
+  }
+  documents << new DummyDocument("file:///a/b/bar.txt");
+
+  foreach (DummyDocument *doc, documents) {
+    m.documentOpened(doc);
+  }
+
+  // two runs in a/, b/ gets empty
+  QList<KTextEditor::Document *> removing;
+  removing << documents[6] << documents[1] << documents[8] << documents[0] << documents[5] << documents[2];
+
+  QStringList removed;
+  connect(&m, &QAbstractItemModel::rowsAboutToBeRemoved, this, [&removed](const QModelIndex &parent, int first, int last) {
+    removed << QStringLiteral("%1:%2-%3").arg(parent.data().toString()).arg(first).arg(last);
+  });
+
+  m.slotAboutToDeleteDocuments(removing);
+  foreach (KTextEditor::Document *doc, removing) {
+    m.documentClosed(doc);
+  }
+
+  // nothing happens before all are closed
+  QVERIFY(removed.isEmpty());
+
+  m.slotDocumentsDeleted(QList<KTextEditor::Document *>());
+
+  // one removal per run, back to front, the empty b/ goes last
+  QCOMPARE(removed.size(), 4);
+  QVERIFY(removed.contains(QStringLiteral("b:0-0")));
+  QVERIFY(removed.indexOf(QStringLiteral("a:5-6")) >= 0);
+  QVERIFY(removed.indexOf(QStringLiteral("a:5-6")) < removed.indexOf(QStringLiteral("a:0-2")));
+  QCOMPARE(removed.last(), QStringLiteral("a:3-3"));
+
+  ResultNode root;
+  walkTree(m, QModelIndex(), root);
+
+  QCOMPARE(root, ResultNode()
+    << (ResultNode("a", true)
+      << ResultNode("foo3.txt")
+      << ResultNode("foo4.txt")
+      << ResultNode("foo7.txt")));
+
+  qDeleteAll(documents);
+}
+
 void FileTreeModelTest::rename_data()
 {
   QTest::addColumn<QList<DummyDocument *>>("documents");
@@ -911,5 +1005,127 @@ void FileTreeModelTest::rename()
   qDeleteAll(documents);
 }
 
+/**
+ * reference tree: directories are appended on first use, empty ones vanish
+ */
+static ResultNode *referenceDir(ResultNode &parent, const QString &name)
+{
+  for (int i = 0; i < parent.children.size(); i++) {
+    if (parent.children[i].dir && parent.children[i].name == name) {
+      return &parent.children[i];
+    }
+  }
+
+  parent << ResultNode(name, true);
+  return &parent.children.last();
+}
+
+static void referenceInsert(ResultNode &root, const QStringList &parts)
+{
+  ResultNode *dir = &root;
+  for (int i = 0; i < parts.size() - 1; i++) {
+    dir = referenceDir(*dir, parts[i]);
+  }
+  *dir << ResultNode(parts.last());
+}
+
+static bool referenceRemove(ResultNode &dir, const QStringList &parts, int level = 0)
+{
+  for (int i = 0; i < dir.children.size(); i++) {
+    ResultNode &child = dir.children[i];
+    if (child.name != parts[level] || child.dir == (level == parts.size() - 1)) {
+      continue;
+    }
+
+    if (level == parts.size() - 1 || (referenceRemove(child, parts, level + 1) && child.children.isEmpty())) {
+      dir.children.removeAt(i);
+    }
+    return true;
+  }
+  return false;
+}
+
+void FileTreeModelTest::stress()
+{
+  KateFileTreeModel m(this);
+  ResultNode expected;
+
+  /**
+   * two roots, one a prefix of the other: /stress must not swallow /stressed
+   */
+  QList<DummyDocument *> documents;
+  QList<QStringList> parts;
+  const QStringList roots = QStringList() << QStringLiteral("stress") << QStringLiteral("stressed");
+  foreach (const QString &root, roots) {
+    documents << new DummyDocument(QStringLiteral("file:///%1/top.txt").arg(root));
+    parts << (QStringList() << root << QStringLiteral("top.txt"));
+  }
+
+  /**
+   * 20k documents in a deterministic pseudo random order over a few levels
+   */
+  quint32 seed = 42;
+  for (int i = 0; i < 20000; i++) {
+    seed = seed * 1103515245 + 12345;
+    const QString root = roots[(seed >> 8) & 1];
+    const int dir = (seed >> 9) % 20;
+    const int subdir = (seed >> 16) % 10;
+
+    QStringList p = QStringList() << root << QStringLiteral("d%1").arg(dir);
+    if (root == roots[0]) {
+      p << QStringLiteral("s%1").arg(subdir);
+    }
+    p << QStringLiteral("f%1.txt").arg(i);
+
+    documents << new DummyDocument(QStringLiteral("file:///") + p.join(QLatin1Char('/')));
+    parts << p;
+  }
+
+  for (int i = 0; i < documents.size(); i++) {
+    m.documentOpened(documents[i]);
+    referenceInsert(expected, parts[i]);
+  }
+
+  ResultNode root;
+  walkTree(m, QModelIndex(), root);
+  QCOMPARE(root, expected);
+
+  /**
+   * close everything in /stress/d0 and one /stressed dir, the emptied dirs vanish from the indexes, too
+   */
+  for (int i = documents.size() - 1; i >= 0; i--) {
+    const QStringList &p = parts[i];
+    if (p.size() > 2 && ((p[0] == roots[0] && p[1] == QLatin1String("d0")) || (p[0] == roots[1] && p[1] == QLatin1String("d7")))) {
+      m.documentClosed(documents[i]);
+      QVERIFY(referenceRemove(expected, p));
+      delete documents.takeAt(i);
+      parts.removeAt(i);
+    }
+  }
+
+  root = ResultNode();
+  walkTree(m, QModelIndex(), root);
+  QCOMPARE(root, expected);
+
+  /**
+   * reopen there: the dirs are created again, at the end
+   */
+  const QStringList reopen[] = {
+    QStringList() << roots[0] << QStringLiteral("d0") << QStringLiteral("s3") << QStringLiteral("again.txt"),
+    QStringList() << roots[1] << QStringLiteral("d7") << QStringLiteral("again.txt")
+  };
+  for (const QStringList &p : reopen) {
+    documents << new DummyDocument(QStringLiteral("file:///") + p.join(QLatin1Char('/')));
+    m.documentOpened(documents.last());
+    referenceInsert(expected, p);
+  }
+
+  root = ResultNode();
+  walkTree(m, QModelIndex(), root);
+  QCOMPARE(root, expected);
+
+  qDeleteAll(documents);
+}
+
 
 // kate: space-indent on; indent-width 2; replace-tabs on;
@@ -52,10 +52,15 @@ class FileTreeModelTest : public QObject
     void deleteDocument();
     void deleteDocumentBatch_data();
     void deleteDocumentBatch();
+    void deleteDocumentBatchRows();
 
     void rename_data();
     void rename();
 
+    void stress();
+
+    void shading();
+
   private:
     void walkTree(KateFileTreeModel &model, const QModelIndex &i, ResultNode &node);
 };
@@ -146,7 +146,60 @@ KateFileTree::~KateFileTree()
 void KateFileTree::setModel(QAbstractItemModel *model)
 {
     Q_ASSERT(qobject_cast<KateFileTreeProxyModel *>(model)); // we don't really work with anything else
+
+    if (QAbstractItemModel *oldModel = QTreeView::model()) {
+        disconnect(oldModel, &QAbstractItemModel::modelAboutToBeReset, this, &KateFileTree::slotModelAboutToBeReset);
+        disconnect(oldModel, &QAbstractItemModel::modelReset, this, &KateFileTree::slotModelReset);
+    }
+
     QTreeView::setModel(model);
+
+    // connected after the view itself, the view has reset its expansion state once we restore it
+    connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &KateFileTree::slotModelAboutToBeReset);
+    connect(model, &QAbstractItemModel::modelReset, this, &KateFileTree::slotModelReset);
+}
+
+void KateFileTree::slotModelAboutToBeReset()
+{
+    m_expandedPaths.clear();
+
+    // only directories have children and can be expanded
+    QList<QModelIndex> worklist = { QModelIndex() };
+    while (!worklist.isEmpty()) {
+        const QModelIndex index = worklist.takeLast();
+        for (int i = 0; i < model()->rowCount(index); ++i) {
+            const QModelIndex child = model()->index(i, 0, index);
+            if (model()->hasChildren(child)) {
+                if (isExpanded(child)) {
+                    m_expandedPaths.insert(child.data(KateFileTreeModel::PathRole).toString());
+                }
+                worklist.append(child);
+            }
+        }
+    }
+}
+
+void KateFileTree::slotModelReset()
+{
+    if (m_expandedPaths.isEmpty()) {
+        return;
+    }
+
+    QList<QModelIndex> worklist = { QModelIndex() };
+    while (!worklist.isEmpty()) {
+        const QModelIndex index = worklist.takeLast();
+        for (int i = 0; i < model()->rowCount(index); ++i) {
+            const QModelIndex child = model()->index(i, 0, index);
+            if (model()->hasChildren(child)) {
+                if (m_expandedPaths.contains(child.data(KateFileTreeModel::PathRole).toString())) {
+                    expand(child);
+                }
+                worklist.append(child);
+            }
+        }
+    }
+
+    m_expandedPaths.clear();
 }
 
 QAction *KateFileTree::setupOption(
@@ -22,6 +22,7 @@
 
 #include <QUrl>
 #include <QIcon>
+#include <QSet>
 #include <QTreeView>
 
 namespace KTextEditor
@@ -86,6 +87,13 @@ private Q_SLOTS:
 
     void slotRenameFile();
 
+    /**
+     * A model reset, e.g. for a large batch of documents, collapses the view:
+     * remember the expanded directories before and expand them again after.
+     */
+    void slotModelAboutToBeReset();
+    void slotModelReset();
+
 private:
     QAction *setupOption(QActionGroup *group, const QIcon &, const QString &, const QString &, const char *slot, bool checked = false);
 
@@ -112,6 +120,11 @@ private:
 
     QPersistentModelIndex m_previouslySelected;
     QPersistentModelIndex m_indexContextMenu;
+
+    /**
+     * paths of the directories expanded before a model reset
+     */
+    QSet<QString> m_expandedPaths;
 };
 
 #endif // KATE_FILETREE_H
@@ -21,11 +21,13 @@
 
 #include <QDir>
 #include <QFileInfo>
+#include <QHash>
 #include <QList>
 #include <QMimeData>
 #include <QMimeDatabase>
 #include <QIcon>
 #include <QStack>
+#include <QVector>
 
 #include <KColorScheme>
 #include <KColorUtils>
@@ -38,13 +40,39 @@
 
 #include "katefiletreedebug.h"
 
+#include <algorithm>
+
+/**
+ * batches from this size on are inserted with one model reset, even into a filled tree
+ */
+static const int BatchResetThreshold = 500;
+
+/**
+ * Url of a document.
+ * Documents lazily restored from a session are not loaded yet, they carry the url they will load as property.
+ */
+static QUrl documentUrl(const KTextEditor::Document *doc)
+{
+    const QUrl pendingUrl = doc->property("pendingUrl").toUrl();
+    return pendingUrl.isEmpty() ? doc->url() : pendingUrl;
+}
+
+/**
+ * Name of a document, see documentUrl().
+ */
+static QString documentName(const KTextEditor::Document *doc)
+{
+    const QUrl pendingUrl = doc->property("pendingUrl").toUrl();
+    return pendingUrl.isEmpty() ? doc->documentName() : pendingUrl.fileName();
+}
+
 class ProxyItemDir;
 class ProxyItem
 {
     friend class KateFileTreeModel;
 
 public:
-    enum Flag { None = 0, Dir = 1, Modified = 2, ModifiedExternally = 4, DeletedExternally = 8, Empty = 16, ShowFullPath = 32, Host = 64 };
+    enum Flag { None = 0, Dir = 1, Modified = 2, ModifiedExternally = 4, DeletedExternally = 8, Empty = 16, ShowFullPath = 32, Host = 64, ModelRoot = 128 };
     Q_DECLARE_FLAGS(Flags, Flag)
 
     ProxyItem(const QString &n, ProxyItemDir *p = nullptr, Flags f = ProxyItem::None);
@@ -53,6 +81,13 @@ public:
     int addChild(ProxyItem *p);
     void remChild(ProxyItem *p);
 
+    /**
+     * Remove the children in the rows first to last, the items are not deleted.
+     * @param first first row to remove
+     * @param last last row to remove
+     */
+    void remChildren(int first, int last);
+
     ProxyItemDir *parent() const;
 
     ProxyItem *child(int idx) const;
@@ -75,6 +110,14 @@ public:
     const QList<ProxyItem *> &children() const;
     QList<ProxyItem *> &children();
 
+    /**
+     * Directory child by name, the first one if there are several.
+     * Children of the model root are looked up by full path, these are the roots of the tree.
+     * @param key name or full path
+     * @return directory or nullptr
+     */
+    ProxyItemDir *dirChild(const QString &key) const;
+
     void setDoc(KTextEditor::Document *doc);
     KTextEditor::Document *doc() const;
 
@@ -102,9 +145,19 @@ private:
     KTextEditor::Document *m_doc;
     QString m_host;
 
+    /**
+     * directory children by dirKey(), for dirChild()
+     */
+    QHash<QString, ProxyItem *> m_dirChildren;
+
 protected:
     void updateDisplay();
     void updateDocumentName();
+
+    /**
+     * key of a directory child in m_dirChildren
+     */
+    QString dirKey(const ProxyItem *item) const;
 };
 
 QDebug operator<<(QDebug dbg, ProxyItem *item)
@@ -125,11 +178,13 @@ QDebug operator<<(QDebug dbg, ProxyItem *item)
 class ProxyItemDir : public ProxyItem
 {
 public:
-    ProxyItemDir(const QString &n, ProxyItemDir *p = nullptr) : ProxyItem(n, p) {
-        setFlag(ProxyItem::Dir);
-        updateDisplay();
-
+    ProxyItemDir(const QString &n, ProxyItemDir *p = nullptr) : ProxyItem(n, nullptr, ProxyItem::Dir) {
         setIcon(QIcon::fromTheme(QStringLiteral("folder")));
+
+        // added after the dir flag is set, the parent indexes directories
+        if (p) {
+            p->addChild(this);
+        }
     }
 };
 
@@ -204,21 +259,73 @@ int ProxyItem::addChild(ProxyItem *item)
 
     item->updateDisplay();
 
+    // the first directory with that key stays the one found
+    if (item->flag(ProxyItem::Dir)) {
+        const QString key = dirKey(item);
+        if (!m_dirChildren.contains(key)) {
+            m_dirChildren.insert(key, item);
+        }
+    }
+
     return item_row;
 }
 
 void ProxyItem::remChild(ProxyItem *item)
 {
-    const int idx = m_children.indexOf(item);
-    Q_ASSERT(idx != -1);
+    Q_ASSERT(item->m_parent == this);
+    Q_ASSERT(m_children.value(item->m_row) == item);
 
-    m_children.removeAt(idx);
+    remChildren(item->m_row, item->m_row);
+}
+
+void ProxyItem::remChildren(int first, int last)
+{
+    Q_ASSERT(first >= 0 && first <= last && last < m_children.count());
 
-    for (int i = idx; i < m_children.count(); i++) {
+    QList<ProxyItem *> dirs;
+    for (int i = first; i <= last; ++i) {
+        ProxyItem *item = m_children.at(i);
+        item->m_parent = nullptr;
+        if (item->flag(ProxyItem::Dir)) {
+            dirs.append(item);
+        }
+    }
+
+    m_children.erase(m_children.begin() + first, m_children.begin() + last + 1);
+
+    for (int i = first; i < m_children.count(); i++) {
         m_children[i]->m_row = i;
     }
 
-    item->m_parent = nullptr;
+    // another directory with the same key takes over, rare
+    foreach(ProxyItem * item, dirs) {
+        const QString key = dirKey(item);
+        const auto it = m_dirChildren.find(key);
+        if (it != m_dirChildren.end() && it.value() == item) {
+            m_dirChildren.erase(it);
+            foreach(ProxyItem * child, m_children) {
+                if (child->flag(ProxyItem::Dir) && dirKey(child) == key) {
+                    m_dirChildren.insert(key, child);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+QString ProxyItem::dirKey(const ProxyItem *item) const
+{
+    if (flag(ProxyItem::ModelRoot)) {
+        return item->path();
+    }
+
+    // the display name of non top level directories
+    return item->path().mid(item->path().lastIndexOf(QLatin1Char('/')) + 1);
+}
+
+ProxyItemDir *ProxyItem::dirChild(const QString &key) const
+{
+    return static_cast<ProxyItemDir *>(m_dirChildren.value(key));
 }
 
 ProxyItemDir *ProxyItem::parent() const
@@ -351,7 +458,7 @@ const QString &ProxyItem::host() const
 
 void ProxyItem::updateDocumentName()
 {
-    const QString docName = m_doc ? m_doc->documentName() : QString();
+    const QString docName = m_doc ? ::documentName(m_doc) : QString();
 
     if (flag(ProxyItem::Host)) {
         m_documentName = QStringLiteral("[%1]%2").arg(m_host, docName);
@@ -366,6 +473,8 @@ KateFileTreeModel::KateFileTreeModel(QObject *p)
     : QAbstractItemModel(p)
     , m_root(new ProxyItemDir(QStringLiteral("m_root"), nullptr))
 {
+    m_root->setFlag(ProxyItem::ModelRoot);
+
     // setup default settings
     // session init will set these all soon
     const KColorScheme colors(QPalette::Active);
@@ -374,6 +483,9 @@ KateFileTreeModel::KateFileTreeModel(QObject *p)
     m_viewShade = KColorUtils::tint(bg, colors.foreground(KColorScheme::VisitedText).color(), 0.5);
     m_shadingEnabled = true;
     m_listMode = false;
+    m_batchInsert = false;
+    m_rampViewCount = 0;
+    m_rampEditCount = 0;
 
     initModel();
 }
@@ -391,6 +503,7 @@ bool KateFileTreeModel::shadingEnabled() const
 void KateFileTreeModel::setShadingEnabled(bool se)
 {
     if (m_shadingEnabled != se) {
+        m_brushRamp.clear();
         updateBackgrounds(true);
         m_shadingEnabled = se;
     }
@@ -404,6 +517,7 @@ const QColor &KateFileTreeModel::editShade() const
 void KateFileTreeModel::setEditShade(const QColor &es)
 {
     m_editShade = es;
+    m_brushRamp.clear();
 }
 
 const QColor &KateFileTreeModel::viewShade() const
@@ -414,6 +528,7 @@ const QColor &KateFileTreeModel::viewShade() const
 void KateFileTreeModel::setViewShade(const QColor &vs)
 {
     m_viewShade = vs;
+    m_brushRamp.clear();
 }
 
 bool KateFileTreeModel::showFullPathOnRoots(void) const
@@ -451,6 +566,10 @@ void KateFileTreeModel::clearModel()
 
     delete m_root;
     m_root = new ProxyItemDir(QStringLiteral("m_root"), nullptr);
+    m_root->setFlag(ProxyItem::ModelRoot);
+
+    // pending items were part of the tree
+    m_pendingRemovals.clear();
 
     m_docmap.clear();
     m_viewHistory.clear();
@@ -518,7 +637,7 @@ QVariant KateFileTreeModel::data(const QModelIndex &index, int role) const
     switch (role) {
     case KateFileTreeModel::PathRole:
         // allow to sort with hostname + path, bug 271488
-        return (item->doc() && !item->doc()->url().isEmpty()) ? item->doc()->url().toString() : item->path();
+        return (item->doc() && !documentUrl(item->doc()).isEmpty()) ? documentUrl(item->doc()).toString() : item->path();
 
     case KateFileTreeModel::DocumentRole:
         return QVariant::fromValue(item->doc());
@@ -559,8 +678,11 @@ QVariant KateFileTreeModel::data(const QModelIndex &index, int role) const
 
     case Qt::BackgroundRole:
         // TODO: do that funky shading the file list does...
-        if (m_shadingEnabled && m_brushes.contains(item)) {
-            return m_brushes[item];
+        if (m_shadingEnabled) {
+            const auto it = m_brushes.constFind(item);
+            if (it != m_brushes.constEnd()) {
+                return it.value();
+            }
         }
         break;
     }
@@ -725,13 +847,46 @@ void KateFileTreeModel::documentOpened(KTextEditor::Document *doc)
 
 void KateFileTreeModel::documentsOpened(const QList<KTextEditor::Document *> &docs)
 {
+    /**
+     * few documents for a filled tree: single inserts, a reset would rebuild the complete view,
+     * the view restores the expanded directories after a reset
+     */
+    if (m_root->childCount() > 0 && docs.size() < BatchResetThreshold) {
+        foreach(KTextEditor::Document * doc, docs) {
+            if (m_docmap.contains(doc)) {
+                documentNameChanged(doc);
+            } else {
+                documentOpened(doc);
+            }
+        }
+        return;
+    }
+
+    /**
+     * build the tree without any row signals, re-rooting and merging of roots included,
+     * the views fetch the final tree once after the reset
+     */
+    beginResetModel();
+    m_batchInsert = true;
+
+    bool renamed = false;
     foreach(KTextEditor::Document * doc, docs) {
         if (m_docmap.contains(doc)) {
-            documentNameChanged(doc);
+            handleNameChange(m_docmap[doc]);
+            renamed = true;
         } else {
             documentOpened(doc);
         }
     }
+
+    m_batchInsert = false;
+    endResetModel();
+
+    updateBackgrounds();
+
+    if (renamed) {
+        emit triggerViewChangeAfterNameChange();
+    }
 }
 
 void KateFileTreeModel::documentModifiedChanged(KTextEditor::Document *doc)
@@ -823,6 +978,15 @@ void KateFileTreeModel::documentEdited(const KTextEditor::Document *doc)
 
 void KateFileTreeModel::slotAboutToDeleteDocuments(const QList<KTextEditor::Document *> &docs)
 {
+    /**
+     * closing several documents: the rows are removed together once all are closed
+     */
+    if (docs.size() > 1) {
+        foreach(const KTextEditor::Document * doc, docs) {
+            m_closingDocuments.insert(doc);
+        }
+    }
+
     foreach(const KTextEditor::Document * doc, docs) {
         disconnect(doc, &KTextEditor::Document::documentNameChanged, this, &KateFileTreeModel::documentNameChanged);
         disconnect(doc, &KTextEditor::Document::documentUrlChanged, this, &KateFileTreeModel::documentNameChanged);
@@ -834,6 +998,9 @@ void KateFileTreeModel::slotAboutToDeleteDocuments(const QList<KTextEditor::Docu
 
 void KateFileTreeModel::slotDocumentsDeleted(const QList<KTextEditor::Document *> &docs)
 {
+    m_closingDocuments.clear();
+    removePendingItems();
+
     foreach(const KTextEditor::Document * doc, docs) {
         connectDocument(doc);
     }
@@ -848,13 +1015,50 @@ public:
     int view;
 };
 
+void KateFileTreeModel::updateBrushRamp(int hc, int ec, const QColor &base)
+{
+    m_brushRamp.clear();
+    m_brushRamp.reserve((hc + 1) * (ec + 1));
+
+    for (int view = 0; view <= hc; ++view) {
+        for (int edit = 0; edit <= ec; ++edit) {
+            QColor shade(m_viewShade);
+            QColor eshade(m_editShade);
+
+            if (edit > 0) {
+                int v = hc - view;
+                int e = ec - edit + 1;
+
+                e = e * e;
+
+                const int n = qMax(v + e, 1);
+
+                shade.setRgb(
+                    ((shade.red() * v) + (eshade.red() * e)) / n,
+                    ((shade.green() * v) + (eshade.green() * e)) / n,
+                    ((shade.blue() * v) + (eshade.blue() * e)) / n
+                );
+            }
+
+            // blend in the shade color; latest is most colored.
+            const double t = double(hc - view + 1) / double(hc);
+
+            m_brushRamp.append(QBrush(KColorUtils::mix(base, shade, t)));
+        }
+    }
+
+    m_rampViewCount = hc;
+    m_rampEditCount = ec;
+    m_rampBase = base;
+}
+
 void KateFileTreeModel::updateBackgrounds(bool force)
 {
     if (!m_shadingEnabled && !force) {
         return;
     }
 
-    QMap <ProxyItem *, EditViewCount> helper;
+    QHash<ProxyItem *, EditViewCount> helper;
     int i = 1;
 
     foreach(ProxyItem * item, m_viewHistory) {
@@ -868,49 +1072,71 @@ void KateFileTreeModel::updateBackgrounds(bool force)
         i++;
     }
 
-    QMap<ProxyItem *, QBrush> oldBrushes = m_brushes;
-    m_brushes.clear();
-
     const int hc = m_viewHistory.count();
     const int ec = m_editHistory.count();
 
-    for (QMap<ProxyItem *, EditViewCount>::iterator it = helper.begin(); it != helper.end(); ++it) {
-        QColor shade(m_viewShade);
-        QColor eshade(m_editShade);
-
-        if (it.value().edit > 0) {
-            int v = hc - it.value().view;
-            int e = ec - it.value().edit + 1;
-
-            e = e * e;
+    /**
+     * the brushes only depend on the ranks, the history sizes and the colors
+     */
+    const QColor base = QPalette().color(QPalette::Base);
+    if (m_brushRamp.isEmpty() || hc != m_rampViewCount || ec != m_rampEditCount || base != m_rampBase) {
+        updateBrushRamp(hc, ec, base);
+    }
 
-            const int n = qMax(v + e, 1);
+    QHash<ProxyItem *, QBrush> oldBrushes;
+    oldBrushes.swap(m_brushes);
 
-            shade.setRgb(
-                ((shade.red() * v) + (eshade.red() * e)) / n,
-                ((shade.green() * v) + (eshade.green() * e)) / n,
-                ((shade.blue() * v) + (eshade.blue() * e)) / n
-            );
+    for (auto it = helper.constBegin(), end = helper.constEnd(); it != end; ++it) {
+        ProxyItem *item = it.key();
+        const QBrush &brush = m_brushRamp.at(it.value().view * (ec + 1) + it.value().edit);
+        m_brushes.insert(item, brush);
+
+        // only items that got another rank need a repaint
+        const auto old = oldBrushes.find(item);
+        const bool changed = (old == oldBrushes.end()) || (old.value() != brush);
+        if (old != oldBrushes.end()) {
+            oldBrushes.erase(old);
         }
 
-        // blend in the shade color; latest is most colored.
-        const double t = double(hc - it.value().view + 1) / double(hc);
-
-        m_brushes[it.key()] = QBrush(KColorUtils::mix(QPalette().color(QPalette::Base), shade, t));
+        if (changed) {
+            const QModelIndex idx = createIndex(item->row(), 0, item);
+            emit dataChanged(idx, idx, QVector<int>(1, Qt::BackgroundRole));
+        }
     }
 
-    for (auto it = m_brushes.constBegin(), end = m_brushes.constEnd(); it != end; ++it) {
+    for (auto it = oldBrushes.constBegin(), end = oldBrushes.constEnd(); it != end; ++it) {
         ProxyItem *item = it.key();
-        oldBrushes.remove(item);
         const QModelIndex idx = createIndex(item->row(), 0, item);
-        dataChanged(idx, idx);
+        emit dataChanged(idx, idx, QVector<int>(1, Qt::BackgroundRole));
     }
+}
 
-    for (auto it = oldBrushes.constBegin(), end = oldBrushes.constEnd(); it != end; ++it) {
-        ProxyItem *item = it.key();
-        const QModelIndex idx = createIndex(item->row(), 0, item);
-        dataChanged(idx, idx);
+void KateFileTreeModel::addChildItem(ProxyItemDir *parent, ProxyItem *item)
+{
+    if (m_batchInsert) {
+        parent->addChild(item);
+        return;
     }
+
+    const QModelIndex parent_index = (parent == m_root) ? QModelIndex() : createIndex(parent->row(), 0, parent);
+    beginInsertRows(parent_index, parent->childCount(), parent->childCount());
+    parent->addChild(item);
+    endInsertRows();
+}
+
+void KateFileTreeModel::removeChildItem(ProxyItem *item)
+{
+    ProxyItemDir *parent = item->parent();
+
+    if (m_batchInsert) {
+        parent->remChild(item);
+        return;
+    }
+
+    const QModelIndex parent_index = (parent == m_root) ? QModelIndex() : createIndex(parent->row(), 0, parent);
+    beginRemoveRows(parent_index, item->row(), item->row());
+    parent->remChild(item);
+    endRemoveRows();
 }
 
 void KateFileTreeModel::handleEmptyParents(ProxyItemDir *item)
@@ -925,10 +1151,7 @@ void KateFileTreeModel::handleEmptyParents(ProxyItemDir *item)
 
     while (parent) {
         if (!item->childCount()) {
-            const QModelIndex parent_index = (parent == m_root) ? QModelIndex() : createIndex(parent->row(), 0, parent);
-            beginRemoveRows(parent_index, item->row(), item->row());
-            parent->remChild(item);
-            endRemoveRows();
+            removeChildItem(item);
             delete item;
         } else {
             // breakout early, if this node isn't empty, theres no use in checking its parents
@@ -942,37 +1165,88 @@ void KateFileTreeModel::handleEmptyParents(ProxyItemDir *item)
 
 void KateFileTreeModel::documentClosed(KTextEditor::Document *doc)
 {
-    if (!m_docmap.contains(doc)) {
+    ProxyItem *node = m_docmap.take(doc);
+    if (!node) {
         return;
     }
 
     if (m_shadingEnabled) {
-        ProxyItem *toRemove = m_docmap[doc];
-        if (m_brushes.contains(toRemove)) {
-            m_brushes.remove(toRemove);
-        }
-
-        if (m_viewHistory.contains(toRemove)) {
-            m_viewHistory.removeAll(toRemove);
-        }
+        m_brushes.remove(node);
+        m_viewHistory.removeAll(node);
+        m_editHistory.removeAll(node);
+    }
 
-        if (m_editHistory.contains(toRemove)) {
-            m_editHistory.removeAll(toRemove);
-        }
+    /**
+     * part of a batch: the document is gone soon, the row stays until slotDocumentsDeleted()
+     */
+    if (m_closingDocuments.contains(doc)) {
+        node->m_doc = nullptr;
+        m_pendingRemovals.append(node);
+        return;
     }
 
-    ProxyItem *node = m_docmap[doc];
     ProxyItemDir *parent = node->parent();
 
-    const QModelIndex parent_index = (parent == m_root) ? QModelIndex() : createIndex(parent->row(), 0, parent);
-    beginRemoveRows(parent_index, node->row(), node->row());
-    node->parent()->remChild(node);
-    endRemoveRows();
+    removeChildItem(node);
 
     delete node;
     handleEmptyParents(parent);
+}
 
-    m_docmap.remove(doc);
+void KateFileTreeModel::removePendingItems()
+{
+    if (m_pendingRemovals.isEmpty()) {
+        return;
+    }
+
+    // rows to remove per parent, the tree might have changed since the items got closed
+    QHash<ProxyItemDir *, QVector<int>> rows;
+    foreach(ProxyItem * item, m_pendingRemovals) {
+        rows[item->parent()].append(item->row());
+    }
+
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+        ProxyItemDir *parent = it.key();
+        QVector<int> &parentRows = it.value();
+        std::sort(parentRows.begin(), parentRows.end());
+
+        // one removal per contiguous run, back to front, rows in front stay valid
+        const QModelIndex parent_index = (parent == m_root) ? QModelIndex() : createIndex(parent->row(), 0, parent);
+        int last = parentRows.size() - 1;
+        while (last >= 0) {
+            int first = last;
+            while (first > 0 && parentRows[first - 1] == parentRows[first] - 1) {
+                --first;
+            }
+
+            beginRemoveRows(parent_index, parentRows[first], parentRows[last]);
+            parent->remChildren(parentRows[first], parentRows[last]);
+            endRemoveRows();
+
+            last = first - 1;
+        }
+    }
+
+    qDeleteAll(m_pendingRemovals);
+    m_pendingRemovals.clear();
+
+    /**
+     * drop the directories that got empty, outer ones first:
+     * an inner one might take its empty parents with it, an outer one is still filled by the inner one
+     */
+    QList<QPair<int, ProxyItemDir *>> parents;
+    for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+        int depth = 0;
+        for (ProxyItemDir *dir = it.key(); dir; dir = dir->parent()) {
+            ++depth;
+        }
+        parents.append(qMakePair(depth, it.key()));
+    }
+    std::sort(parents.begin(), parents.end());
+
+    for (int i = 0; i < parents.size(); ++i) {
+        handleEmptyParents(parents[i].second);
+    }
 }
 
 void KateFileTreeModel::documentNameChanged(KTextEditor::Document *doc)
@@ -1010,26 +1284,21 @@ void KateFileTreeModel::documentNameChanged(KTextEditor::Document *doc)
     emit triggerViewChangeAfterNameChange(); // FIXME: heh, non-standard signal?
 }
 
-ProxyItemDir *KateFileTreeModel::findRootNode(const QString &name, const int r) const
+ProxyItemDir *KateFileTreeModel::findRootNode(const QString &name) const
 {
-    foreach(ProxyItem * item, m_root->children()) {
-        if (!item->flag(ProxyItem::Dir)) {
-            continue;
-        }
-
-        // make sure we're actually matching against the right dir,
-        // previously the check below would match /foo/xy against /foo/x
-        // and return /foo/x rather than /foo/xy
-        // this seems a bit hackish, but is the simplest way to solve the
-        // current issue.
-        QString path = item->path().section(QLatin1Char('/'), 0, -r) + QLatin1Char('/');
-
-        if (name.startsWith(path)) {
-            return static_cast<ProxyItemDir *>(item);
+    // make sure we're actually matching against the right dir:
+    // a root matches if its path followed by a slash starts the name,
+    // /foo/x must not match /foo/xy
+    // every directory prefix of the name is looked up, the first root in row order wins
+    ProxyItemDir *found = nullptr;
+    for (int i = name.indexOf(QLatin1Char('/')); i >= 0; i = name.indexOf(QLatin1Char('/'), i + 1)) {
+        ProxyItemDir *root = m_root->dirChild(name.left(i));
+        if (root && (!found || root->row() < found->row())) {
+            found = root;
         }
     }
 
-    return nullptr;
+    return found;
 }
 
 ProxyItemDir *KateFileTreeModel::findChildNode(const ProxyItemDir *parent, const QString &name) const
@@ -1037,21 +1306,7 @@ ProxyItemDir *KateFileTreeModel::findChildNode(const ProxyItemDir *parent, const
     Q_ASSERT(parent != nullptr);
     Q_ASSERT(!name.isEmpty());
 
-    if (!parent->childCount()) {
-        return nullptr;
-    }
-
-    foreach(ProxyItem * item, parent->children()) {
-        if (!item->flag(ProxyItem::Dir)) {
-            continue;
-        }
-
-        if (item->display() == name) {
-            return static_cast<ProxyItemDir *>(item);
-        }
-    }
-
-    return nullptr;
+    return parent->dirChild(name);
 }
 
 void KateFileTreeModel::insertItemInto(ProxyItemDir *root, ProxyItem *item)
@@ -1075,20 +1330,15 @@ void KateFileTreeModel::insertItemInto(ProxyItemDir *root, ProxyItem *item)
         current_parts.append(part);
         ProxyItemDir *find = findChildNode(ptr, part);
         if (!find) {
-            const QString new_name = current_parts.join(QLatin1String("/"));
-            const QModelIndex parent_index = (ptr == m_root) ? QModelIndex() : createIndex(ptr->row(), 0, ptr);
-            beginInsertRows(parent_index, ptr->childCount(), ptr->childCount());
-            ptr = new ProxyItemDir(new_name, ptr);
-            endInsertRows();
+            ProxyItemDir *dir = new ProxyItemDir(current_parts.join(QLatin1String("/")));
+            addChildItem(ptr, dir);
+            ptr = dir;
         } else {
             ptr = find;
         }
     }
 
-    const QModelIndex parent_index = (ptr == m_root) ? QModelIndex() : createIndex(ptr->row(), 0, ptr);
-    beginInsertRows(parent_index, ptr->childCount(), ptr->childCount());
-    ptr->addChild(item);
-    endInsertRows();
+    addChildItem(ptr, item);
 }
 
 void KateFileTreeModel::handleInsert(ProxyItem *item)
@@ -1096,9 +1346,7 @@ void KateFileTreeModel::handleInsert(ProxyItem *item)
     Q_ASSERT(item != nullptr);
 
     if (m_listMode || item->flag(ProxyItem::Empty)) {
-        beginInsertRows(QModelIndex(), m_root->childCount(), m_root->childCount());
-        m_root->addChild(item);
-        endInsertRows();
+        addChildItem(m_root, item);
         return;
     }
 
@@ -1117,9 +1365,7 @@ void KateFileTreeModel::handleInsert(ProxyItem *item)
     new_root->setHost(item->host());
 
     // add new root to m_root
-    beginInsertRows(QModelIndex(), m_root->childCount(), m_root->childCount());
-    m_root->addChild(new_root);
-    endInsertRows();
+    addChildItem(m_root, new_root);
 
     // same fix as in findRootNode, try to match a full dir, instead of a partial path
     base += QLatin1Char('/');
@@ -1131,9 +1377,7 @@ void KateFileTreeModel::handleInsert(ProxyItem *item)
         }
 
         if (root->path().startsWith(base)) {
-            beginRemoveRows(QModelIndex(), root->row(), root->row());
-            m_root->remChild(root);
-            endRemoveRows();
+            removeChildItem(root);
 
             //beginInsertRows(new_root_index, new_root->childCount(), new_root->childCount());
             // this can't use new_root->addChild directly, or it'll potentially miss a bunch of subdirs
@@ -1144,10 +1388,7 @@ void KateFileTreeModel::handleInsert(ProxyItem *item)
 
     // add item to new root
     // have to call begin/endInsertRows here, or the new item won't show up.
-    const QModelIndex new_root_index = createIndex(new_root->row(), 0, new_root);
-    beginInsertRows(new_root_index, new_root->childCount(), new_root->childCount());
-    new_root->addChild(item);
-    endInsertRows();
+    addChildItem(new_root, item);
 
     handleDuplicitRootDisplay(new_root);
 }
@@ -1176,14 +1417,10 @@ void KateFileTreeModel::handleDuplicitRootDisplay(ProxyItemDir *init)
 
                 const QString rdir = root->path().section(QLatin1Char('/'), 0, -2);
                 if (!rdir.isEmpty()) {
-                    beginRemoveRows(QModelIndex(), root->row(), root->row());
-                    m_root->remChild(root);
-                    endRemoveRows();
+                    removeChildItem(root);
 
                     ProxyItemDir *irdir = new ProxyItemDir(rdir);
-                    beginInsertRows(QModelIndex(), m_root->childCount(), m_root->childCount());
-                    m_root->addChild(irdir);
-                    endInsertRows();
+                    addChildItem(m_root, irdir);
 
                     insertItemInto(irdir, root);
 
@@ -1194,11 +1431,9 @@ void KateFileTreeModel::handleDuplicitRootDisplay(ProxyItemDir *init)
 
                         const QString xy = rdir + QLatin1Char('/');
                         if (node->path().startsWith(xy)) {
-                            beginRemoveRows(QModelIndex(), node->row(), node->row());
                             // check_root_removed must be sticky
                             check_root_removed = check_root_removed || (node == check_root);
-                            m_root->remChild(node);
-                            endRemoveRows();
+                            removeChildItem(node);
                             insertItemInto(irdir, node);
                         }
                     }
@@ -1210,14 +1445,10 @@ void KateFileTreeModel::handleDuplicitRootDisplay(ProxyItemDir *init)
                 if (!check_root_removed) {
                     const QString nrdir = check_root->path().section(QLatin1Char('/'), 0, -2);
                     if (!nrdir.isEmpty()) {
-                        beginRemoveRows(QModelIndex(), check_root->row(), check_root->row());
-                        m_root->remChild(check_root);
-                        endRemoveRows();
+                        removeChildItem(check_root);
 
                         ProxyItemDir *irdir = new ProxyItemDir(nrdir);
-                        beginInsertRows(QModelIndex(), m_root->childCount(), m_root->childCount());
-                        m_root->addChild(irdir);
-                        endInsertRows();
+                        addChildItem(m_root, irdir);
 
                         insertItemInto(irdir, check_root);
 
@@ -1244,19 +1475,18 @@ void KateFileTreeModel::handleNameChange(ProxyItem *item)
     updateItemPathAndHost(item);
 
     if (m_listMode) {
-        const QModelIndex idx = createIndex(item->row(), 0, item);
         setupIcon(item);
-        emit dataChanged(idx, idx);
+        if (!m_batchInsert) {
+            const QModelIndex idx = createIndex(item->row(), 0, item);
+            emit dataChanged(idx, idx);
+        }
         return;
     }
 
     // in either case (new/change) we want to remove the item from its parent
     ProxyItemDir *parent = item->parent();
 
-    const QModelIndex parent_index = (parent == m_root) ? QModelIndex() : createIndex(parent->row(), 0, parent);
-    beginRemoveRows(parent_index, item->row(), item->row());
-    parent->remChild(item);
-    endRemoveRows();
+    removeChildItem(item);
 
     handleEmptyParents(parent);
 
@@ -1276,14 +1506,15 @@ void KateFileTreeModel::updateItemPathAndHost(ProxyItem *item) const
     const KTextEditor::Document *doc = item->doc();
     Q_ASSERT(doc); // this method should not be called at directory items
 
-    QString path = doc->url().path();
+    const QUrl url = documentUrl(doc);
+    QString path = url.path();
     QString host;
-    if (doc->url().isEmpty()) {
+    if (url.isEmpty()) {
         path = doc->documentName();
         item->setFlag(ProxyItem::Empty);
     } else {
         item->clearFlag(ProxyItem::Empty);
-        host = doc->url().host();
+        host = url.host();
         if (!host.isEmpty()) {
             path = QStringLiteral("[%1]%2").arg(host, path);
         }
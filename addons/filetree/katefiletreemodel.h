@@ -21,7 +21,11 @@
 #define KATEFILETREEMODEL_H
 
 #include <QAbstractItemModel>
+#include <QBrush>
 #include <QColor>
+#include <QHash>
+#include <QSet>
+#include <QVector>
 
 #include <ktexteditor/modificationinterface.h>
 namespace KTextEditor
@@ -97,18 +101,34 @@ Q_SIGNALS:
     void triggerViewChangeAfterNameChange();
 
 private:
-    ProxyItemDir *findRootNode(const QString &name, const int r = 1) const;
+    ProxyItemDir *findRootNode(const QString &name) const;
     ProxyItemDir *findChildNode(const ProxyItemDir *parent, const QString &name) const;
     void insertItemInto(ProxyItemDir *root, ProxyItem *item);
     void handleInsert(ProxyItem *item);
     void handleNameChange(ProxyItem *item);
     void handleEmptyParents(ProxyItemDir *item);
+
+    /**
+     * remove the items of documents closed as a batch, see slotAboutToDeleteDocuments()
+     */
+    void removePendingItems();
     void setupIcon(ProxyItem *item) const;
     void updateItemPathAndHost(ProxyItem *item) const;
     void handleDuplicitRootDisplay(ProxyItemDir *item);
 
+    /**
+     * add/remove a child with the matching row signals, none during a batch insert
+     */
+    void addChildItem(ProxyItemDir *parent, ProxyItem *item);
+    void removeChildItem(ProxyItem *item);
+
     void updateBackgrounds(bool force = false);
 
+    /**
+     * compute the brushes for all view/edit ranks of the given history sizes
+     */
+    void updateBrushRamp(int hc, int ec, const QColor &base);
+
     void initModel();
     void clearModel();
     void connectDocument(const KTextEditor::Document *);
@@ -121,12 +141,33 @@ private:
 
     QList<ProxyItem *> m_viewHistory;
     QList<ProxyItem *> m_editHistory;
-    QMap<ProxyItem *, QBrush> m_brushes;
+    QHash<ProxyItem *, QBrush> m_brushes;
+
+    /**
+     * brush per view and edit rank, view * (edit history size + 1) + edit,
+     * cleared if the colors change
+     */
+    QVector<QBrush> m_brushRamp;
+    int m_rampViewCount;
+    int m_rampEditCount;
+    QColor m_rampBase;
 
     QColor m_editShade;
     QColor m_viewShade;
 
     bool m_listMode;
+
+    /**
+     * documentsOpened() rebuilds inside a model reset, no row signals
+     */
+    bool m_batchInsert;
+
+    /**
+     * documents announced by slotAboutToDeleteDocuments(),
+     * their items are collected in m_pendingRemovals once closed
+     */
+    QSet<const KTextEditor::Document *> m_closingDocuments;
+    QList<ProxyItem *> m_pendingRemovals;
 };
 
 #endif /* KATEFILETREEMODEL_H */
@@ -315,11 +315,11 @@ void KateCTagsView::gotoTagForTypes(const QString &word, const QStringList &type
 
     if (list.count() == 1) {
         Tags::TagEntry tag = list.first();
-        jumpToTag(tag.file, tag.pattern, word);
+        jumpToTag(tag.file, tag.pattern, word, tag.line);
     }
     else {
         Tags::TagEntry tag = list.first();
-        jumpToTag(tag.file, tag.pattern, word);
+        jumpToTag(tag.file, tag.pattern, word, tag.line);
         m_ctagsUi.tabWidget->setCurrentIndex(0);
         m_mWin->showToolView(m_toolView);
     }
@@ -349,6 +349,7 @@ void KateCTagsView::displayHits(const Tags::TagList &list)
         item->setText(1, list[i].type);
         item->setText(2, list[i].file);
         item->setData(0, Qt::UserRole, list[i].pattern);
+        item->setData(1, Qt::UserRole, list[i].line);
 
         QString pattern = list[i].pattern;
         pattern.replace( QStringLiteral("\\/"), QStringLiteral("/"));
@@ -369,8 +370,9 @@ void KateCTagsView::tagHitClicked(QTreeWidgetItem *item)
     const QString file = item->data(2, Qt::DisplayRole).toString();
     const QString pattern = item->data(0, Qt::UserRole).toString();
     const QString word = item->data(0, Qt::DisplayRole).toString();
+    const int line = item->data(1, Qt::UserRole).toInt();
 
-    jumpToTag(file, pattern, word);
+    jumpToTag(file, pattern, word, line);
 }
 
 /******************************************************************/
@@ -431,11 +433,20 @@ QString KateCTagsView::currentWord( )
 }
 
 /******************************************************************/
-void KateCTagsView::jumpToTag(const QString &file, const QString &pattern, const QString &word)
+static bool lineMatchesTag(const QString &linestr, const QString &text, bool anchoredEnd)
+{
+    // plain literal compares, QString uses vectorized code paths for these
+    if (anchoredEnd) {
+        return linestr == text;
+    }
+    return linestr.startsWith(text);
+}
+
+/******************************************************************/
+void KateCTagsView::jumpToTag(const QString &file, const QString &pattern, const QString &word, int line)
 {
     if (pattern.isEmpty()) return;
 
-    // generate a regexp from the pattern
     // ctags interestingly escapes "/", but apparently nothing else. lets revert that
     QString unescaped = pattern;
     unescaped.replace( QStringLiteral("\\/"), QStringLiteral("/") );
@@ -444,24 +455,20 @@ void KateCTagsView::jumpToTag(const QString &file, const QString &pattern, const
     // but this isn't true for some macro definitions
     // where the form is only /^foo/
     // I have no idea if this is a ctags bug or not, but we have to deal with it
+    // the pattern is always anchored at the line start, so a literal compare is enough
 
     QString reduced;
-    QString escaped;
-    QString re_string;
+    bool anchoredEnd;
 
     if (unescaped.endsWith(QStringLiteral("$/"))) {
         reduced = unescaped.mid(2, unescaped.length() - 4);
-        escaped = QRegularExpression::escape(reduced);
-        re_string = QStringLiteral("^%1$").arg(escaped);
+        anchoredEnd = true;
     }
     else {
         reduced = unescaped.mid( 2, unescaped.length() -3 );
-        escaped = QRegularExpression::escape(reduced);
-        re_string = QStringLiteral("^%1").arg(escaped);
+        anchoredEnd = false;
     }
 
-    QRegularExpression re(re_string);
-
     // save current location
     TagJump from;
     from.url    = m_mWin->activeView()->document()->url();
@@ -478,19 +485,47 @@ void KateCTagsView::jumpToTag(const QString &file, const QString &pattern, const
         return;
     }
 
-    // look for the line
+    KTextEditor::Document *doc = m_mWin->activeView()->document();
+    const int lines = doc->lines();
+
+    // look for the line, first around the line number ctags recorded (--fields=+n)
+    // to cope with small edits since the index was generated, nearest candidate first
+    static const int searchWindow = 32;
     QString linestr;
-    int line;
-    for (line =0; line < m_mWin->activeView()->document()->lines(); line++) {
-        linestr = m_mWin->activeView()->document()->line(line);
-        if (linestr.indexOf(re) > -1) break;
+    int found = -1;
+    if (line > 0) {
+        const int expected = line - 1;
+        for (int offset = 0; offset <= searchWindow && found < 0; ++offset) {
+            if (expected - offset >= 0 && expected - offset < lines) {
+                linestr = doc->line(expected - offset);
+                if (lineMatchesTag(linestr, reduced, anchoredEnd)) {
+                    found = expected - offset;
+                    break;
+                }
+            }
+            if (offset > 0 && expected + offset < lines) {
+                linestr = doc->line(expected + offset);
+                if (lineMatchesTag(linestr, reduced, anchoredEnd)) {
+                    found = expected + offset;
+                    break;
+                }
+            }
+        }
+    }
+
+    // no line number or the line moved too far: scan the whole document
+    for (int l = 0; found < 0 && l < lines; l++) {
+        linestr = doc->line(l);
+        if (lineMatchesTag(linestr, reduced, anchoredEnd)) {
+            found = l;
+        }
     }
 
     // activate the line
-    if (line != m_mWin->activeView()->document()->lines()) {
+    if (found >= 0) {
         // line found now look for the column
         int column = linestr.indexOf(word) + (word.length()/2);
-        m_mWin->activeView()->setCursorPosition(KTextEditor::Cursor(line, column));
+        m_mWin->activeView()->setCursorPosition(KTextEditor::Cursor(found, column));
     }
     m_mWin->activeView()->setFocus();
 
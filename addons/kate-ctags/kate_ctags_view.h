@@ -41,7 +41,7 @@
 
 #include "ui_kate_ctags.h"
 
-const static QString DEFAULT_CTAGS_CMD = QStringLiteral("ctags -R --c++-types=+px --extra=+q --excmd=pattern --exclude=Makefile --exclude=.");
+const static QString DEFAULT_CTAGS_CMD = QStringLiteral("ctags -R --c++-types=+px --extra=+q --fields=+n --excmd=pattern --exclude=Makefile --exclude=.");
 
 typedef struct
 {
@@ -95,7 +95,7 @@ private:
     void displayHits(const Tags::TagList &list);
     
     void gotoTagForTypes(const QString &tag, QStringList const &types);
-    void jumpToTag(const QString &file, const QString &pattern, const QString &word);
+    void jumpToTag(const QString &file, const QString &pattern, const QString &word, int line = 0);
     
 
     QPointer<KTextEditor::MainWindow> m_mWin;
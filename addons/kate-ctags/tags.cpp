@@ -20,10 +20,10 @@ namespace ctags
 
 QString Tags::_tagsfile;
 
-Tags::TagEntry::TagEntry() {}
+Tags::TagEntry::TagEntry() : line(0) {}
 
-Tags::TagEntry::TagEntry( const QString & tag, const QString & type, const QString & file, const QString & pattern )
-	: tag(tag), type(type), file(file), pattern(pattern)
+Tags::TagEntry::TagEntry( const QString & tag, const QString & type, const QString & file, const QString & pattern, int line )
+	: tag(tag), type(type), file(file), pattern(pattern), line(line)
 {}
 
 
@@ -103,7 +103,7 @@ Tags::TagList Tags::getMatches( const QString & tagpart, bool partial, const QSt
 			}
 			if ( types.isEmpty() || types.contains( QString::fromLocal8Bit(entry.kind) ) )
 			{
-				list << TagEntry( QString::fromLocal8Bit( entry.name ), type, file, QString::fromLocal8Bit( entry.address.pattern ) );
+				list << TagEntry( QString::fromLocal8Bit( entry.name ), type, file, QString::fromLocal8Bit( entry.address.pattern ), int( entry.address.lineNumber ) );
 			}
 		}
 		while ( ctags::tagsFindNext( file, &entry ) == ctags::TagSuccess );
@@ -23,12 +23,13 @@ public:
 	struct TagEntry
 	{
 		TagEntry();
-		TagEntry( const QString & tag, const QString & type, const QString & file, const QString & pattern );
+		TagEntry( const QString & tag, const QString & type, const QString & file, const QString & pattern, int line = 0 );
 
 		QString tag;
 		QString type;
 		QString file;
 		QString pattern;
+		int line; // 1-based line from the ctags "line:" field, 0 if not available
 	};
 
 	typedef QList<TagEntry> TagList;
@@ -21,6 +21,9 @@
 #include "test1.h"
 #include "fileutil.h"
 #include "tools/kateprojectcodeanalysistoolshellcheck.h"
+#include "kateprojectsymboltrie.h"
+#include "kateprojectindex.h"
+#include "kateprojectwordindex.h"
 
 #include <QtTest>
 
@@ -52,4 +55,133 @@ void Test1::testShellCheckParsing()
     QCOMPARE(outList.size(), 4);
 }
 
+void Test1::testSymbolTrie()
+{
+    KateProjectSymbolTrie trie;
+    QVERIFY(trie.isEmpty());
+
+    const QString a = QStringLiteral("/src/a.cpp");
+    const QString b = QStringLiteral("/src/b.cpp");
+    const QString c = QStringLiteral("/other/c.cpp");
+
+    // edge splitting and symbols on inner nodes
+    trie.insert(QStringLiteral("testFunction"), c);
+    trie.insert(QStringLiteral("testFunction"), c);
+    trie.insert(QStringLiteral("testFunction"), c);
+    trie.insert(QStringLiteral("testFoo"), b);
+    trie.insert(QStringLiteral("test"), c);
+    trie.insert(QStringLiteral("tester"), c);
+    trie.insert(QStringLiteral("tester"), c);
+    trie.insert(QStringLiteral("other"), a);
+    QCOMPARE(trie.symbolCount(), 5);
+
+    // ranking by count without file context
+    QCOMPARE(trie.complete(QStringLiteral("test"), 10), QStringList({QStringLiteral("testFunction"), QStringLiteral("tester"), QStringLiteral("test"), QStringLiteral("testFoo")}));
+    QCOMPARE(trie.complete(QStringLiteral("testF"), 10), QStringList({QStringLiteral("testFunction"), QStringLiteral("testFoo")}));
+    QCOMPARE(trie.complete(QStringLiteral("testFu"), 10), QStringList({QStringLiteral("testFunction")}));
+    QCOMPARE(trie.complete(QStringLiteral("testX"), 10), QStringList());
+    QCOMPARE(trie.complete(QStringLiteral("testFunctionX"), 10), QStringList());
+
+    // result cap
+    QCOMPARE(trie.complete(QStringLiteral("t"), 2), QStringList({QStringLiteral("testFunction"), QStringLiteral("tester")}));
+
+    // proximity: current file first, then same directory
+    QCOMPARE(trie.complete(QStringLiteral("test"), 1, b), QStringList({QStringLiteral("testFoo")}));
+    QCOMPARE(trie.complete(QStringLiteral("test"), 2, a), QStringList({QStringLiteral("testFoo"), QStringLiteral("testFunction")}));
+}
+
+void Test1::testIndexLookup()
+{
+    KateProjectIndex index;
+    index.loadTags(QByteArrayLiteral(
+        "parse\t/src/other/parser.cpp\t10;\"\tf\n"
+        "parse\t/src/lib/parser.cpp\t20;\"\tf\n"
+        "parse\t/src/lib/parser.h\t5;\"\tp\n"
+        "parseHeader\t/src/lib/parser.cpp\t30;\"\tf\n"
+        "parseBody\t/src/lib/parser.cpp\t40;\"\tf\n"
+        "reparse\t/src/lib/parser.cpp\t50;\"\tf\n"
+        "unparsed\t/src/lib/parser.cpp\t60;\"\tf\n"
+        "print\t/src/lib/parser.cpp\t70;\"\tf\n"));
+    QVERIFY(index.isValid());
+    QVERIFY(!index.isLoading());
+
+    auto names = [](const QVector<KateProjectIndex::Location> &locations) {
+        QStringList result;
+        for (const auto &location : locations) {
+            result << location.name + QLatin1Char(':') + QString::number(location.line);
+        }
+        return result;
+    };
+
+    // exact matches first, nearest file first, then prefix matches sorted by name
+    const QString current = QStringLiteral("/src/lib/parser.h");
+    const QStringList parseDefinitions({QStringLiteral("parse:20"), QStringLiteral("parse:10"),
+                                        QStringLiteral("parseBody:40"), QStringLiteral("parseHeader:30")});
+    QCOMPARE(names(index.lookup(QStringLiteral("parse"), current, KateProjectIndex::Definitions)), parseDefinitions);
+
+    // substring matches only if nothing else is known
+    QCOMPARE(names(index.lookup(QStringLiteral("parse"), current, KateProjectIndex::Definitions, 100, true)), parseDefinitions);
+
+    // declarations are only dropped for definitions
+    QCOMPARE(index.lookup(QStringLiteral("parse"), current, KateProjectIndex::AllLocations, 3).size(), 3);
+    QCOMPARE(names(index.lookup(QStringLiteral("parse"), current, KateProjectIndex::AllLocations, 1)), QStringList({QStringLiteral("parse:5")}));
+
+    // result limit, the limit cuts inside the tiers
+    QCOMPARE(names(index.lookup(QStringLiteral("parse"), current, KateProjectIndex::Definitions, 3)),
+             QStringList({QStringLiteral("parse:20"), QStringLiteral("parse:10"), QStringLiteral("parseBody:40")}));
+    QCOMPARE(index.lookup(QStringLiteral("parse"), current, KateProjectIndex::Definitions, 0).size(), 0);
+
+    // without exact match only the similar symbols
+    QCOMPARE(names(index.lookup(QStringLiteral("parseH"), current, KateProjectIndex::Definitions)), QStringList({QStringLiteral("parseHeader:30")}));
+
+    // substring matches, inside a tier proximity wins over the name
+    QVERIFY(index.lookup(QStringLiteral("arse"), current, KateProjectIndex::Definitions).isEmpty());
+    QCOMPARE(names(index.lookup(QStringLiteral("arse"), current, KateProjectIndex::Definitions, 100, true)),
+             QStringList({QStringLiteral("parse:20"), QStringLiteral("parseBody:40"),
+                          QStringLiteral("parseHeader:30"), QStringLiteral("reparse:50"),
+                          QStringLiteral("unparsed:60"), QStringLiteral("parse:10")}));
+
+    // the substring scan stops after enough symbols
+    QCOMPARE(index.lookup(QStringLiteral("arse"), current, KateProjectIndex::Definitions, 2, true).size(), 2);
+    QVERIFY(index.lookup(QStringLiteral("missing"), current, KateProjectIndex::Definitions).isEmpty());
+}
+
+void Test1::testWordIndex()
+{
+    KateProjectWordIndex index;
+    QObject doc1;
+    QObject doc2;
+
+    // initial content, too short words and numbers are ignored
+    index.queueReset(&doc1, QStringLiteral("int fooBar = fooBaz + 42;\nreturn fooBar;"));
+    index.queueReset(&doc2, QStringLiteral("fooBar fooQux"));
+    index.processPending();
+    QCOMPARE(index.count(QStringLiteral("fooBar")), 3);
+    QCOMPARE(index.count(QStringLiteral("int")), 1);
+    QCOMPARE(index.count(QStringLiteral("42")), 0);
+    QCOMPARE(index.matches(QStringLiteral("foo"), 10), QStringList({QStringLiteral("fooBar"), QStringLiteral("fooBaz"), QStringLiteral("fooQux")}));
+    QCOMPARE(index.matches(QStringLiteral("foo"), 1), QStringList({QStringLiteral("fooBar")}));
+
+    // the prefix itself is no completion
+    QCOMPARE(index.matches(QStringLiteral("fooBar"), 10), QStringList());
+
+    // typing inside a word replaces the word, based on old/new line content
+    index.queueChange(&doc2, QStringLiteral("fooBar fooQux"), QStringLiteral("fooBar fooQuux"));
+    index.processPending();
+    QCOMPARE(index.count(QStringLiteral("fooQux")), 0);
+    QCOMPARE(index.count(QStringLiteral("fooQuux")), 1);
+
+    // reset replaces the complete document content
+    index.queueReset(&doc1, QStringLiteral("fooBaz"));
+    index.processPending();
+    QCOMPARE(index.count(QStringLiteral("fooBar")), 1);
+    QCOMPARE(index.count(QStringLiteral("fooBaz")), 1);
+    QCOMPARE(index.count(QStringLiteral("return")), 0);
+
+    // closing drops all words of the document
+    index.queueReset(&doc2, QString());
+    index.processPending();
+    QCOMPARE(index.matches(QStringLiteral("foo"), 10), QStringList({QStringLiteral("fooBaz")}));
+}
+
 // kate: space-indent on; indent-width 4; replace-tabs on;
@@ -34,6 +34,9 @@ public Q_SLOTS:
 private Q_SLOTS:
     void testCommonParent();
     void testShellCheckParsing();
+    void testSymbolTrie();
+    void testWordIndex();
+    void testIndexLookup();
 };
 
 #endif
@@ -151,6 +151,7 @@ bool KateProject::load(const QVariantMap &globalProject, bool force)
     KateProjectWorker * w = new KateProjectWorker(m_baseDir, m_projectMap);
     connect(w, &KateProjectWorker::loadDone, this, &KateProject::loadProjectDone);
     connect(w, &KateProjectWorker::loadIndexDone, this, &KateProject::loadIndexDone);
+    connect(w, &KateProjectWorker::loadIndexFinished, this, &KateProject::loadIndexFinished);
     m_weaver->stream() << w;
 
     return true;
@@ -187,6 +188,21 @@ void KateProject::loadIndexDone(KateProjectSharedProjectIndex projectIndex)
     emit indexChanged();
 }
 
+void KateProject::loadIndexFinished(KateProjectSharedProjectIndex projectIndex)
+{
+    /**
+     * a newer index might have been handed out meanwhile
+     */
+    if (m_projectIndex != projectIndex) {
+        return;
+    }
+
+    /**
+     * notify external world that the data is complete
+     */
+    emit indexChanged();
+}
+
 QString KateProject::projectLocalFileName(const QString &suffix) const
 {
     /**
@@ -304,15 +320,23 @@ void KateProject::slotModifiedOnDisk(KTextEditor::Document *document,
     item->slotModifiedOnDisk(document, isModified, reason);
 }
 
+QUrl KateProject::documentUrl(KTextEditor::Document *document)
+{
+    const QUrl pendingUrl = document->property("pendingUrl").toUrl();
+    return pendingUrl.isEmpty() ? document->url() : pendingUrl;
+}
+
 void KateProject::registerDocument(KTextEditor::Document *document)
 {
+    const QString file = documentUrl(document).toLocalFile();
+
     // remember the document, if not already there
     if (!m_documents.contains(document)) {
-        m_documents[document] = document->url().toLocalFile();
+        m_documents[document] = file;
     }
 
     // try to get item for the document
-    KateProjectItem *item = itemForFile(document->url().toLocalFile());
+    KateProjectItem *item = itemForFile(file);
 
     // if we got one, we are done, else create a dummy!
     if (item) {
@@ -340,16 +364,17 @@ void KateProject::registerUntrackedDocument(KTextEditor::Document *document)
     }
 
     // create document item
-    QFileInfo fileInfo(document->url().toLocalFile());
+    const QString file = documentUrl(document).toLocalFile();
+    QFileInfo fileInfo(file);
     KateProjectItem *fileItem = new KateProjectItem(KateProjectItem::File, fileInfo.fileName());
-    fileItem->setData(document->url().toLocalFile(), Qt::ToolTipRole);
+    fileItem->setData(file, Qt::ToolTipRole);
     fileItem->slotModifiedChanged(document);
     connect(document, &KTextEditor::Document::modifiedChanged, this, &KateProject::slotModifiedChanged);
     connect(document, SIGNAL(modifiedOnDisk(KTextEditor::Document *, bool, KTextEditor::ModificationInterface::ModifiedOnDiskReason)), this, SLOT(slotModifiedOnDisk(KTextEditor::Document *, bool, KTextEditor::ModificationInterface::ModifiedOnDiskReason)));
 
     bool inserted = false;
     for (int i = 0; i < m_untrackedDocumentsRoot->rowCount(); ++i) {
-        if (m_untrackedDocumentsRoot->child(i)->data(Qt::UserRole).toString() > document->url().toLocalFile()) {
+        if (m_untrackedDocumentsRoot->child(i)->data(Qt::UserRole).toString() > file) {
             m_untrackedDocumentsRoot->insertRow(i, fileItem);
             inserted = true;
             break;
@@ -359,13 +384,13 @@ void KateProject::registerUntrackedDocument(KTextEditor::Document *document)
         m_untrackedDocumentsRoot->appendRow(fileItem);
     }
 
-    fileItem->setData(document->url().toLocalFile(), Qt::UserRole);
+    fileItem->setData(file, Qt::UserRole);
     fileItem->setData(QVariant(true), Qt::UserRole + 3);
 
     if (!m_file2Item) {
         m_file2Item = KateProjectSharedQMapStringItem(new QMap<QString, KateProjectItem *> ());
     }
-    (*m_file2Item)[document->url().toLocalFile()] = fileItem;
+    (*m_file2Item)[file] = fileItem;
 }
 
 void KateProject::unregisterDocument(KTextEditor::Document *document)
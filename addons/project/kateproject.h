@@ -25,6 +25,7 @@
 #include <QMap>
 #include <QSharedPointer>
 #include <QTextDocument>
+#include <QUrl>
 #include <KTextEditor/ModificationInterface>
 #include "kateprojectindex.h"
 #include "kateprojectitem.h"
@@ -189,6 +190,14 @@ public:
      */
     void unregisterDocument(KTextEditor::Document *document);
 
+    /**
+     * Url of a document.
+     * Documents lazily restored from a session are not loaded yet, they carry the url they will load as property.
+     * @param document document
+     * @return url of the document
+     */
+    static QUrl documentUrl(KTextEditor::Document *document);
+
 private Q_SLOTS:
     bool load(const QVariantMap &globalProject, bool force = false);
 
@@ -205,6 +214,12 @@ private Q_SLOTS:
      */
     void loadIndexDone(KateProjectSharedProjectIndex projectIndex);
 
+    /**
+     * Used for worker to tell that the index handed out while loading is complete
+     * @param projectIndex completed project index
+     */
+    void loadIndexFinished(KateProjectSharedProjectIndex projectIndex);
+
     void slotModifiedChanged(KTextEditor::Document *);
 
     void slotModifiedOnDisk(KTextEditor::Document *document,
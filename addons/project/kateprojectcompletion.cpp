@@ -26,6 +26,11 @@
 
 #include <QIcon>
 
+/**
+ * maximal number of completions shown, the trie returns the best ranked ones
+ */
+static const int MaxCompletionResults = 250;
+
 KateProjectCompletion::KateProjectCompletion(KateProjectPlugin *plugin)
     : KTextEditor::CodeCompletionModel(nullptr)
     , m_plugin(plugin)
@@ -38,8 +43,7 @@ KateProjectCompletion::~KateProjectCompletion()
 
 void KateProjectCompletion::saveMatches(KTextEditor::View *view, const KTextEditor::Range &range)
 {
-    m_matches.clear();
-    allMatches(m_matches, view, range);
+    m_matches = allMatches(view, range);
 }
 
 QVariant KateProjectCompletion::data(const QModelIndex &index, int role) const
@@ -59,7 +63,7 @@ QVariant KateProjectCompletion::data(const QModelIndex &index, int role) const
     }
 
     if (index.column() == KTextEditor::CodeCompletionModel::Name && role == Qt::DisplayRole) {
-        return m_matches.item(index.row())->data(Qt::DisplayRole);
+        return m_matches.at(index.row());
     }
 
     if (index.column() == KTextEditor::CodeCompletionModel::Icon && role == Qt::DecorationRole) {
@@ -92,7 +96,7 @@ QModelIndex KateProjectCompletion::index(int row, int column, const QModelIndex
         return QModelIndex();
     }
 
-    if (row < 0 || row >= m_matches.rowCount() || column < 0 || column >= ColumnCount) {
+    if (row < 0 || row >= m_matches.size() || column < 0 || column >= ColumnCount) {
         return QModelIndex();
     }
 
@@ -101,12 +105,12 @@ QModelIndex KateProjectCompletion::index(int row, int column, const QModelIndex
 
 int KateProjectCompletion::rowCount(const QModelIndex &parent) const
 {
-    if (!parent.isValid() && !(m_matches.rowCount() == 0)) {
+    if (!parent.isValid() && !(m_matches.size() == 0)) {
         return 1;    //One root node to define the custom group
     } else if (parent.parent().isValid()) {
         return 0;    //Completion-items have no children
     } else {
-        return m_matches.rowCount();
+        return m_matches.size();
     }
 }
 
@@ -176,24 +180,26 @@ void KateProjectCompletion::completionInvoked(KTextEditor::View *view, const KTe
     saveMatches(view, range);
 }
 
-// Scan throughout the entire document for possible completions,
-// ignoring any dublets
-void KateProjectCompletion::allMatches(QStandardItemModel &model, KTextEditor::View *view, const KTextEditor::Range &range) const
+// Ask the project index for the best ranked completions,
+// no duplicates, capped to MaxCompletionResults
+QStringList KateProjectCompletion::allMatches(KTextEditor::View *view, const KTextEditor::Range &range) const
 {
     /**
      * get project for this document, else fail
      */
     KateProject *project = m_plugin->projectForDocument(view->document());
     if (!project) {
-        return;
+        return QStringList();
     }
 
     /**
-     * let project index fill the completion for this document
+     * let project index compute the completion for this document
      */
-    if (project->projectIndex()) {
-        project->projectIndex()->findMatches(model, view->document()->text(range), KateProjectIndex::CompletionMatches);
+    if (!project->projectIndex()) {
+        return QStringList();
     }
+
+    return project->projectIndex()->completionMatches(view->document()->text(range), MaxCompletionResults, view->document()->url().toLocalFile());
 }
 
 KTextEditor::CodeCompletionModelControllerInterface::MatchReaction KateProjectCompletion::matchingItem(const QModelIndex & /*matched*/)
@@ -26,7 +26,7 @@
 #include <ktexteditor/codecompletionmodel.h>
 #include <ktexteditor/codecompletionmodelcontrollerinterface.h>
 
-#include <QStandardItemModel>
+#include <QStringList>
 
 /**
  * Project wide completion support.
@@ -76,7 +76,7 @@ public:
 
     KTextEditor::Range completionRange(KTextEditor::View *view, const KTextEditor::Cursor &position) override;
 
-    void allMatches(QStandardItemModel &model, KTextEditor::View *view, const KTextEditor::Range &range) const;
+    QStringList allMatches(KTextEditor::View *view, const KTextEditor::Range &range) const;
 
 private:
     /**
@@ -85,9 +85,9 @@ private:
     KateProjectPlugin *m_plugin;
 
     /**
-     * model with matching data
+     * ranked matching names
      */
-    QStandardItemModel m_matches;
+    QStringList m_matches;
 
     /**
      * automatic invocation?
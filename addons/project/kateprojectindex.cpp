@@ -22,184 +22,501 @@
 
 #include <QProcess>
 #include <QDir>
+#include <QFileInfo>
+#include <QTemporaryFile>
 
-/**
- * include ctags reading
- */
-#include "ctags/readtags.c"
+#include <algorithm>
+#include <cstring>
 
-KateProjectIndex::KateProjectIndex(const QStringList &files, const QVariantMap &ctagsMap)
-    : m_ctagsIndexFile(QDir::tempPath() + QStringLiteral("/kate.project.ctags"))
-    , m_ctagsIndexHandle(nullptr)
+KateProjectIndex::KateProjectIndex()
+    : m_valid(false)
+    , m_loading(true)
 {
-    /**
-     * load ctags
-     */
-    loadCtags(files, ctagsMap);
 }
 
 KateProjectIndex::~KateProjectIndex()
 {
-    /**
-     * delete ctags handle if any
-     */
-    if (m_ctagsIndexHandle) {
-        tagsClose(m_ctagsIndexHandle);
-        m_ctagsIndexHandle = nullptr;
-    }
 }
 
-void KateProjectIndex::loadCtags(const QStringList &files, const QVariantMap &ctagsMap)
+bool KateProjectIndex::isValid() const
 {
-    /**
-     * create temporary file
-     * if not possible, fail
-     */
-    if (!m_ctagsIndexFile.open()) {
-        return;
-    }
+    QReadLocker locker(&m_lock);
+    return m_valid;
+}
 
+bool KateProjectIndex::isLoading() const
+{
+    QReadLocker locker(&m_lock);
+    return m_loading;
+}
+
+void KateProjectIndex::loadCtags(const QStringList &files, const QVariantMap &ctagsMap, const std::function<void()> &started)
+{
     /**
-     * close file again, other process will use it
+     * streaming is the default, "stream": false lets ctags write a sorted temporary tags file first
      */
-    m_ctagsIndexFile.close();
+    const bool stream = ctagsMap.value(QStringLiteral("stream"), true).toBool();
+    QTemporaryFile indexFile(QDir::tempPath() + QStringLiteral("/kate.project.ctags"));
+    if (!stream) {
+        /**
+         * create temporary file, close it again, ctags will use it
+         * if not possible, fail
+         */
+        if (!indexFile.open()) {
+            finishLoading(false);
+            return;
+        }
+        indexFile.close();
+    }
 
     /**
      * try to run ctags for all files in this project
-     * output to our ctags index file
+     * when streaming unsorted, sorting would make ctags buffer everything first
      */
     QProcess ctags;
     QStringList args;
-    args << QStringLiteral("-L") << QStringLiteral("-") << QStringLiteral("-f") << m_ctagsIndexFile.fileName() << QStringLiteral("--fields=+K+n");
+    args << QStringLiteral("-L") << QStringLiteral("-") << QStringLiteral("-f");
+    if (stream) {
+        args << QStringLiteral("-") << QStringLiteral("--sort=no");
+    } else {
+        args << indexFile.fileName();
+    }
+    args << QStringLiteral("--fields=+K+n");
     const QString keyOptions = QStringLiteral("options");
     for (const QVariant &optVariant : ctagsMap[keyOptions].toList()) {
         args << optVariant.toString();
     }
+    ctags.setStandardErrorFile(QProcess::nullDevice());
     ctags.start(QStringLiteral("ctags"), args);
     if (!ctags.waitForStarted()) {
+        finishLoading(false);
         return;
     }
 
+    /**
+     * when streaming, the index is filled step by step from now on and can be queried meanwhile
+     */
+    if (stream) {
+        started();
+    }
+
     /**
      * write files list and close write channel
      */
     ctags.write(files.join(QStringLiteral("\n")).toLocal8Bit());
     ctags.closeWriteChannel();
 
+    QByteArray buffer;
+    IngestState state;
+    if (stream) {
+        /**
+         * ingest the output chunk by chunk while ctags is running
+         * the waitFor functions also take care of writing the files list
+         */
+        while (true) {
+            const bool running = ctags.waitForReadyRead(-1);
+            buffer += ctags.readAllStandardOutput();
+            if (!running) {
+                // ensure last line is complete
+                buffer += '\n';
+            }
+
+            {
+                QWriteLocker locker(&m_lock);
+                ingest(buffer, state);
+            }
+
+            if (!running) {
+                break;
+            }
+        }
+        ctags.waitForFinished(-1);
+    } else {
+        /**
+         * wait for done, then read the tags file in chunks
+         */
+        if (!ctags.waitForFinished(-1) || !indexFile.open()) {
+            finishLoading(false);
+            return;
+        }
+
+        while (!indexFile.atEnd()) {
+            buffer += indexFile.read(1024 * 1024);
+            if (indexFile.atEnd()) {
+                // ensure last line is complete
+                buffer += '\n';
+            }
+
+            QWriteLocker locker(&m_lock);
+            ingest(buffer, state);
+        }
+    }
+
+    /**
+     * only valid if ctags did its job and found something
+     */
+    bool found = false;
+    {
+        QReadLocker locker(&m_lock);
+        found = !m_symbolLocations.isEmpty();
+    }
+    finishLoading(found && ctags.exitStatus() == QProcess::NormalExit && ctags.exitCode() == 0);
+}
+
+void KateProjectIndex::loadTags(const QByteArray &tags)
+{
+    QByteArray buffer = tags;
+    buffer += '\n';
+    IngestState state;
+    bool found = false;
+    {
+        QWriteLocker locker(&m_lock);
+        ingest(buffer, state);
+        found = !m_symbolLocations.isEmpty();
+    }
+    finishLoading(found);
+}
+
+void KateProjectIndex::finishLoading(bool valid)
+{
+    QWriteLocker locker(&m_lock);
+    m_valid = valid;
+    m_loading = false;
+}
+
+void KateProjectIndex::ingest(QByteArray &buffer, IngestState &state)
+{
+    const char *begin = buffer.constData();
+    const char *const end = begin + buffer.size();
+    while (begin < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        if (!lineEnd) {
+            break;
+        }
+        ingestLine(begin, (lineEnd > begin && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd, state);
+        begin = lineEnd + 1;
+    }
+
+    /**
+     * keep the partial last line for the next chunk
+     */
+    buffer.remove(0, begin - buffer.constData());
+}
+
+void KateProjectIndex::ingestLine(const char *begin, const char *end, IngestState &state)
+{
     /**
-     * wait for done
+     * skip empty lines and pseudo tags like !_TAG_FILE_FORMAT
      */
-    if (!ctags.waitForFinished(-1)) {
+    if (begin == end || (end - begin >= 2 && begin[0] == '!' && begin[1] == '_')) {
         return;
     }
 
     /**
-     * file not openable, bad
+     * format: name<TAB>file<TAB>address;"<TAB>field<TAB>key:value...
      */
-    if (!m_ctagsIndexFile.open()) {
+    const char *nameEnd = static_cast<const char *>(memchr(begin, '\t', end - begin));
+    if (!nameEnd || nameEnd == begin) {
+        return;
+    }
+    const char *fileBegin = nameEnd + 1;
+    const char *fileEnd = static_cast<const char *>(memchr(fileBegin, '\t', end - fileBegin));
+    if (!fileEnd) {
         return;
     }
 
     /**
-     * get size
+     * skip the address, either a /pattern/ (or ?pattern?) or a line number
      */
-    qint64 size = m_ctagsIndexFile.size();
+    const char *pos = fileEnd + 1;
+    int line = 0;
+    if (pos < end && (*pos == '/' || *pos == '?')) {
+        const char delimiter = *pos++;
+        while (pos < end && *pos != delimiter) {
+            pos += (*pos == '\\' && pos + 1 < end) ? 2 : 1;
+        }
+        ++pos;
+    } else {
+        while (pos < end && *pos >= '0' && *pos <= '9') {
+            line = line * 10 + (*pos - '0');
+            ++pos;
+        }
+    }
 
     /**
-     * close again
+     * file names are repeated a lot, convert them only on change
      */
-    m_ctagsIndexFile.close();
+    if (state.lastFile.size() != int(fileEnd - fileBegin) || memcmp(state.lastFile.constData(), fileBegin, fileEnd - fileBegin) != 0) {
+        state.lastFile = QByteArray(fileBegin, fileEnd - fileBegin);
+        state.file = QString::fromLocal8Bit(state.lastFile);
+    }
 
     /**
-     * empty file, bad
+     * kinds and scopes are interned
      */
-    if (!size) {
-        return;
+    auto intern = [&state](const char *valueBegin, const char *valueEnd) {
+        const QByteArray key(valueBegin, valueEnd - valueBegin);
+        auto it = state.strings.constFind(key);
+        if (it == state.strings.constEnd()) {
+            it = state.strings.insert(key, QString::fromLocal8Bit(key));
+        }
+        return it.value();
+    };
+
+    const QString name = QString::fromLocal8Bit(begin, nameEnd - begin);
+    const int symbol = m_symbolTrie.insert(name, state.file);
+    if (symbol >= m_symbolLocations.size()) {
+        m_symbolLocations.resize(symbol + 1);
     }
 
+    Location location;
+    location.name = m_symbolTrie.name(symbol);
+    location.file = state.file;
+    location.line = line;
+    location.fileScope = false;
+
     /**
-     * try to open ctags file
+     * extension fields: a field without key is the kind, scope is given by the first class/namespace/... field
      */
-    tagFileInfo info;
-    memset(&info, 0, sizeof(tagFileInfo));
-    m_ctagsIndexHandle = tagsOpen(m_ctagsIndexFile.fileName().toLocal8Bit().constData(), &info);
+    if (end - pos >= 2 && pos[0] == ';' && pos[1] == '"') {
+        pos += 2;
+        while (pos < end) {
+            if (*pos == '\t') {
+                ++pos;
+                continue;
+            }
+
+            const char *fieldEnd = static_cast<const char *>(memchr(pos, '\t', end - pos));
+            if (!fieldEnd) {
+                fieldEnd = end;
+            }
+
+            const char *colon = static_cast<const char *>(memchr(pos, ':', fieldEnd - pos));
+            if (!colon) {
+                location.kind = intern(pos, fieldEnd);
+            } else {
+                const QByteArray key = QByteArray::fromRawData(pos, colon - pos);
+                if (key == "line") {
+                    location.line = QByteArray(colon + 1, fieldEnd - colon - 1).toInt();
+                } else if (key == "kind") {
+                    location.kind = intern(colon + 1, fieldEnd);
+                } else if (key == "file") {
+                    location.fileScope = true;
+                } else if (location.scope.isEmpty()) {
+                    static const char *const scopeKeys[] = {"class", "struct", "namespace", "union", "enum", "interface", "module", "function"};
+                    for (const char *scopeKey : scopeKeys) {
+                        if (key == scopeKey) {
+                            location.scope = intern(colon + 1, fieldEnd);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            pos = fieldEnd;
+        }
+    }
+
+    m_symbolLocations[symbol].append(location);
 }
 
-void KateProjectIndex::findMatches(QStandardItemModel &model, const QString &searchWord, MatchType type)
+QStringList KateProjectIndex::completionMatches(const QString &prefix, int maxResults, const QString &currentFile) const
+{
+    QReadLocker locker(&m_lock);
+    return m_symbolTrie.complete(prefix, maxResults, currentFile);
+}
+
+/**
+ * is this ctags kind only a declaration? handles both short and long (--fields=+K) kinds
+ */
+static bool isDeclarationKind(const QString &kind)
+{
+    return kind == QLatin1String("p") || kind == QLatin1String("prototype")
+           || kind == QLatin1String("x") || kind == QLatin1String("externvar");
+}
+
+QVector<KateProjectIndex::Location> KateProjectIndex::lookup(const QString &word, const QString &currentFile, LookupType type, int maxResults, bool withSubstrings) const
 {
     /**
-     * abort if no ctags index
+     * split off qualifier, "Foo::bar" => scope "Foo", name "bar"
      */
-    if (!m_ctagsIndexHandle) {
-        return;
+    QString name = word;
+    QString qualifier;
+    const int separator = qMax(word.lastIndexOf(QLatin1String("::")), word.lastIndexOf(QLatin1Char('.')));
+    if (separator >= 0) {
+        const int separatorLength = (word.midRef(separator, 2) == QLatin1String("::")) ? 2 : 1;
+        qualifier = word.left(separator);
+        name = word.mid(separator + separatorLength);
+    }
+
+    if (name.isEmpty() || maxResults <= 0) {
+        return QVector<Location>();
     }
 
     /**
-     * word to complete
-     * abort if empty
+     * locations of one symbol, declarations are dropped if we want definitions and have any
      */
-    QByteArray word = searchWord.toLocal8Bit();
-    if (word.isEmpty()) {
-        return;
-    }
+    auto symbolLocations = [this, type](int symbol) -> QVector<Location> {
+        const QVector<Location> &locations = m_symbolLocations.at(symbol);
+        if (type != Definitions) {
+            return locations;
+        }
+        QVector<Location> definitions;
+        for (const Location &location : locations) {
+            if (!isDeclarationKind(location.kind)) {
+                definitions.append(location);
+            }
+        }
+        return definitions.isEmpty() ? locations : definitions;
+    };
 
     /**
-     * try to search entry
-     * fail if none found
+     * candidates in three tiers: the symbol itself, symbols starting with the name, symbols containing it
+     * the prefix tier is only searched if the exact one doesn't fill the result,
+     * the substring tier scans the whole table and is only searched on request if nothing else is known
      */
-    tagEntry entry;
-    if (tagsFind(m_ctagsIndexHandle, &entry, word.constData(), TAG_PARTIALMATCH  | TAG_OBSERVECASE) != TagSuccess) {
-        return;
+    QVector<QVector<Location>> tiers(3);
+    {
+        QReadLocker locker(&m_lock);
+        const int exact = m_symbolTrie.find(name);
+        if (exact >= 0 && exact < m_symbolLocations.size()) {
+            tiers[0] = symbolLocations(exact);
+        }
+
+        if (tiers[0].size() < maxResults) {
+            QVector<int> prefixed = m_symbolTrie.symbolsWithPrefix(name);
+            std::sort(prefixed.begin(), prefixed.end(), [this](int a, int b) {
+                return m_symbolTrie.name(a) < m_symbolTrie.name(b);
+            });
+            for (int symbol : qAsConst(prefixed)) {
+                if (symbol != exact && symbol < m_symbolLocations.size()) {
+                    tiers[1] += symbolLocations(symbol);
+                }
+            }
+        }
+
+        if (withSubstrings && tiers[0].isEmpty() && tiers[1].isEmpty()) {
+            QVector<int> containing;
+            for (int symbol = 0; symbol < m_symbolTrie.symbolCount() && symbol < m_symbolLocations.size() && containing.size() < maxResults; ++symbol) {
+                const QString &symbolName = m_symbolTrie.name(symbol);
+                if (symbolName.indexOf(name, 1) > 0) {
+                    containing.append(symbol);
+                }
+            }
+            std::sort(containing.begin(), containing.end(), [this](int a, int b) {
+                return m_symbolTrie.name(a) < m_symbolTrie.name(b);
+            });
+            for (int symbol : qAsConst(containing)) {
+                tiers[2] += symbolLocations(symbol);
+            }
+        }
     }
 
     /**
-     * set to show words only once for completion matches
+     * compute rank for each location, few candidates, cheap
      */
-    QSet<QString> guard;
+    const QFileInfo currentInfo(currentFile);
+    const QString currentDir = currentInfo.path();
+    const QString currentBaseName = currentInfo.completeBaseName();
+    auto rank = [&](const Location &location) {
+        int score = 0;
+        if (!qualifier.isEmpty() && (location.scope == qualifier || location.scope.endsWith(QLatin1String("::") + qualifier) || location.scope.endsWith(QLatin1Char('.') + qualifier))) {
+            score += 1 << 20;
+        }
+
+        if (location.file == currentFile) {
+            score += 1 << 18;
+        } else if (location.fileScope) {
+            // not visible from other files
+            return score - (1 << 19);
+        }
+
+        const int slash = location.file.lastIndexOf(QLatin1Char('/'));
+        const QStringRef dir = location.file.leftRef(qMax(slash, 0));
+        if (dir == currentDir) {
+            score += 1 << 16;
+            const QStringRef fileName = location.file.midRef(slash + 1);
+            const int dot = fileName.lastIndexOf(QLatin1Char('.'));
+            if (fileName.left(dot < 0 ? fileName.size() : dot) == currentBaseName) {
+                score += 1 << 17;
+            }
+        }
+
+        // directory distance: length of common path prefix
+        int common = 0;
+        while (common < dir.size() && common < currentDir.size() && dir.at(common) == currentDir.at(common)) {
+            ++common;
+        }
+        return score + qMin(common, 0xffff);
+    };
 
     /**
-     * loop over all found tags
-     * first one is filled by above find, others by find next
+     * rank inside each tier, symbols of the same rank stay sorted by name
      */
-    do {
-        /**
-         * skip if no name
-         */
-        if (!entry.name) {
-            continue;
+    QVector<Location> result;
+    for (const QVector<Location> &locations : qAsConst(tiers)) {
+        QVector<QPair<int, int>> ranked;
+        ranked.reserve(locations.size());
+        for (int i = 0; i < locations.size(); ++i) {
+            ranked.append(qMakePair(rank(locations.at(i)), i));
         }
+        std::stable_sort(ranked.begin(), ranked.end(), [](const QPair<int, int> &a, const QPair<int, int> &b) {
+            return a.first > b.first;
+        });
 
-        /**
-         * get name
-         */
-        QString name(QString::fromLocal8Bit(entry.name));
+        for (const auto &entry : qAsConst(ranked)) {
+            if (result.size() >= maxResults) {
+                return result;
+            }
+            result.append(locations.at(entry.second));
+        }
+    }
+    return result;
+}
 
-        /**
-         * construct right items
-         */
+void KateProjectIndex::findMatches(QStandardItemModel &model, const QString &searchWord, MatchType type)
+{
+    /**
+     * abort if empty word, partial results are fine while loading
+     */
+    if (searchWord.isEmpty()) {
+        return;
+    }
+
+    /**
+     * collect matching symbols, sorted by name like the ctags file was
+     */
+    QReadLocker locker(&m_lock);
+    QVector<int> symbols = m_symbolTrie.symbolsWithPrefix(searchWord);
+    std::sort(symbols.begin(), symbols.end(), [this](int a, int b) {
+        return m_symbolTrie.name(a) < m_symbolTrie.name(b);
+    });
+
+    /**
+     * construct right items, each symbol is unique, no guard needed for completion
+     */
+    for (int symbol : qAsConst(symbols)) {
         switch (type) {
         case CompletionMatches:
             /**
-             * add new completion item, if new name
+             * add new completion item
              */
-            if (!guard.contains(name)) {
-                model.appendRow(new QStandardItem(name));
-                guard.insert(name);
-            }
+            model.appendRow(new QStandardItem(m_symbolTrie.name(symbol)));
             break;
 
         case FindMatches:
             /**
-             * add new find item, contains of multiple columns
+             * add new find item per location, contains of multiple columns
              */
-            QList<QStandardItem *> items;
-            items << new QStandardItem(name);
-            items << new QStandardItem(entry.kind ? QString::fromLocal8Bit(entry.kind) : QString());
-            items << new QStandardItem(entry.file ? QString::fromLocal8Bit(entry.file) : QString());
-            items << new QStandardItem(QString::number(entry.address.lineNumber));
-            model.appendRow(items);
+            for (const Location &location : m_symbolLocations.at(symbol)) {
+                QList<QStandardItem *> items;
+                items << new QStandardItem(location.name);
+                items << new QStandardItem(location.kind);
+                items << new QStandardItem(location.file);
+                items << new QStandardItem(QString::number(location.line));
+                model.appendRow(items);
+            }
             break;
         }
-    } while (tagsFindNext(m_ctagsIndexHandle, &entry) == TagSuccess);
+    }
 }
-
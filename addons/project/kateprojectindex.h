@@ -25,30 +25,29 @@
 #include <ktexteditor/view.h>
 
 #include <QStringList>
-#include <QTemporaryFile>
 #include <QStandardItemModel>
+#include <QReadWriteLock>
 
-/**
- * ctags reading
- */
-#include "ctags/readtags.h"
+#include <functional>
+
+#include "kateprojectsymboltrie.h"
 
 /**
  * Class representing the index of a project.
  * This includes knowledge from ctags and Co.
  * Allows you to search for stuff and to get some useful auto-completion.
- * Is created in Worker thread in the background, then passed to project in
- * the main thread for usage.
+ * Is created and filled in Worker thread in the background, then passed to project in
+ * the main thread for usage. By default the ctags output is streamed into memory, the index
+ * is then already handed out while loading and can be queried during that, all accessors are
+ * thread-safe.
  */
 class KateProjectIndex
 {
 public:
     /**
-     * construct new index for given files
-     * @param files files to index
-     * @param ctagsMap ctags section for extra options
+     * construct new empty index, fill it with loadCtags()
      */
-    KateProjectIndex(const QStringList &files, const QVariantMap &ctagsMap);
+    KateProjectIndex();
 
     /**
      * deconstruct project
@@ -80,33 +79,140 @@ public:
      */
     void findMatches(QStandardItemModel &model, const QString &searchWord, MatchType type);
 
+    /**
+     * Get ranked completions for given prefix.
+     * Served from the in-memory symbol trie, no access to the ctags file.
+     * @param prefix prefix to complete
+     * @param maxResults maximal number of results
+     * @param currentFile file the completion is requested in, used for ranking
+     * @return ranked list of symbol names
+     */
+    QStringList completionMatches(const QString &prefix, int maxResults, const QString &currentFile) const;
+
+    /**
+     * One location of a symbol, as recorded by ctags.
+     */
+    struct Location {
+        QString name;
+        QString file;
+        int line;
+        QString kind;
+        QString scope;
+        bool fileScope;
+    };
+
+    /**
+     * Which locations should lookup() return?
+     */
+    enum LookupType {
+        /**
+         * Definitions only, declarations like prototypes are only returned if no definition is known
+         */
+        Definitions,
+
+        /**
+         * All known locations, definitions and declarations
+         */
+        AllLocations
+    };
+
+    /**
+     * Resolve a symbol to its locations, served from the in-memory symbol table.
+     * A qualified word like "Foo::bar" or "foo.bar" looks up "bar" and prefers locations in scope "Foo" resp. "foo".
+     * Locations of the symbol itself come first, then those of symbols starting with the name.
+     * Inside these, ranking: matching scope, current file, companion file (same base name),
+     * same directory, directory distance. Symbols with file scope in other files are ranked last.
+     * @param word word to look up, possibly qualified
+     * @param currentFile file the lookup is requested from, used for ranking
+     * @param type which locations to return
+     * @param maxResults maximal number of returned locations
+     * @param withSubstrings if neither the symbol nor symbols starting with the name are known,
+     *        scan all symbols for ones containing the name, stops after maxResults symbols
+     * @return ranked locations, best first
+     */
+    QVector<Location> lookup(const QString &word, const QString &currentFile, LookupType type, int maxResults = 100, bool withSubstrings = false) const;
+
     /**
      * Check if running ctags was successful. This can be used
      * as indicator whether ctags is installed or not.
-     * @return true if a valid index exists, otherwise false
+     * @return true if loading is done and found symbols, otherwise false
      */
-    bool isValid() const {
-        return m_ctagsIndexHandle;
-    }
+    bool isValid() const;
 
-private:
     /**
-     * Load ctags tags.
+     * Is ctags still running? While streaming, partial results are available meanwhile.
+     * @return true until loadCtags() is done
+     */
+    bool isLoading() const;
+
+    /**
+     * Run ctags for the given files and load its output into the index.
+     * By default the output is streamed into the index while ctags runs,
+     * with "stream": false in the ctags section ctags writes a temporary tags file that is read afterwards.
+     * Blocks until ctags is done, to be called in the worker thread.
      * @param files files to index
      * @param ctagsMap ctags section for extra options
+     * @param started called once ctags did start when streaming, from then on partial results are queryable
      */
-    void loadCtags(const QStringList &files, const QVariantMap &ctagsMap);
+    void loadCtags(const QStringList &files, const QVariantMap &ctagsMap, const std::function<void()> &started);
+
+    /**
+     * Load ctags output, e.g. the content of a tags file, into the index without running ctags.
+     * @param tags ctags output
+     */
+    void loadTags(const QByteArray &tags);
 
 private:
     /**
-     * ctags index file
+     * State kept between chunks of ctags output.
+     */
+    struct IngestState {
+        QByteArray lastFile;
+        QString file;
+        QHash<QByteArray, QString> strings;
+    };
+
+    /**
+     * Parse all complete lines of the buffer into the index, removes them from the buffer.
+     * Caller must hold the write lock.
+     * @param buffer ctags output, may end with a partial line
+     * @param state state kept between chunks
+     */
+    void ingest(QByteArray &buffer, IngestState &state);
+
+    /**
+     * Parse one ctags line into the index.
+     * Caller must hold the write lock.
+     */
+    void ingestLine(const char *begin, const char *end, IngestState &state);
+
+    /**
+     * Loading is done, set the state.
+     * @param valid did ctags work and find symbols?
+     */
+    void finishLoading(bool valid);
+
+private:
+    /**
+     * guards all index data, written by the worker while loading, read by the main thread
+     */
+    mutable QReadWriteLock m_lock;
+
+    /**
+     * did ctags run and find symbols? still loading?
+     */
+    bool m_valid;
+    bool m_loading;
+
+    /**
+     * prefix trie over all symbol names, used for completion
      */
-    QTemporaryFile m_ctagsIndexFile;
+    KateProjectSymbolTrie m_symbolTrie;
 
     /**
-     * handle to ctags file for querying, if possible
+     * symbol id of m_symbolTrie => locations of this symbol
      */
-    tagFile *m_ctagsIndexHandle;
+    QVector<QVector<Location>> m_symbolLocations;
 };
 
 #endif
@@ -136,7 +136,7 @@ void KateProjectInfoViewIndex::indexAvailable()
     /**
      * update enabled state of widgets
      */
-    const bool valid = m_project->projectIndex()->isValid();
+    const bool valid = m_project->projectIndex()->isValid() || m_project->projectIndex()->isLoading();
     m_lineEdit->setEnabled(valid);
     m_treeView->setEnabled(valid);
 
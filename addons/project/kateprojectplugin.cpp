@@ -66,6 +66,7 @@ KateProjectPlugin::KateProjectPlugin(QObject *parent, const QList<QVariant> &)
     , m_autoSubversion(true)
     , m_autoMercurial(true)
     , m_weaver(new ThreadWeaver::Queue(this))
+    , m_wordCompletion(m_weaver)
 {
     qRegisterMetaType<KateProjectSharedQStandardItem>("KateProjectSharedQStandardItem");
     qRegisterMetaType<KateProjectSharedQMapStringItem>("KateProjectSharedQMapStringItem");
@@ -200,6 +201,8 @@ void KateProjectPlugin::slotDocumentCreated(KTextEditor::Document *document)
     connect(document, &KTextEditor::Document::documentUrlChanged, this, &KateProjectPlugin::slotDocumentUrlChanged);
     connect(document, &KTextEditor::Document::destroyed, this, &KateProjectPlugin::slotDocumentDestroyed);
 
+    m_wordCompletion.registerDocument(document);
+
     slotDocumentUrlChanged(document);
 }
 
@@ -214,7 +217,7 @@ void KateProjectPlugin::slotDocumentDestroyed(QObject *document)
 
 void KateProjectPlugin::slotDocumentUrlChanged(KTextEditor::Document *document)
 {
-    KateProject *project = projectForUrl(document->url());
+    KateProject *project = projectForUrl(KateProject::documentUrl(document));
 
     if (KateProject *project = m_document2Project.value(document)) {
         project->unregisterDocument(document);
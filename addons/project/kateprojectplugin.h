@@ -32,6 +32,7 @@
 
 #include "kateproject.h"
 #include "kateprojectcompletion.h"
+#include "kateprojectwordcompletion.h"
 
 namespace ThreadWeaver {
     class Queue;
@@ -93,6 +94,14 @@ public:
         return &m_completion;
     }
 
+    /**
+     * Get global word completion over all open documents.
+     * @return global word completion object for KTextEditor::View
+     */
+    KateProjectWordCompletion *wordCompletion() {
+        return &m_wordCompletion;
+    }
+
     /**
      * Map current open documents to projects.
      * @param document document we want to know which project it belongs to
@@ -174,6 +183,11 @@ private:
     bool m_autoMercurial : 1;
 
     ThreadWeaver::Queue *m_weaver;
+
+    /**
+     * Word completion over all open documents, updated in m_weaver
+     */
+    KateProjectWordCompletion m_wordCompletion;
 };
 
 #endif
@@ -52,6 +52,7 @@ KateProjectPluginView::KateProjectPluginView(KateProjectPlugin *plugin, KTextEdi
     , m_toolView(nullptr)
     , m_toolInfoView(nullptr)
     , m_lookupAction(nullptr)
+    , m_gotoDefinitionAction(nullptr)
 {
     KXMLGUIClient::setComponentName(QStringLiteral("kateproject"), i18n("Kate Project Manager"));
     setXMLFile(QStringLiteral("ui.rc"));
@@ -90,12 +91,15 @@ KateProjectPluginView::KateProjectPluginView(KateProjectPlugin *plugin, KTextEdi
     actionCollection()->setDefaultShortcut(a, QKeySequence(Qt::CTRL | Qt::ALT | Qt::Key_Right));
     a = actionCollection()->addAction(KStandardAction::Goto, QStringLiteral("projects_goto_index"), this, SLOT(slotProjectIndex()));
     actionCollection()->setDefaultShortcut(a, QKeySequence(Qt::ALT | Qt::Key_1));
+    a = actionCollection()->addAction(QStringLiteral("projects_goto_definition"), this, SLOT(slotGotoDefinition()));
+    a->setText(i18n("Go to Definition"));
 
     // popup menu
     auto popup = new KActionMenu(i18n("Project"), this);
     actionCollection()->addAction(QStringLiteral("popup_project"), popup);
 
     m_lookupAction = popup->menu()->addAction(i18n("Lookup: %1", QString()), this, &KateProjectPluginView::slotProjectIndex);
+    m_gotoDefinitionAction = popup->menu()->addAction(i18n("Go to Definition: %1", QString()), this, &KateProjectPluginView::slotGotoDefinition);
 
     connect(popup->menu(), &QMenu::aboutToShow, this, &KateProjectPluginView::slotContextMenuAboutToShow);
 
@@ -114,6 +118,7 @@ KateProjectPluginView::~KateProjectPluginView()
         KTextEditor::CodeCompletionInterface *cci = qobject_cast<KTextEditor::CodeCompletionInterface *>(view);
         if (cci) {
             cci->unregisterCompletionModel(m_plugin->completion());
+            cci->unregisterCompletionModel(m_plugin->wordCompletion());
         }
     }
 
@@ -192,6 +197,11 @@ QPair<KateProjectView *, KateProjectInfoView *> KateProjectPluginView::viewForPr
     m_stackedProjectInfoViews->setFocusProxy(infoView);
     m_projectsCombo->addItem(QIcon::fromTheme(QStringLiteral("project-open")), project->name(), project->fileName());
 
+    /**
+     * track file list changes, for projectFiles
+     */
+    connect(project, &KateProject::modelChanged, this, &KateProjectPluginView::slotProjectModelChanged);
+
     /**
      * remember and return it
      */
@@ -363,6 +373,18 @@ void KateProjectPluginView::slotCurrentChanged(int index)
      */
     emit projectFileNameChanged();
     emit projectMapChanged();
+    emit projectFilesChanged();
+}
+
+void KateProjectPluginView::slotProjectModelChanged()
+{
+    /**
+     * only the files of the active project are exported
+     */
+    QWidget *active = m_stackedProjectViews->currentWidget();
+    if (active && static_cast<KateProjectView *>(active)->project() == sender()) {
+        emit projectFilesChanged();
+    }
 }
 
 void KateProjectPluginView::slotDocumentUrlChanged(KTextEditor::Document *document)
@@ -413,6 +435,7 @@ void KateProjectPluginView::slotViewCreated(KTextEditor::View *view)
     KTextEditor::CodeCompletionInterface *cci = qobject_cast<KTextEditor::CodeCompletionInterface *>(view);
     if (cci) {
         cci->registerCompletionModel(m_plugin->completion());
+        cci->registerCompletionModel(m_plugin->wordCompletion());
     }
 
     /**
@@ -521,6 +544,127 @@ void KateProjectPluginView::slotContextMenuAboutToShow()
 
     const QString squeezed = KStringHandler::csqueeze(word, 30);
     m_lookupAction->setText(i18n("Lookup: %1", squeezed));
+    m_gotoDefinitionAction->setText(i18n("Go to Definition: %1", squeezed));
+}
+
+QString KateProjectPluginView::currentQualifiedWord() const
+{
+    KTextEditor::View *kv = m_activeTextEditorView;
+    if (!kv) {
+        return QString();
+    }
+
+    if (kv->selection() && kv->selectionRange().onSingleLine()) {
+        return kv->selectionText();
+    }
+
+    const KTextEditor::Range range = kv->document()->wordRangeAt(kv->cursorPosition());
+    if (!range.isValid() || range.isEmpty()) {
+        return QString();
+    }
+
+    /**
+     * collect "Foo::" or "foo." qualifiers in front of the word
+     */
+    const QString line = kv->document()->line(range.start().line());
+    int start = range.start().column();
+    while (true) {
+        int separatorStart = start;
+        if (start >= 2 && line.midRef(start - 2, 2) == QLatin1String("::")) {
+            separatorStart = start - 2;
+        } else if (start >= 1 && line.at(start - 1) == QLatin1Char('.')) {
+            separatorStart = start - 1;
+        } else {
+            break;
+        }
+
+        int qualifierStart = separatorStart;
+        while (qualifierStart > 0 && (line.at(qualifierStart - 1).isLetterOrNumber() || line.at(qualifierStart - 1) == QLatin1Char('_'))) {
+            --qualifierStart;
+        }
+        if (qualifierStart == separatorStart) {
+            break;
+        }
+        start = qualifierStart;
+    }
+
+    return line.mid(start, range.end().column() - start);
+}
+
+KateProject *KateProjectPluginView::projectForLookup(const QString &file) const
+{
+    for (KateProject *project : m_plugin->projects()) {
+        if (project->itemForFile(file)) {
+            return project;
+        }
+    }
+
+    // no project view there, no active project
+    if (!m_toolView) {
+        return nullptr;
+    }
+
+    if (QWidget *current = m_stackedProjectViews->currentWidget()) {
+        return static_cast<KateProjectView *>(current)->project();
+    }
+
+    return nullptr;
+}
+
+QVariantList KateProjectPluginView::symbolLocations(const QString &word, const QString &currentFile, bool definitionsOnly) const
+{
+    QVariantList result;
+    KateProject *project = projectForLookup(currentFile);
+    if (!project || !project->projectIndex()) {
+        return result;
+    }
+
+    const auto locations = project->projectIndex()->lookup(word, currentFile, definitionsOnly ? KateProjectIndex::Definitions : KateProjectIndex::AllLocations);
+    for (const auto &location : locations) {
+        QVariantMap entry;
+        entry[QStringLiteral("name")] = location.name;
+        entry[QStringLiteral("file")] = location.file;
+        entry[QStringLiteral("line")] = location.line;
+        entry[QStringLiteral("kind")] = location.kind;
+        entry[QStringLiteral("scope")] = location.scope;
+        result.append(entry);
+    }
+    return result;
+}
+
+void KateProjectPluginView::slotGotoDefinition()
+{
+    KTextEditor::View *kv = m_activeTextEditorView;
+    if (!kv) {
+        return;
+    }
+
+    const QString word = currentQualifiedWord();
+    if (word.isEmpty()) {
+        return;
+    }
+
+    /**
+     * no known location of the symbol itself, only similar ones => show the lookup in the index instead
+     */
+    const QVariantList locations = symbolLocations(word, kv->document()->url().toLocalFile());
+    const QVariantMap best = locations.isEmpty() ? QVariantMap() : locations.first().toMap();
+    const QString name = best[QStringLiteral("name")].toString();
+    if (name.isEmpty() || !(word == name || word.endsWith(QLatin1String("::") + name) || word.endsWith(QLatin1Char('.') + name))) {
+        slotProjectIndex();
+        return;
+    }
+
+    const int line = qMax(best[QStringLiteral("line")].toInt() - 1, 0);
+
+    KTextEditor::View *view = m_mainWindow->openUrl(QUrl::fromLocalFile(best[QStringLiteral("file")].toString()));
+    if (!view) {
+        return;
+    }
+
+    const int column = qMax(view->document()->line(line).indexOf(name), 0);
+    view->setCursorPosition(KTextEditor::Cursor(line, column));
+    view->setFocus();
 }
 
 #include "kateprojectpluginview.moc"
@@ -43,7 +43,7 @@ class KateProjectPluginView : public QObject, public KXMLGUIClient
     Q_PROPERTY(QString projectName READ projectName)
     Q_PROPERTY(QString projectBaseDir READ projectBaseDir)
     Q_PROPERTY(QVariantMap projectMap READ projectMap NOTIFY projectMapChanged)
-    Q_PROPERTY(QStringList projectFiles READ projectFiles)
+    Q_PROPERTY(QStringList projectFiles READ projectFiles NOTIFY projectFilesChanged)
 
     Q_PROPERTY(QString allProjectsCommonBaseDir READ allProjectsCommonBaseDir)
     Q_PROPERTY(QStringList allProjectsFiles READ allProjectsFiles)
@@ -93,6 +93,18 @@ public:
      */
     QStringList allProjectsFiles() const;
 
+    /**
+     * Resolve a symbol through the index of the project of the given file,
+     * or of the active project, if the file belongs to none.
+     * Each entry is a map with the keys name, file, line (1-based), kind and scope.
+     * Locations of the symbol itself come first, followed by those of symbols starting with the name, see KateProjectIndex::lookup().
+     * @param word word to look up, may be qualified like "Foo::bar"
+     * @param currentFile file the lookup is requested from, used for ranking
+     * @param definitionsOnly only return definitions, if any are known
+     * @return ranked locations, best first
+     */
+    Q_INVOKABLE QVariantList symbolLocations(const QString &word, const QString &currentFile, bool definitionsOnly = true) const;
+
     /**
      * the main window we belong to
      * @return our main window
@@ -144,6 +156,11 @@ private Q_SLOTS:
      */
     void slotProjectIndex();
 
+    /**
+     * Jump to the best ranked definition of the current word
+     */
+    void slotGotoDefinition();
+
 Q_SIGNALS:
     /**
      * Emitted if projectFileName changed.
@@ -155,6 +172,12 @@ Q_SIGNALS:
      */
     void projectMapChanged();
 
+    /**
+     * Emitted if projectFiles changed, either another project got active
+     * or the file list of the active project was reloaded.
+     */
+    void projectFilesChanged();
+
     /**
      * Emitted when a ctags lookup in requested
      * @param word lookup word
@@ -173,6 +196,11 @@ private Q_SLOTS:
      */
     void slotCurrentChanged(int index);
 
+    /**
+     * The file list of some project was reloaded.
+     */
+    void slotProjectModelChanged();
+
     /**
      * Url changed, to auto-load projects
      */
@@ -189,6 +217,16 @@ private:
      */
     QString currentWord() const;
 
+    /**
+     * current word including a scope qualifier in front of it, like "Foo::bar"
+     */
+    QString currentQualifiedWord() const;
+
+    /**
+     * project to use for lookups for the given file
+     */
+    KateProject *projectForLookup(const QString &file) const;
+
 private:
     /**
      * our plugin
@@ -250,6 +288,11 @@ private:
      * lookup action
      */
     QAction *m_lookupAction;
+
+    /**
+     * goto definition action
+     */
+    QAction *m_gotoDefinitionAction;
 };
 
 #endif
@@ -0,0 +1,375 @@
+/*  This file is part of the Kate project.
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "kateprojectsymboltrie.h"
+
+#include <QSet>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+KateProjectSymbolTrie::KateProjectSymbolTrie()
+{
+    /**
+     * root node, empty label
+     */
+    addNode(-1, 0, 0);
+}
+
+int KateProjectSymbolTrie::addNode(int labelSymbol, int labelStart, int labelLength)
+{
+    Node node;
+    node.labelSymbol = labelSymbol;
+    node.labelStart = labelStart;
+    node.labelLength = labelLength;
+    node.firstChild = -1;
+    node.nextSibling = -1;
+    node.symbol = -1;
+    node.best = 0;
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+int KateProjectSymbolTrie::findChild(int node, QChar c) const
+{
+    for (int child = m_nodes.at(node).firstChild; child >= 0; child = m_nodes.at(child).nextSibling) {
+        if (labelAt(m_nodes.at(child), 0) == c) {
+            return child;
+        }
+    }
+    return -1;
+}
+
+int KateProjectSymbolTrie::fileId(const QString &file)
+{
+    const auto it = m_fileIds.constFind(file);
+    if (it != m_fileIds.constEnd()) {
+        return it.value();
+    }
+
+    const int id = m_files.size();
+    m_files.append(file);
+    m_fileSymbols.append(QVector<int>());
+    m_fileIds.insert(file, id);
+    return id;
+}
+
+QStringRef KateProjectSymbolTrie::directoryOf(const QString &file)
+{
+    const int slash = file.lastIndexOf(QLatin1Char('/'));
+    return (slash < 0) ? QStringRef() : file.leftRef(slash);
+}
+
+int KateProjectSymbolTrie::insert(const QString &name, const QString &file)
+{
+    if (name.isEmpty()) {
+        return -1;
+    }
+
+    /**
+     * walk down, remember path to update the subtree maxima afterwards
+     */
+    QVarLengthArray<int, 64> path;
+    int node = 0;
+    int pos = 0;
+    while (true) {
+        path.append(node);
+
+        /**
+         * name fully consumed => this node represents the symbol
+         */
+        if (pos == name.size()) {
+            break;
+        }
+
+        /**
+         * no matching child => new leaf with the rest of the name as label
+         */
+        const int child = findChild(node, name.at(pos));
+        if (child < 0) {
+            Symbol symbol;
+            symbol.name = name;
+            symbol.count = 0;
+            symbol.fileId = -1;
+            symbol.lastFileId = -1;
+            m_symbols.append(symbol);
+
+            const int leaf = addNode(m_symbols.size() - 1, pos, name.size() - pos);
+            m_nodes[leaf].symbol = m_symbols.size() - 1;
+            m_nodes[leaf].nextSibling = m_nodes[node].firstChild;
+            m_nodes[node].firstChild = leaf;
+            node = leaf;
+            path.append(node);
+            break;
+        }
+
+        /**
+         * match the label of the child
+         */
+        const Node childNode = m_nodes.at(child);
+        int common = 1;
+        while (common < childNode.labelLength && pos + common < name.size() && labelAt(childNode, common) == name.at(pos + common)) {
+            ++common;
+        }
+
+        /**
+         * full label matched => descend
+         */
+        if (common == childNode.labelLength) {
+            node = child;
+            pos += common;
+            continue;
+        }
+
+        /**
+         * split the edge: new inner node takes the common part, child keeps the rest
+         */
+        const int mid = addNode(childNode.labelSymbol, childNode.labelStart, common);
+        m_nodes[mid].best = childNode.best;
+        m_nodes[mid].firstChild = child;
+        m_nodes[mid].nextSibling = childNode.nextSibling;
+        m_nodes[child].labelStart += common;
+        m_nodes[child].labelLength -= common;
+        m_nodes[child].nextSibling = -1;
+
+        /**
+         * replace child by mid in the sibling list of node
+         */
+        if (m_nodes.at(node).firstChild == child) {
+            m_nodes[node].firstChild = mid;
+        } else {
+            int prev = m_nodes.at(node).firstChild;
+            while (m_nodes.at(prev).nextSibling != child) {
+                prev = m_nodes.at(prev).nextSibling;
+            }
+            m_nodes[prev].nextSibling = mid;
+        }
+
+        node = mid;
+        pos += common;
+    }
+
+    /**
+     * node might be an inner node without symbol so far
+     */
+    if (m_nodes.at(node).symbol < 0) {
+        Symbol symbol;
+        symbol.name = name;
+        symbol.count = 0;
+        symbol.fileId = -1;
+        symbol.lastFileId = -1;
+        m_symbols.append(symbol);
+        m_nodes[node].symbol = m_symbols.size() - 1;
+    }
+
+    /**
+     * account this occurrence
+     */
+    const int symbolId = m_nodes.at(node).symbol;
+    Symbol &symbol = m_symbols[symbolId];
+    ++symbol.count;
+
+    const int fileIndex = fileId(file);
+    if (symbol.fileId < 0) {
+        symbol.fileId = fileIndex;
+    }
+
+    /**
+     * ctags output is grouped by file, remembering the last file avoids most duplicates
+     */
+    if (symbol.lastFileId != fileIndex) {
+        symbol.lastFileId = fileIndex;
+        m_fileSymbols[fileIndex].append(symbolId);
+    }
+
+    for (int i = 0; i < path.size(); ++i) {
+        Node &pathNode = m_nodes[path[i]];
+        pathNode.best = qMax(pathNode.best, symbol.count);
+    }
+
+    return symbolId;
+}
+
+int KateProjectSymbolTrie::find(const QString &name) const
+{
+    int node = 0;
+    int pos = 0;
+    while (pos < name.size()) {
+        node = findChild(node, name.at(pos));
+        if (node < 0) {
+            return -1;
+        }
+
+        const Node &current = m_nodes.at(node);
+        if (pos + current.labelLength > name.size()) {
+            return -1;
+        }
+        for (int i = 1; i < current.labelLength; ++i) {
+            if (labelAt(current, i) != name.at(pos + i)) {
+                return -1;
+            }
+        }
+        pos += current.labelLength;
+    }
+
+    return m_nodes.at(node).symbol;
+}
+
+int KateProjectSymbolTrie::findPrefixNode(const QString &prefix) const
+{
+    int node = 0;
+    int pos = 0;
+    while (pos < prefix.size()) {
+        node = findChild(node, prefix.at(pos));
+        if (node < 0) {
+            return -1;
+        }
+
+        const Node &current = m_nodes.at(node);
+        const int compare = qMin(current.labelLength, prefix.size() - pos);
+        for (int i = 1; i < compare; ++i) {
+            if (labelAt(current, i) != prefix.at(pos + i)) {
+                return -1;
+            }
+        }
+        pos += current.labelLength;
+    }
+    return node;
+}
+
+QVector<int> KateProjectSymbolTrie::symbolsWithPrefix(const QString &prefix) const
+{
+    QVector<int> result;
+    const int start = findPrefixNode(prefix);
+    if (start < 0) {
+        return result;
+    }
+
+    QVector<int> stack;
+    stack.append(start);
+    while (!stack.isEmpty()) {
+        const Node &current = m_nodes.at(stack.takeLast());
+        if (current.symbol >= 0) {
+            result.append(current.symbol);
+        }
+        for (int child = current.firstChild; child >= 0; child = m_nodes.at(child).nextSibling) {
+            stack.append(child);
+        }
+    }
+    return result;
+}
+
+QStringList KateProjectSymbolTrie::complete(const QString &prefix, int maxResults, const QString &currentFile) const
+{
+    QStringList result;
+    if (maxResults <= 0 || m_symbols.isEmpty()) {
+        return result;
+    }
+
+    /**
+     * walk down to the node covering the prefix
+     */
+    const int node = findPrefixNode(prefix);
+    if (node < 0) {
+        return result;
+    }
+
+    /**
+     * best-first traversal by subtree maximum: yields symbols by descending count,
+     * collect some more than requested to give proximity ranking a choice
+     * entries: (score, node), negative node encodes "emit symbol of node"
+     */
+    const int candidateLimit = maxResults * 2;
+    QVector<int> candidates;
+    std::priority_queue<std::pair<int, int>> queue;
+    queue.push(std::make_pair(m_nodes.at(node).best, node));
+    while (!queue.empty() && candidates.size() < candidateLimit) {
+        const std::pair<int, int> top = queue.top();
+        queue.pop();
+
+        if (top.second < 0) {
+            candidates.append(m_nodes.at(-top.second - 1).symbol);
+            continue;
+        }
+
+        const Node &current = m_nodes.at(top.second);
+        if (current.symbol >= 0) {
+            queue.push(std::make_pair(m_symbols.at(current.symbol).count, -top.second - 1));
+        }
+        for (int child = current.firstChild; child >= 0; child = m_nodes.at(child).nextSibling) {
+            queue.push(std::make_pair(m_nodes.at(child).best, child));
+        }
+    }
+
+    /**
+     * add matching symbols of the current file, they might have a low count
+     */
+    const int currentFileId = m_fileIds.value(currentFile, -1);
+    if (currentFileId >= 0) {
+        for (int symbol : m_fileSymbols.at(currentFileId)) {
+            if (m_symbols.at(symbol).name.startsWith(prefix)) {
+                candidates.append(symbol);
+            }
+        }
+    }
+
+    /**
+     * rank: current file, same directory, count, name
+     */
+    const QStringRef currentDirectory = directoryOf(currentFile);
+    auto proximity = [this, currentFileId, &currentDirectory](int symbol) {
+        const int file = m_symbols.at(symbol).fileId;
+        if (currentFileId >= 0 && (file == currentFileId || m_fileSymbols.at(currentFileId).contains(symbol))) {
+            return 2;
+        }
+        if (!currentDirectory.isEmpty() && file >= 0 && directoryOf(m_files.at(file)) == currentDirectory) {
+            return 1;
+        }
+        return 0;
+    };
+
+    QVector<std::pair<int, int>> ranked;
+    QSet<int> guard;
+    for (int symbol : qAsConst(candidates)) {
+        if (!guard.contains(symbol)) {
+            guard.insert(symbol);
+            ranked.append(std::make_pair(proximity(symbol), symbol));
+        }
+    }
+
+    std::sort(ranked.begin(), ranked.end(), [this](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+        const Symbol &sa = m_symbols.at(a.second);
+        const Symbol &sb = m_symbols.at(b.second);
+        if (sa.count != sb.count) {
+            return sa.count > sb.count;
+        }
+        return sa.name < sb.name;
+    });
+
+    for (int i = 0; i < ranked.size() && i < maxResults; ++i) {
+        result.append(m_symbols.at(ranked.at(i).second).name);
+    }
+    return result;
+}
@@ -0,0 +1,189 @@
+/*  This file is part of the Kate project.
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_PROJECT_SYMBOL_TRIE_H
+#define KATE_PROJECT_SYMBOL_TRIE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Compact in-memory prefix trie over the symbol names of a project index.
+ *
+ * The trie is a radix trie: edge labels are not stored, they reference
+ * slices of the interned symbol names. Each node knows the highest
+ * frequency inside its subtree, that allows to extract the top ranked
+ * completions for a prefix without visiting all matching symbols.
+ *
+ * Not thread-safe, the owning index guards the access.
+ */
+class KateProjectSymbolTrie
+{
+public:
+    /**
+     * construct empty trie
+     */
+    KateProjectSymbolTrie();
+
+    /**
+     * Add one occurrence of a symbol, e.g. one ctags entry.
+     * @param name symbol name
+     * @param file file the symbol occurs in
+     * @return symbol id of the (interned) name
+     */
+    int insert(const QString &name, const QString &file);
+
+    /**
+     * Exact lookup of a symbol.
+     * @param name symbol name
+     * @return symbol id or -1 if not known
+     */
+    int find(const QString &name) const;
+
+    /**
+     * All symbols starting with the given prefix, unordered.
+     * @param prefix prefix to search, case sensitive
+     * @return symbol ids
+     */
+    QVector<int> symbolsWithPrefix(const QString &prefix) const;
+
+    /**
+     * Name of a symbol.
+     * @param symbol symbol id
+     * @return name of the symbol
+     */
+    const QString &name(int symbol) const {
+        return m_symbols.at(symbol).name;
+    }
+
+    /**
+     * Find best completions for given prefix.
+     * Ranking: symbols defined in the current file first, then symbols from
+     * the same directory, then by occurrence count.
+     * @param prefix prefix to complete, case sensitive
+     * @param maxResults maximal number of returned names
+     * @param currentFile file the completion is requested in, may be empty
+     * @return ranked list of symbol names
+     */
+    QStringList complete(const QString &prefix, int maxResults, const QString &currentFile = QString()) const;
+
+    /**
+     * Number of unique symbols.
+     * @return symbol count
+     */
+    int symbolCount() const {
+        return m_symbols.size();
+    }
+
+    /**
+     * Is this trie empty?
+     * @return true if no symbols inserted
+     */
+    bool isEmpty() const {
+        return m_symbols.isEmpty();
+    }
+
+private:
+    /**
+     * One node of the radix trie.
+     * Label is the slice [labelStart, labelStart + labelLength) of the name of symbol labelSymbol.
+     */
+    struct Node {
+        int labelSymbol;
+        int labelStart;
+        int labelLength;
+        int firstChild;
+        int nextSibling;
+        int symbol;
+        int best;
+    };
+
+    /**
+     * One unique symbol.
+     */
+    struct Symbol {
+        QString name;
+        int count;
+        int fileId;
+        int lastFileId;
+    };
+
+    /**
+     * Find child of node starting with the given character.
+     * @return child node index or -1
+     */
+    int findChild(int node, QChar c) const;
+
+    /**
+     * Find the node covering the given prefix.
+     * @return node index or -1 if no symbol has this prefix
+     */
+    int findPrefixNode(const QString &prefix) const;
+
+    /**
+     * Access character at given offset of the node label.
+     */
+    QChar labelAt(const Node &node, int offset) const {
+        return m_symbols.at(node.labelSymbol).name.at(node.labelStart + offset);
+    }
+
+    /**
+     * Add a new node.
+     * @return index of new node
+     */
+    int addNode(int labelSymbol, int labelStart, int labelLength);
+
+    /**
+     * Intern a file path.
+     * @return file id
+     */
+    int fileId(const QString &file);
+
+    /**
+     * Directory part of a file path, empty if none.
+     */
+    static QStringRef directoryOf(const QString &file);
+
+private:
+    /**
+     * all nodes, node 0 is the root
+     */
+    QVector<Node> m_nodes;
+
+    /**
+     * all unique symbols
+     */
+    QVector<Symbol> m_symbols;
+
+    /**
+     * interned file names
+     */
+    QHash<QString, int> m_fileIds;
+    QVector<QString> m_files;
+
+    /**
+     * symbols per file id, to rank symbols of the current file high
+     */
+    QVector<QVector<int>> m_fileSymbols;
+};
+
+#endif
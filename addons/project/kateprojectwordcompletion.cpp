@@ -0,0 +1,276 @@
+/*  This file is part of the Kate project.
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "kateprojectwordcompletion.h"
+
+#include <ktexteditor/document.h>
+
+#include <klocalizedstring.h>
+
+#include <ThreadWeaver/Job>
+#include <ThreadWeaver/Queue>
+
+#include <QIcon>
+
+/**
+ * maximal number of completions shown
+ */
+static const int MaxCompletionResults = 250;
+
+/**
+ * Job applying the queued document changes to the word index.
+ */
+class KateProjectWordIndexJob : public ThreadWeaver::Job
+{
+public:
+    explicit KateProjectWordIndexJob(KateProjectWordIndex *index)
+        : m_index(index)
+    {
+    }
+
+    void run(ThreadWeaver::JobPointer, ThreadWeaver::Thread *) override
+    {
+        m_index->processPending();
+    }
+
+private:
+    KateProjectWordIndex *m_index;
+};
+
+KateProjectWordCompletion::KateProjectWordCompletion(ThreadWeaver::Queue *weaver)
+    : KTextEditor::CodeCompletionModel(nullptr)
+    , m_weaver(weaver)
+    , m_automatic(false)
+{
+}
+
+KateProjectWordCompletion::~KateProjectWordCompletion()
+{
+}
+
+void KateProjectWordCompletion::registerDocument(KTextEditor::Document *document)
+{
+    connect(document, &KTextEditor::Document::textInserted, this, &KateProjectWordCompletion::slotTextInserted);
+    connect(document, &KTextEditor::Document::textRemoved, this, &KateProjectWordCompletion::slotTextRemoved);
+    connect(document, &KTextEditor::Document::reloaded, this, &KateProjectWordCompletion::slotDocumentReset);
+    connect(document, &KTextEditor::Document::destroyed, this, &KateProjectWordCompletion::slotDocumentDestroyed);
+
+    /**
+     * loading a file doesn't emit textInserted, take the complete text once loading is done
+     */
+    connect(document, &KParts::ReadOnlyPart::completed, this, [this, document]() {
+        slotDocumentReset(document);
+    });
+
+    slotDocumentReset(document);
+}
+
+void KateProjectWordCompletion::scheduleUpdate(bool needed)
+{
+    if (needed) {
+        m_weaver->stream() << new KateProjectWordIndexJob(&m_index);
+    }
+}
+
+void KateProjectWordCompletion::slotTextInserted(KTextEditor::Document *document, const KTextEditor::Cursor &position, const QString &text)
+{
+    /**
+     * compute old and new content of the touched lines, to get the words at the borders right
+     */
+    const int newLines = text.count(QLatin1Char('\n'));
+    const int endLine = position.line() + newLines;
+    const int endColumn = newLines ? (text.size() - text.lastIndexOf(QLatin1Char('\n')) - 1) : (position.column() + text.size());
+
+    QString newText = document->line(position.line());
+    for (int line = position.line() + 1; line <= endLine; ++line) {
+        newText += QLatin1Char('\n') + document->line(line);
+    }
+
+    const QString oldText = document->line(position.line()).left(position.column()) + document->line(endLine).mid(endColumn);
+    scheduleUpdate(m_index.queueChange(document, oldText, newText));
+}
+
+void KateProjectWordCompletion::slotTextRemoved(KTextEditor::Document *document, const KTextEditor::Range &range, const QString &oldText)
+{
+    /**
+     * the touched lines are joined into the start line now
+     */
+    const QString line = document->line(range.start().line());
+    const int column = qMin(range.start().column(), line.size());
+    scheduleUpdate(m_index.queueChange(document, line.left(column) + oldText + line.mid(column), line));
+}
+
+void KateProjectWordCompletion::slotDocumentReset(KTextEditor::Document *document)
+{
+    scheduleUpdate(m_index.queueReset(document, document->text()));
+}
+
+void KateProjectWordCompletion::slotDocumentDestroyed(QObject *document)
+{
+    scheduleUpdate(m_index.queueReset(document, QString()));
+}
+
+QVariant KateProjectWordCompletion::data(const QModelIndex &index, int role) const
+{
+    if (role == InheritanceDepth) {
+        return 10020;    //Even higher than the project completion, these are plain words
+    }
+
+    if (!index.parent().isValid()) {
+        //It is the group header
+        switch (role) {
+        case Qt::DisplayRole:
+            return i18n("Open Documents Word Completion");
+        case GroupRole:
+            return Qt::DisplayRole;
+        }
+    }
+
+    if (index.column() == KTextEditor::CodeCompletionModel::Name && role == Qt::DisplayRole) {
+        return m_matches.at(index.row());
+    }
+
+    if (index.column() == KTextEditor::CodeCompletionModel::Icon && role == Qt::DecorationRole) {
+        static QIcon icon(QIcon::fromTheme(QStringLiteral("insert-text")).pixmap(QSize(16, 16)));
+        return icon;
+    }
+
+    return QVariant();
+}
+
+QModelIndex KateProjectWordCompletion::parent(const QModelIndex &index) const
+{
+    if (index.internalId()) {
+        return createIndex(0, 0, quintptr(0));
+    } else {
+        return QModelIndex();
+    }
+}
+
+QModelIndex KateProjectWordCompletion::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        if (row == 0) {
+            return createIndex(row, column, quintptr(0));
+        } else {
+            return QModelIndex();
+        }
+
+    } else if (parent.parent().isValid()) {
+        return QModelIndex();
+    }
+
+    if (row < 0 || row >= m_matches.size() || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    return createIndex(row, column, 1);
+}
+
+int KateProjectWordCompletion::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid() && !(m_matches.size() == 0)) {
+        return 1;    //One root node to define the custom group
+    } else if (parent.parent().isValid()) {
+        return 0;    //Completion-items have no children
+    } else {
+        return m_matches.size();
+    }
+}
+
+bool KateProjectWordCompletion::shouldStartCompletion(KTextEditor::View *view, const QString &insertedText, bool userInsertion, const KTextEditor::Cursor &position)
+{
+    if (!userInsertion) {
+        return false;
+    }
+    if (insertedText.isEmpty()) {
+        return false;
+    }
+
+    const QString text = view->document()->line(position.line()).left(position.column());
+
+    const int check = 3; //v->config()->wordCompletionMinimalWordLength();
+    const int start = text.length();
+    const int end = text.length() - check;
+    if (end < 0) {
+        return false;
+    }
+    for (int i = start - 1; i >= end; i--) {
+        QChar c = text.at(i);
+        if (!(c.isLetter() || (c.isNumber()) || c == QLatin1Char('_'))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool KateProjectWordCompletion::shouldAbortCompletion(KTextEditor::View *view, const KTextEditor::Range &range, const QString &currentCompletion)
+{
+    if (m_automatic) {
+        if (currentCompletion.length() < 3 /*v->config()->wordCompletionMinimalWordLength()*/) {
+            return true;
+        }
+    }
+
+    return CodeCompletionModelControllerInterface::shouldAbortCompletion(view, range, currentCompletion);
+}
+
+void KateProjectWordCompletion::completionInvoked(KTextEditor::View *view, const KTextEditor::Range &range, InvocationType it)
+{
+    /**
+     * auto invoke only for long enough words
+     */
+    m_automatic = (it == AutomaticInvocation);
+    if (m_automatic && range.columnWidth() < 3 /*v->config()->wordCompletionMinimalWordLength()*/) {
+        m_matches.clear();
+        return;
+    }
+
+    /**
+     * just a lookup in the index, no document is scanned here
+     */
+    m_matches = m_index.matches(view->document()->text(range), MaxCompletionResults);
+}
+
+KTextEditor::CodeCompletionModelControllerInterface::MatchReaction KateProjectWordCompletion::matchingItem(const QModelIndex & /*matched*/)
+{
+    return HideListIfAutomaticInvocation;
+}
+
+// Return the range containing the word left of the cursor
+KTextEditor::Range KateProjectWordCompletion::completionRange(KTextEditor::View *view, const KTextEditor::Cursor &position)
+{
+    int line = position.line();
+    int col = position.column();
+
+    KTextEditor::Document *doc = view->document();
+    while (col > 0) {
+        QChar c = (doc->characterAt(KTextEditor::Cursor(line, col - 1)));
+        if (c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_')) {
+            col--;
+            continue;
+        }
+
+        break;
+    }
+
+    return KTextEditor::Range(KTextEditor::Cursor(line, col), position);
+}
@@ -0,0 +1,114 @@
+/*  This file is part of the Kate project.
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_PROJECT_WORD_COMPLETION_H
+#define KATE_PROJECT_WORD_COMPLETION_H
+
+#include "kateprojectwordindex.h"
+
+#include <ktexteditor/view.h>
+#include <ktexteditor/codecompletionmodel.h>
+#include <ktexteditor/codecompletionmodelcontrollerinterface.h>
+
+#include <QStringList>
+
+namespace ThreadWeaver {
+class Queue;
+}
+
+/**
+ * Word completion over all open documents.
+ * Backed by an incrementally updated word index, the documents are
+ * never scanned when the completion is invoked.
+ */
+class KateProjectWordCompletion : public KTextEditor::CodeCompletionModel, public KTextEditor::CodeCompletionModelControllerInterface
+{
+    Q_OBJECT
+
+    Q_INTERFACES(KTextEditor::CodeCompletionModelControllerInterface)
+
+public:
+    /**
+     * Construct word completion.
+     * @param weaver queue to run the index updates in
+     */
+    KateProjectWordCompletion(ThreadWeaver::Queue *weaver);
+
+    /**
+     * Deconstruct word completion.
+     */
+    ~KateProjectWordCompletion() override;
+
+    /**
+     * Start to track the given document.
+     * @param document new document
+     */
+    void registerDocument(KTextEditor::Document *document);
+
+    void completionInvoked(KTextEditor::View *view, const KTextEditor::Range &range, InvocationType invocationType) override;
+
+    bool shouldStartCompletion(KTextEditor::View *view, const QString &insertedText, bool userInsertion, const KTextEditor::Cursor &position) override;
+    bool shouldAbortCompletion(KTextEditor::View *view, const KTextEditor::Range &range, const QString &currentCompletion) override;
+
+    int rowCount(const QModelIndex &parent) const override;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &index) const override;
+    MatchReaction matchingItem(const QModelIndex &matched) override;
+
+    KTextEditor::Range completionRange(KTextEditor::View *view, const KTextEditor::Cursor &position) override;
+
+private Q_SLOTS:
+    void slotTextInserted(KTextEditor::Document *document, const KTextEditor::Cursor &position, const QString &text);
+    void slotTextRemoved(KTextEditor::Document *document, const KTextEditor::Range &range, const QString &oldText);
+    void slotDocumentReset(KTextEditor::Document *document);
+    void slotDocumentDestroyed(QObject *document);
+
+private:
+    /**
+     * Trigger a background update run if needed.
+     * @param needed result of the queue call
+     */
+    void scheduleUpdate(bool needed);
+
+private:
+    /**
+     * queue to run index updates
+     */
+    ThreadWeaver::Queue *m_weaver;
+
+    /**
+     * word index over all open documents
+     */
+    KateProjectWordIndex m_index;
+
+    /**
+     * ranked matching words
+     */
+    QStringList m_matches;
+
+    /**
+     * automatic invocation?
+     */
+    bool m_automatic;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*  This file is part of the Kate project.
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "kateprojectwordindex.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * shorter words are not worth completing, same limit as automatic completion uses
+ */
+static const int MinimalWordLength = 3;
+
+KateProjectWordIndex::KateProjectWordIndex()
+{
+}
+
+bool KateProjectWordIndex::queueChange(const QObject *document, const QString &oldText, const QString &newText)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    const bool wasEmpty = m_pending.isEmpty();
+    Change change;
+    change.document = document;
+    change.reset = false;
+    change.oldText = oldText;
+    change.newText = newText;
+    m_pending.append(change);
+    return wasEmpty;
+}
+
+bool KateProjectWordIndex::queueReset(const QObject *document, const QString &text)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    const bool wasEmpty = m_pending.isEmpty();
+    Change change;
+    change.document = document;
+    change.reset = true;
+    change.newText = text;
+    m_pending.append(change);
+    return wasEmpty;
+}
+
+void KateProjectWordIndex::processPending()
+{
+    QMutexLocker processLocker(&m_processMutex);
+    while (true) {
+        /**
+         * take all queued changes, the GUI thread can continue to queue new ones
+         */
+        QVector<Change> changes;
+        {
+            QMutexLocker locker(&m_pendingMutex);
+            if (m_pending.isEmpty()) {
+                return;
+            }
+            changes.swap(m_pending);
+        }
+
+        for (const Change &change : qAsConst(changes)) {
+            /**
+             * tokenize without holding the words lock
+             */
+            QHash<QString, int> delta;
+            countWords(change.oldText, -1, delta);
+            countWords(change.newText, +1, delta);
+
+            QMutexLocker locker(&m_wordsMutex);
+            if (change.reset) {
+                /**
+                 * drop old content of this document first
+                 */
+                QHash<QString, int> removal = m_documentWords.value(change.document);
+                for (auto it = removal.begin(); it != removal.end(); ++it) {
+                    it.value() = -it.value();
+                }
+                applyDelta(change.document, removal);
+            }
+            applyDelta(change.document, delta);
+        }
+    }
+}
+
+void KateProjectWordIndex::applyDelta(const QObject *document, const QHash<QString, int> &delta)
+{
+    QHash<QString, int> &documentWords = m_documentWords[document];
+    for (auto it = delta.constBegin(); it != delta.constEnd(); ++it) {
+        if (!it.value()) {
+            continue;
+        }
+
+        /**
+         * per document count
+         */
+        auto docIt = documentWords.find(it.key());
+        if (docIt == documentWords.end()) {
+            docIt = documentWords.insert(it.key(), 0);
+        }
+        docIt.value() += it.value();
+        if (docIt.value() <= 0) {
+            documentWords.erase(docIt);
+        }
+
+        /**
+         * global count
+         */
+        auto globalIt = m_words.find(it.key());
+        if (globalIt == m_words.end()) {
+            globalIt = m_words.insert(it.key(), 0);
+        }
+        globalIt.value() += it.value();
+        if (globalIt.value() <= 0) {
+            m_words.erase(globalIt);
+        }
+    }
+
+    if (documentWords.isEmpty()) {
+        m_documentWords.remove(document);
+    }
+}
+
+QStringList KateProjectWordIndex::matches(const QString &prefix, int maxResults) const
+{
+    QVector<std::pair<int, QString>> ranked;
+    {
+        QMutexLocker locker(&m_wordsMutex);
+        for (auto it = m_words.lowerBound(prefix); it != m_words.constEnd() && it.key().startsWith(prefix); ++it) {
+            if (it.key().size() > prefix.size()) {
+                ranked.append(std::make_pair(it.value(), it.key()));
+            }
+        }
+    }
+
+    /**
+     * most frequent first, keep alphabetical order for same count
+     */
+    const int resultCount = qMin(maxResults, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + resultCount, ranked.end(), [](const std::pair<int, QString> &a, const std::pair<int, QString> &b) {
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+        return a.second < b.second;
+    });
+
+    QStringList result;
+    result.reserve(resultCount);
+    for (int i = 0; i < resultCount; ++i) {
+        result.append(ranked.at(i).second);
+    }
+    return result;
+}
+
+int KateProjectWordIndex::count(const QString &word) const
+{
+    QMutexLocker locker(&m_wordsMutex);
+    return m_words.value(word, 0);
+}
+
+void KateProjectWordIndex::countWords(const QString &text, int sign, QHash<QString, int> &counts)
+{
+    const int size = text.size();
+    int start = -1;
+    for (int i = 0; i <= size; ++i) {
+        const bool wordChar = (i < size) && (text.at(i).isLetterOrNumber() || text.at(i) == QLatin1Char('_'));
+        if (wordChar) {
+            if (start < 0) {
+                start = i;
+            }
+            continue;
+        }
+
+        /**
+         * word ended, skip too short ones and numbers
+         */
+        if (start >= 0 && (i - start) >= MinimalWordLength && !text.at(start).isDigit()) {
+            counts[text.mid(start, i - start)] += sign;
+        }
+        start = -1;
+    }
+}
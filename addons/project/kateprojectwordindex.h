@@ -0,0 +1,146 @@
+/*  This file is part of the Kate project.
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_PROJECT_WORD_INDEX_H
+#define KATE_PROJECT_WORD_INDEX_H
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QObject;
+
+/**
+ * Identifier frequency index over all open documents.
+ *
+ * The GUI thread only queues cheap text snapshots of the changed lines,
+ * the tokenizing and counting is done by processPending(), which is meant
+ * to run in a background thread. Queries are answered from the sorted
+ * global word map, no document is scanned for a completion request.
+ */
+class KateProjectWordIndex
+{
+public:
+    /**
+     * construct empty index
+     */
+    KateProjectWordIndex();
+
+    /**
+     * Queue a change of a document.
+     * Words in oldText are removed, words in newText are added.
+     * Both texts should cover complete lines, to get the word boundaries right.
+     * @param document document the change belongs to
+     * @param oldText old text of the touched lines
+     * @param newText new text of the touched lines
+     * @return true if the queue was empty before, caller must trigger processPending()
+     */
+    bool queueChange(const QObject *document, const QString &oldText, const QString &newText);
+
+    /**
+     * Queue a complete reset of the document content, e.g. after loading.
+     * @param document document to reset
+     * @param text new complete text, empty to drop the document
+     * @return true if the queue was empty before, caller must trigger processPending()
+     */
+    bool queueReset(const QObject *document, const QString &text);
+
+    /**
+     * Apply all queued changes. Thread-safe, meant to be run in a worker thread.
+     */
+    void processPending();
+
+    /**
+     * Get words starting with the given prefix, most frequent first.
+     * Thread-safe.
+     * @param prefix prefix to complete, case sensitive, the prefix itself is never returned
+     * @param maxResults maximal number of results
+     * @return ranked list of words
+     */
+    QStringList matches(const QString &prefix, int maxResults) const;
+
+    /**
+     * Occurrence count of a word over all documents. Thread-safe.
+     * @param word word to look up
+     * @return count, 0 if unknown
+     */
+    int count(const QString &word) const;
+
+    /**
+     * Split text into identifiers and account them with the given sign.
+     * @param text text to tokenize
+     * @param sign +1 to add, -1 to remove
+     * @param counts word => count delta map to update
+     */
+    static void countWords(const QString &text, int sign, QHash<QString, int> &counts);
+
+private:
+    /**
+     * Apply a word => count delta to the tables of one document and the global table.
+     * Caller must hold m_wordsMutex.
+     */
+    void applyDelta(const QObject *document, const QHash<QString, int> &delta);
+
+private:
+    /**
+     * One queued change.
+     */
+    struct Change {
+        const QObject *document;
+        bool reset;
+        QString oldText;
+        QString newText;
+    };
+
+    /**
+     * serializes processPending(), resets must be applied in queue order
+     */
+    QMutex m_processMutex;
+
+    /**
+     * guards m_pending
+     */
+    QMutex m_pendingMutex;
+
+    /**
+     * changes not yet applied
+     */
+    QVector<Change> m_pending;
+
+    /**
+     * guards the word tables
+     */
+    mutable QMutex m_wordsMutex;
+
+    /**
+     * global word => count, sorted for prefix lookups
+     */
+    QMap<QString, int> m_words;
+
+    /**
+     * per document word => count, needed to drop or reset a document
+     */
+    QHash<const QObject *, QHash<QString, int>> m_documentWords;
+};
+
+#endif
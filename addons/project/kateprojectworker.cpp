@@ -471,11 +471,21 @@ QStringList KateProjectWorker::filesFromDirectory(const QDir &_dir, bool recursi
 void KateProjectWorker::loadIndex(const QStringList &files)
 {
     /**
-     * create new index, this will do the loading in the constructor
-     * wrap it into shared pointer for transfer to main thread
+     * create new index, wrap it into shared pointer for transfer to main thread
+     * it is handed out once: when streaming as soon as ctags runs, it is filled progressively,
+     * else once it is complete
      */
     const QString keyCtags = QStringLiteral("ctags");
-    KateProjectSharedProjectIndex index(new KateProjectIndex(files, m_projectMap[keyCtags].toMap()));
-
-    emit loadIndexDone(index);
+    KateProjectSharedProjectIndex index(new KateProjectIndex());
+    bool handedOut = false;
+    index->loadCtags(files, m_projectMap[keyCtags].toMap(), [this, index, &handedOut]() {
+        handedOut = true;
+        emit loadIndexDone(index);
+    });
+
+    if (handedOut) {
+        emit loadIndexFinished(index);
+    } else {
+        emit loadIndexDone(index);
+    }
 }
@@ -53,6 +53,11 @@ Q_SIGNALS:
     void loadDone(KateProjectSharedQStandardItem topLevel, KateProjectSharedQMapStringItem file2Item);
     void loadIndexDone(KateProjectSharedProjectIndex index);
 
+    /**
+     * the index handed out by loadIndexDone() while loading is complete now
+     */
+    void loadIndexFinished(KateProjectSharedProjectIndex index);
+
 private:
     /**
      * Load one project inside the project tree.
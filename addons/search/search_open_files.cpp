@@ -20,7 +20,11 @@
 
 #include "search_open_files.h"
 
+#include <ktexteditor/application.h>
+#include <ktexteditor/editor.h>
+
 #include <QTime>
+#include <QUrl>
 
 SearchOpenFiles::SearchOpenFiles(QObject *parent) : QObject(parent), m_nextIndex(-1), m_cancelSearch(true)
 {
@@ -77,6 +81,12 @@ void SearchOpenFiles::doSearchNextFile(int startLine)
 
 int SearchOpenFiles::searchOpenFile(KTextEditor::Document *doc, const QRegularExpression &regExp, int startLine)
 {
+    // documents of a lazily restored session are empty until loaded, load them one by one as we get to them
+    const QUrl pendingUrl = doc->property("pendingUrl").toUrl();
+    if (startLine == 0 && !pendingUrl.isEmpty()) {
+        KTextEditor::Editor::instance()->application()->openUrl(pendingUrl);
+    }
+
     if (m_statusTime.elapsed() > 100) {
         m_statusTime.restart();
         emit searching(doc->url().toString());
@@ -21,6 +21,8 @@
 #include "tabswitchertest.h"
 #include "tabswitcherfilesmodel.h"
 
+#include <QFileInfo>
+#include <QSignalSpy>
 #include <QTest>
 
 QTEST_MAIN(KateTabSwitcherTest)
@@ -75,3 +77,114 @@ void KateTabSwitcherTest::testLongestCommonPrefix_data()
     strs.push_back(QStringLiteral("a"));
     QTest::newRow("two equal strings") << strs << QStringLiteral("a");
 }
+
+/**
+ * display prefixes computed from scratch for all rows
+ */
+static QStringList referencePrefixes(detail::TabswitcherFilesModel & model)
+{
+    std::vector<QString> paths;
+    for (int i = 0; i < model.rowCount(); ++i) {
+        if (!model.item(i)->fullPath.isEmpty()) {
+            paths.push_back(model.item(i)->fullPath);
+        }
+    }
+
+    int prefix_length = detail::longestCommonPrefix(paths).length();
+    if (prefix_length == 1) {
+        prefix_length = 0;
+    }
+
+    QStringList prefixes;
+    for (int i = 0; i < model.rowCount(); ++i) {
+        const QString & fullPath = model.item(i)->fullPath;
+        const int len = fullPath.length() - prefix_length - QFileInfo(fullPath).fileName().length() - 1;
+        prefixes << (len > 0 ? fullPath.mid(prefix_length, len) : QString());
+    }
+    return prefixes;
+}
+
+static QStringList displayPrefixes(detail::TabswitcherFilesModel & model)
+{
+    QStringList prefixes;
+    for (int i = 0; i < model.rowCount(); ++i) {
+        prefixes << model.item(i)->displayPathPrefix;
+    }
+    return prefixes;
+}
+
+void KateTabSwitcherTest::testDisplayPathPrefix()
+{
+    detail::TabswitcherFilesModel model;
+
+    const QStringList paths = {
+        QStringLiteral("/home/user/project/src/main.cpp"),
+        QStringLiteral("/home/user/project/src/util/util.cpp"),
+        QString(),
+        QStringLiteral("/home/user/project/README.md"),
+        QStringLiteral("/home/user/other/notes.txt"),
+        QStringLiteral("/etc/fstab"),
+        QStringLiteral("/home/user/project/src/util/util.h"),
+    };
+
+    for (const QString & path : paths) {
+        model.insertRow(0, detail::FilenameListItem(nullptr, QFileInfo(path).fileName(), path));
+        QCOMPARE(displayPrefixes(model), referencePrefixes(model));
+    }
+
+    // grow the prefix again, the bounding paths go first
+    const QStringList removals = {
+        QStringLiteral("/etc/fstab"),
+        QStringLiteral("/home/user/other/notes.txt"),
+        QStringLiteral("/home/user/project/README.md"),
+        QString(),
+        QStringLiteral("/home/user/project/src/main.cpp"),
+    };
+
+    for (const QString & path : removals) {
+        for (int i = 0; i < model.rowCount(); ++i) {
+            if (model.item(i)->fullPath == path) {
+                model.removeRow(i);
+                break;
+            }
+        }
+        QCOMPARE(displayPrefixes(model), referencePrefixes(model));
+    }
+
+    QCOMPARE(displayPrefixes(model), QStringList({QString(), QString()}));
+
+    // renames
+    model.updateItem(model.item(0), QStringLiteral("a.cpp"), QStringLiteral("/home/user/project/src/a.cpp"));
+    QCOMPARE(displayPrefixes(model), referencePrefixes(model));
+    QCOMPARE(model.item(0)->displayPathPrefix, QString());
+    QCOMPARE(model.item(1)->displayPathPrefix, QStringLiteral("util"));
+
+    model.updateItem(model.item(1), QStringLiteral("b.cpp"), QStringLiteral("/home/user/project/src/b.cpp"));
+    QCOMPARE(displayPrefixes(model), referencePrefixes(model));
+
+    model.clear();
+    model.insertRow(0, detail::FilenameListItem(nullptr, QStringLiteral("c.cpp"), QStringLiteral("/tmp/x/c.cpp")));
+    QCOMPARE(displayPrefixes(model), referencePrefixes(model));
+}
+
+void KateTabSwitcherTest::testMoveToFront()
+{
+    detail::TabswitcherFilesModel model;
+    for (int i = 0; i < 5; ++i) {
+        const QString name = QStringLiteral("%1.txt").arg(i);
+        model.insertRow(0, detail::FilenameListItem(nullptr, name, QStringLiteral("/tmp/") + name));
+    }
+
+    QSignalSpy moved(&model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+
+    QVERIFY(model.moveToFront(3));
+    QVERIFY(model.moveToFront(0));
+    QVERIFY(!model.moveToFront(5));
+    QCOMPARE(moved.count(), 1);
+
+    QStringList names;
+    for (int i = 0; i < model.rowCount(); ++i) {
+        names << model.item(i)->documentName;
+    }
+    QCOMPARE(names, QStringList({QStringLiteral("1.txt"), QStringLiteral("4.txt"), QStringLiteral("3.txt"), QStringLiteral("2.txt"), QStringLiteral("0.txt")}));
+}
@@ -33,5 +33,7 @@ public Q_SLOTS:
 private Q_SLOTS:
     void testLongestCommonPrefix();
     void testLongestCommonPrefix_data();
+    void testDisplayPathPrefix();
+    void testMoveToFront();
 };
 
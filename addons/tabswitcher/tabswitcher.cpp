@@ -174,7 +174,7 @@ void TabSwitcherPluginView::updateDocumentName(KTextEditor::Document * document)
     for (int i = 0; i < rowCount; ++i) {
         auto doc = m_model->item(i)->document;
         if (doc == document) {
-            m_model->updateItem(m_model->item(i), document->documentName(), document->url().toLocalFile());
+            m_model->updateItem(m_model->item(i), detail::documentName(document), detail::documentUrl(document).toLocalFile());
             //m_model->item(i)->setText(document->documentName());
             break;
         }
@@ -187,8 +187,14 @@ void TabSwitcherPluginView::raiseView(KTextEditor::View * view)
         return;
     }
 
-    unregisterDocument(view->document());
-    registerDocument(view->document());
+    // most recently used documents are at the front, look there first
+    const auto rowCount = m_model->rowCount();
+    for (int i = 0; i < rowCount; ++i) {
+        if (m_model->item(i)->document == view->document()) {
+            m_model->moveToFront(i);
+            break;
+        }
+    }
 }
 
 void TabSwitcherPluginView::walk(const int from, const int to)
@@ -22,7 +22,6 @@
 
 #include <QDebug>
 #include <QBrush>
-#include <QFileInfo>
 #include <QMimeDatabase>
 
 #include <KTextEditor/Document>
@@ -31,16 +30,44 @@
 
 namespace detail
 {
+    QUrl documentUrl(KTextEditor::Document * doc)
+    {
+        const QUrl pendingUrl = doc->property("pendingUrl").toUrl();
+        return pendingUrl.isEmpty() ? doc->url() : pendingUrl;
+    }
+
+    QString documentName(KTextEditor::Document * doc)
+    {
+        const QUrl pendingUrl = doc->property("pendingUrl").toUrl();
+        return pendingUrl.isEmpty() ? doc->documentName() : pendingUrl.fileName();
+    }
+
     static QIcon iconForDocument(KTextEditor::Document * doc)
     {
-        return QIcon::fromTheme(QMimeDatabase().mimeTypeForUrl(doc->url()).iconName());
+        return QIcon::fromTheme(QMimeDatabase().mimeTypeForUrl(documentUrl(doc)).iconName());
+    }
+
+    static int basenameOffset(const QString & fullPath)
+    {
+        // Note that item.documentName can contain additional characters - e.g. "README.md (2)" -
+        // so we cannot use that and have to parse the base filename by other means
+        return fullPath.lastIndexOf(QLatin1Char('/')) + 1;
     }
 
     FilenameListItem::FilenameListItem(KTextEditor::Document* doc)
         : document(doc)
         , icon(iconForDocument(doc))
-        , documentName(doc->documentName())
-        , fullPath(doc->url().toLocalFile())
+        , documentName(detail::documentName(doc))
+        , fullPath(documentUrl(doc).toLocalFile())
+        , basenameOffset(detail::basenameOffset(fullPath))
+    {
+    }
+
+    FilenameListItem::FilenameListItem(KTextEditor::Document* doc, QString const & documentName, QString const & fullPath)
+        : document(doc)
+        , documentName(documentName)
+        , fullPath(fullPath)
+        , basenameOffset(detail::basenameOffset(fullPath))
     {
     }
 
@@ -72,38 +99,9 @@ namespace detail
         return QStringRef(&strs[0], 0, n).toString();
     }
 
-    void post_process(FilenameList & data)
+    static QChar charAt(const QString & path, int pos)
     {
-        std::vector<QString> paths;
-        std::for_each(data.begin(), data.end(),
-                    [&paths](FilenameListItem & item) { paths.push_back(item.fullPath); });
-
-        // Removes empty strings because Documents without file have no path and we would
-        // otherwise in this case always get ""
-        paths.erase( // erase-remove idiom, see https://en.cppreference.com/w/cpp/algorithm/remove
-            std::remove_if(paths.begin(), paths.end(), [](const QString &s) {
-                return s.isEmpty(); }),
-            paths.end()
-        );
-        QString prefix = longestCommonPrefix(paths);
-        int prefix_length = prefix.length();
-        if (prefix_length == 1) { // if there is only the "/" at the beginning, then keep it
-            prefix_length = 0;
-        }
-
-        std::for_each(data.begin(), data.end(),
-                        [prefix_length](FilenameListItem & item) {
-                            // Note that item.documentName can contain additional characters - e.g. "README.md (2)" -
-                            // so we cannot use that and have to parse the base filename by other means:
-                            QFileInfo fileinfo(item.fullPath);
-                            QString basename = fileinfo.fileName(); // e.g. "archive.tar.gz"
-                            // cut prefix (left side) and cut document name (plus slash) on the right side
-                            int len = item.fullPath.length() - prefix_length - basename.length() - 1;
-                            if (len > 0) { // only assign in case item.fullPath is not empty
-                                // "PREFIXPATH/REMAININGPATH/BASENAME" --> "REMAININGPATH"
-                                item.displayPathPrefix = QStringRef(&item.fullPath, prefix_length, len).toString();
-                            }
-                        });
+        return pos < path.length() ? path.at(pos) : QChar();
     }
 }
 
@@ -114,28 +112,159 @@ detail::TabswitcherFilesModel::TabswitcherFilesModel(QObject *parent) : QAbstrac
 detail::TabswitcherFilesModel::TabswitcherFilesModel(const FilenameList & data)
 {
     data_ = data;
-    post_process(data_);
+    for (auto & item : data_) {
+        item.basenameOffset = basenameOffset(item.fullPath);
+    }
+    recomputePrefix();
+    updateDisplayPathPrefixes();
+}
+
+bool detail::TabswitcherFilesModel::addPath(QString const & path)
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    if (pathCount_ == 0) {
+        recomputePrefix();
+        return true;
+    }
+
+    // a path still starting with the prefix just counts
+    const int length = prefix_.length();
+    int common = 0;
+    while (common < length && common < path.length() && path.at(common) == prefix_.at(common)) {
+        ++common;
+    }
+
+    if (common == length) {
+        ++pathCount_;
+        ++nextChars_[charAt(path, length)];
+        return false;
+    }
+
+    recomputePrefix();
+    return true;
+}
+
+bool detail::TabswitcherFilesModel::removePath(QString const & path)
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    --pathCount_;
+    const auto it = nextChars_.find(charAt(path, prefix_.length()));
+    if (it != nextChars_.end() && --it.value() == 0) {
+        nextChars_.erase(it);
+    }
+
+    // the prefix is still bounded by two differing paths or a path ending there
+    if (pathCount_ > 0 && (nextChars_.size() != 1 || nextChars_.contains(QChar()))) {
+        return false;
+    }
+
+    const QString oldPrefix = prefix_;
+    recomputePrefix();
+    return prefix_ != oldPrefix;
+}
+
+void detail::TabswitcherFilesModel::recomputePrefix()
+{
+    std::vector<QString> paths;
+    for (const auto & item : data_) {
+        // Documents without file have no path and we would otherwise in this case always get ""
+        if (!item.fullPath.isEmpty()) {
+            paths.push_back(item.fullPath);
+        }
+    }
+
+    prefix_ = longestCommonPrefix(paths);
+    pathCount_ = paths.size();
+
+    nextChars_.clear();
+    for (const auto & path : paths) {
+        ++nextChars_[charAt(path, prefix_.length())];
+    }
+}
+
+void detail::TabswitcherFilesModel::updateDisplayPathPrefix(FilenameListItem & item) const
+{
+    int prefix_length = prefix_.length();
+    if (prefix_length == 1) { // if there is only the "/" at the beginning, then keep it
+        prefix_length = 0;
+    }
+
+    // cut prefix (left side) and cut document name (plus slash) on the right side
+    const int len = item.basenameOffset - prefix_length - 1;
+    if (len > 0) {
+        // "PREFIXPATH/REMAININGPATH/BASENAME" --> "REMAININGPATH"
+        item.displayPathPrefix = QStringRef(&item.fullPath, prefix_length, len).toString();
+    } else {
+        item.displayPathPrefix.clear();
+    }
+}
+
+void detail::TabswitcherFilesModel::updateDisplayPathPrefixes()
+{
+    for (auto & item : data_) {
+        updateDisplayPathPrefix(item);
+    }
 }
 
 bool detail::TabswitcherFilesModel::insertRow(int row, const FilenameListItem & item)
 {
-    beginInsertRows(QModelIndex(), row, row + 1);
-    data_.insert(data_.begin() + row, item);
-    post_process(data_);
+    beginInsertRows(QModelIndex(), row, row);
+    auto & inserted = *data_.insert(data_.begin() + row, item);
+    inserted.basenameOffset = basenameOffset(inserted.fullPath);
+    const bool prefixChanged = addPath(inserted.fullPath);
+    if (prefixChanged) {
+        updateDisplayPathPrefixes();
+    } else {
+        updateDisplayPathPrefix(inserted);
+    }
     endInsertRows();
+
+    if (prefixChanged) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, 0));
+    }
     return true;
 }
 
 bool detail::TabswitcherFilesModel::removeRow(int row)
 {
-    if (data_.begin() + row == data_.end()) {
+    if (row < 0 || data_.begin() + row >= data_.end()) {
         return false;
     }
 
     beginRemoveRows(QModelIndex(), row, row);
+    const QString path = data_[row].fullPath;
     data_.erase(data_.begin() + row);
-    post_process(data_);
+    const bool prefixChanged = removePath(path);
+    if (prefixChanged) {
+        updateDisplayPathPrefixes();
+    }
     endRemoveRows();
+
+    if (prefixChanged && !data_.empty()) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, 0));
+    }
+    return true;
+}
+
+bool detail::TabswitcherFilesModel::moveToFront(int row)
+{
+    if (row < 0 || data_.begin() + row >= data_.end()) {
+        return false;
+    }
+
+    if (row == 0) {
+        return true;
+    }
+
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), 0);
+    std::rotate(data_.begin(), data_.begin() + row, data_.begin() + row + 1);
+    endMoveRows();
     return true;
 }
 
@@ -144,6 +273,7 @@ void detail::TabswitcherFilesModel::clear()
     if (data_.size() > 0) {
         beginRemoveRows(QModelIndex(), 0, data_.size() - 1);
         data_.clear();
+        recomputePrefix();
         endRemoveRows();
     }
 }
@@ -160,9 +290,32 @@ detail::FilenameListItem * detail::TabswitcherFilesModel::item(int row) const
 
 void detail::TabswitcherFilesModel::updateItem(FilenameListItem * item, QString const & documentName, QString const & fullPath)
 {
+    const int row = item - data_.data();
+    const QString oldPath = item->fullPath;
+
     item->documentName = documentName;
-    item->fullPath = fullPath;
-    post_process(data_);
+
+    // like a removal of the old path and an insertion of the new one
+    bool prefixChanged = false;
+    if (oldPath != fullPath) {
+        item->fullPath.clear();
+        prefixChanged = removePath(oldPath);
+        item->fullPath = fullPath;
+        item->basenameOffset = basenameOffset(fullPath);
+        prefixChanged = addPath(fullPath) || prefixChanged;
+
+        if (item->document) {
+            item->icon = iconForDocument(item->document);
+        }
+    }
+
+    if (prefixChanged) {
+        updateDisplayPathPrefixes();
+        emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount(QModelIndex()) - 1));
+    } else {
+        updateDisplayPathPrefix(*item);
+        emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+    }
 }
 
 int detail::TabswitcherFilesModel::columnCount(const QModelIndex & parent) const
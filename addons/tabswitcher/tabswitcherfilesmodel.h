@@ -22,6 +22,8 @@
 #define KTEXTEDITOR_TAB_SWITCHER_FILES_MODEL_H
 
 #include <QString>
+#include <QUrl>
+#include <QHash>
 #include <QIcon>
 #include <QAbstractTableModel>
 
@@ -31,6 +33,17 @@ namespace KTextEditor {
 
 namespace detail {
 
+/**
+ * Url of a document.
+ * Documents lazily restored from a session are not loaded yet, they carry the url they will load as property.
+ */
+QUrl documentUrl(KTextEditor::Document* doc);
+
+/**
+ * Name of a document, see documentUrl().
+ */
+QString documentName(KTextEditor::Document* doc);
+
 /**
  * Represents one item in the table view of the tab switcher.
  */
@@ -38,6 +51,7 @@ class FilenameListItem
 {
 public:
     FilenameListItem(KTextEditor::Document* doc);
+    FilenameListItem(KTextEditor::Document* doc, QString const & documentName, QString const & fullPath);
 
     KTextEditor::Document *document;
     QIcon icon;
@@ -47,6 +61,10 @@ public:
      * calculated from documentName and fullPath
      */
     QString displayPathPrefix;
+    /**
+     * start of the file name in fullPath, e.g. "archive.tar.gz" in "/home/archive.tar.gz"
+     */
+    int basenameOffset;
 };
 using FilenameList = std::vector<FilenameListItem>;
 
@@ -60,6 +78,11 @@ public:
     TabswitcherFilesModel(const FilenameList & data);
     bool insertRow(int row, const FilenameListItem & item);
     bool removeRow(int row);
+    /**
+     * Moves the row to the front, the most recently used position.
+     * Only the rows in front of it move, the display prefixes stay.
+     */
+    bool moveToFront(int row);
     /**
      * Clears all data from the model
      */
@@ -81,8 +104,37 @@ protected:
     int rowCount(const QModelIndex & parent) const override;
     QVariant data(const QModelIndex & index, int role) const override;
 
+private:
+    /**
+     * account for a path added to or removed from data_
+     * @return true if the common prefix changed
+     */
+    bool addPath(QString const & path);
+    bool removePath(QString const & path);
+
+    /**
+     * recompute the common prefix from all paths in data_
+     */
+    void recomputePrefix();
+
+    void updateDisplayPathPrefix(FilenameListItem & item) const;
+    void updateDisplayPathPrefixes();
+
 private:
     FilenameList data_;
+
+    /**
+     * longest common prefix of all non-empty paths,
+     * documents without file have no path and are ignored
+     */
+    QString prefix_;
+    int pathCount_ = 0;
+
+    /**
+     * number of paths per character following the prefix, QChar() for paths ending there:
+     * the prefix can only get longer on removal if a single character is left
+     */
+    QHash<QChar, int> nextChars_;
 };
 
 QString longestCommonPrefix(std::vector<QString> const & strs);
@@ -0,0 +1,161 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "diff_test.h"
+#include "katediff.h"
+
+#include <QDateTime>
+#include <QtTest>
+
+QTEST_GUILESS_MAIN(KateDiffTest)
+
+/**
+ * expected output generated with diff -u --label a --label b, -b if ignoring space changes
+ */
+void KateDiffTest::unified_data()
+{
+    QTest::addColumn<QByteArray>("oldText");
+    QTest::addColumn<QByteArray>("newText");
+    QTest::addColumn<bool>("ignoreSpaceChange");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("change") << QByteArray("1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n")
+        << QByteArray("1\n2\n3\n4\nfive\n6\n7\n8\n9\n10\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -2,7 +2,7 @@\n 2\n 3\n 4\n-5\n+five\n 6\n 7\n 8\n");
+    QTest::newRow("insert at start") << QByteArray("1\n2\n3\n4\n5\n6\n")
+        << QByteArray("zero\n1\n2\n3\n4\n5\n6\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,3 +1,4 @@\n+zero\n 1\n 2\n 3\n");
+    QTest::newRow("delete at end") << QByteArray("1\n2\n3\n4\n5\n6\n")
+        << QByteArray("1\n2\n3\n4\n5\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -3,4 +3,3 @@\n 3\n 4\n 5\n-6\n");
+    QTest::newRow("no newline at end") << QByteArray("a\nb\nc\n")
+        << QByteArray("a\nb\nd")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,3 +1,3 @@\n a\n b\n-c\n+d\n\\ No newline at end of file\n");
+    QTest::newRow("newline added") << QByteArray("a\nb\nc")
+        << QByteArray("a\nb\nc\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,3 +1,3 @@\n a\n b\n-c\n\\ No newline at end of file\n+c\n");
+    QTest::newRow("empty old") << QByteArray("")
+        << QByteArray("a\nb\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -0,0 +1,2 @@\n+a\n+b\n");
+    QTest::newRow("empty new") << QByteArray("a\nb\n")
+        << QByteArray("")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,2 +0,0 @@\n-a\n-b\n");
+    QTest::newRow("identical") << QByteArray("1\n2\n3\n4\n5\n")
+        << QByteArray("1\n2\n3\n4\n5\n")
+        << false
+        << QByteArray("");
+    QTest::newRow("close changes share a hunk") << QByteArray("1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n11\n12\n13\n14\n15\n16\n17\n18\n19\n20\n")
+        << QByteArray("x\n2\n3\n4\n5\n6\n7\ny\n9\n10\n11\n12\n13\n14\n15\n16\n17\n18\n19\n20\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,11 +1,11 @@\n-1\n+x\n 2\n 3\n 4\n 5\n 6\n 7\n-8\n+y\n 9\n 10\n 11\n");
+    QTest::newRow("distant changes split") << QByteArray("1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n11\n12\n13\n14\n15\n16\n17\n18\n19\n20\n")
+        << QByteArray("x\n2\n3\n4\n5\n6\n7\n8\ny\n10\n11\n12\n13\n14\n15\n16\n17\n18\n19\n20\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,4 +1,4 @@\n-1\n+x\n 2\n 3\n 4\n@@ -6,7 +6,7 @@\n 6\n 7\n 8\n-9\n+y\n 10\n 11\n 12\n");
+    QTest::newRow("ambiguous alignment") << QByteArray("a\nb\na\nb\nc\n")
+        << QByteArray("a\nb\nc\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,5 +1,3 @@\n a\n b\n-a\n-b\n c\n");
+    QTest::newRow("slide to the end") << QByteArray("x\n{\na\n}\n{\nb\n}\n")
+        << QByteArray("x\n{\na\n}\n{\nc\n}\n{\nb\n}\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -3,5 +3,8 @@\n a\n }\n {\n+c\n+}\n+{\n b\n }\n");
+    QTest::newRow("space change ignored") << QByteArray("int  a;\n\tb();\nc\n")
+        << QByteArray("int a;\n  b();\nc\n")
+        << true
+        << QByteArray("");
+    QTest::newRow("space change shown") << QByteArray("int  a;\nb\nc\n")
+        << QByteArray("int a;\nb\nc\n")
+        << false
+        << QByteArray("--- a\n+++ b\n@@ -1,3 +1,3 @@\n-int  a;\n+int a;\n b\n c\n");
+    QTest::newRow("space added vs removed") << QByteArray("ab\nc d\n")
+        << QByteArray("a b\nc d\n")
+        << true
+        << QByteArray("--- a\n+++ b\n@@ -1,2 +1,2 @@\n-ab\n+a b\n c d\n");
+    QTest::newRow("trailing space ignored") << QByteArray("a \nb\n")
+        << QByteArray("a\nb\n")
+        << true
+        << QByteArray("");
+    QTest::newRow("missing newline ignored") << QByteArray("a\nb\n")
+        << QByteArray("a\nb")
+        << true
+        << QByteArray("");
+}
+
+void KateDiffTest::unified()
+{
+    QFETCH(QByteArray, oldText);
+    QFETCH(QByteArray, newText);
+    QFETCH(bool, ignoreSpaceChange);
+    QFETCH(QByteArray, expected);
+
+    const KateDiff::Options options = ignoreSpaceChange ? KateDiff::IgnoreSpaceChange : KateDiff::NoOptions;
+    QCOMPARE(KateDiff::unified(oldText, newText, "a", "b", options), expected);
+}
+
+void KateDiffTest::largeFile()
+{
+    // every thousandth line changed, one hunk each
+    QByteArray oldText, newText;
+    for (int i = 0; i < 20000; ++i) {
+        const QByteArray line = "line " + QByteArray::number(i) + '\n';
+        oldText += line;
+        newText += (i % 1000 == 500) ? "changed " + QByteArray::number(i) + '\n' : line;
+    }
+
+    const QByteArray diff = KateDiff::unified(oldText, newText, "a", "b");
+    QCOMPARE(diff.count("\n@@ "), 20);
+    QCOMPARE(diff.count("\n-line "), 20);
+    QCOMPARE(diff.count("\n+changed "), 20);
+    QVERIFY(diff.contains("@@ -498,7 +498,7 @@\n line 497\n line 498\n line 499\n-line 500\n+changed 500\n line 501\n"));
+}
+
+void KateDiffTest::nothingInCommon()
+{
+    // the search gives up early, the result is still correct
+    QByteArray oldText, newText;
+    for (int i = 0; i < 5000; ++i) {
+        oldText += "old " + QByteArray::number(i) + '\n';
+        newText += "new " + QByteArray::number(i) + '\n';
+    }
+
+    const QByteArray diff = KateDiff::unified(oldText, newText, "a", "b");
+    QVERIFY(diff.startsWith("--- a\n+++ b\n@@ -1,5000 +1,5000 @@\n-old 0\n"));
+    QCOMPARE(diff.count("\n-old "), 5000);
+    QCOMPARE(diff.count("\n+new "), 5000);
+}
+
+void KateDiffTest::header()
+{
+    const QDateTime time(QDate(2019, 5, 17), QTime(13, 45, 7, 123), Qt::OffsetFromUTC, 2 * 3600 + 30 * 60);
+    QCOMPARE(KateDiff::header(QStringLiteral("/tmp/a.txt"), time), QByteArray("/tmp/a.txt\t2019-05-17 13:45:07.123000000 +0230"));
+
+    const QDateTime west(QDate(2019, 1, 2), QTime(3, 4, 5, 6), Qt::OffsetFromUTC, -5 * 3600);
+    QCOMPARE(KateDiff::header(QStringLiteral("b"), west), QByteArray("b\t2019-01-02 03:04:05.006000000 -0500"));
+
+    QCOMPARE(KateDiff::header(QStringLiteral("-"), QDateTime()), QByteArray("-"));
+}
@@ -0,0 +1,78 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "fuzzymatcher_test.h"
+#include "katefuzzymatcher.h"
+
+#include <QtTestWidgets>
+
+QTEST_MAIN(KateFuzzyMatcherTest)
+
+/**
+ * score of a path match, like quick open computes it
+ */
+static int pathScore(const QString &pattern, const QString &path)
+{
+    int score = 0;
+    if (!KateFuzzyMatcher::match(pattern, path, path.lastIndexOf(QLatin1Char('/')) + 1, score)) {
+        return -1;
+    }
+    return score;
+}
+
+void KateFuzzyMatcherTest::noMatch()
+{
+    int score = 0;
+    QVERIFY(!KateFuzzyMatcher::match(QStringLiteral("xyz"), QStringLiteral("abc"), 0, score));
+    QVERIFY(!KateFuzzyMatcher::match(QStringLiteral("ab"), QStringLiteral("a"), 0, score));
+    QVERIFY(!KateFuzzyMatcher::match(QStringLiteral("ba"), QStringLiteral("ab"), 0, score));
+    QVERIFY(!KateFuzzyMatcher::match(QString(), QStringLiteral("ab"), 0, score));
+}
+
+void KateFuzzyMatcherTest::caseInsensitive()
+{
+    int score = 0;
+    QVERIFY(KateFuzzyMatcher::match(QStringLiteral("KDM"), QStringLiteral("katedocmanager.cpp"), 0, score));
+    QVERIFY(KateFuzzyMatcher::match(QStringLiteral("kdm"), QStringLiteral("KateDocManager.cpp"), 0, score));
+}
+
+void KateFuzzyMatcherTest::consecutive()
+{
+    QVERIFY(pathScore(QStringLiteral("main"), QStringLiteral("src/main.cpp")) > pathScore(QStringLiteral("main"), QStringLiteral("src/mxaxixn.cpp")));
+}
+
+void KateFuzzyMatcherTest::segmentStart()
+{
+    QVERIFY(pathScore(QStringLiteral("doc"), QStringLiteral("src/document.cpp")) > pathScore(QStringLiteral("doc"), QStringLiteral("src/adoc/x.cpp")));
+}
+
+void KateFuzzyMatcherTest::basename()
+{
+    QVERIFY(pathScore(QStringLiteral("model"), QStringLiteral("kate/katequickopenmodel.cpp")) > pathScore(QStringLiteral("model"), QStringLiteral("model/foo.cpp")));
+}
+
+void KateFuzzyMatcherTest::charMask()
+{
+    const quint64 text = KateFuzzyMatcher::charMask(QStringLiteral("KateDocManager.cpp"));
+    const quint64 matching = KateFuzzyMatcher::charMask(QStringLiteral("kdm"));
+    const quint64 missing = KateFuzzyMatcher::charMask(QStringLiteral("kdz"));
+    QCOMPARE(text & matching, matching);
+    QVERIFY((text & missing) != missing);
+}
@@ -0,0 +1,152 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "handoff_test.h"
+#include "katehandoff.h"
+#include "katedocmanager.h"
+#include "katemainwindow.h"
+#include "kateviewmanager.h"
+#include "kateapp.h"
+
+#include "../../urlinfo.h"
+
+#include <ktexteditor/view.h>
+
+#include <QtTestWidgets>
+#include <QTemporaryDir>
+#include <QCommandLineParser>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+QTEST_MAIN(KateHandoffTest)
+
+/**
+ * the sender blocks until the answer is there, the server needs our event loop
+ */
+class HandoffSender : public QThread
+{
+public:
+    explicit HandoffSender(const QString &message)
+        : m_message(message)
+        , m_result(false)
+    {
+    }
+
+    void run() override
+    {
+        m_result = KateHandoffServer::sendMessage(m_message, 5000);
+    }
+
+    bool result() const
+    {
+        return m_result;
+    }
+
+private:
+    const QString m_message;
+    bool m_result;
+};
+
+void KateHandoffTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    // own socket name, don't talk to a kate running on this display
+    qputenv("WAYLAND_DISPLAY", "kate-handoff-test-" + QByteArray::number(QCoreApplication::applicationPid()));
+
+    m_app = new KateApp(QCommandLineParser());
+    m_app->newMainWindow();
+}
+
+void KateHandoffTest::cleanupTestCase()
+{
+    delete m_app;
+}
+
+void KateHandoffTest::roundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QFile file(dir.path() + QStringLiteral("/file.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("line 1\nline 2\nline 3\nline 4\n");
+    file.close();
+
+    // relative paths are resolved in the working directory of the sender, like in main()
+    const QString oldCwd = QDir::currentPath();
+    QVERIFY(QDir::setCurrent(dir.path()));
+    const UrlInfo info(QStringLiteral("file.txt:3:2"));
+    QVERIFY(QDir::setCurrent(oldCwd));
+
+    QJsonObject urlMessagePart;
+    urlMessagePart.insert(QStringLiteral("url"), info.url.toString());
+    urlMessagePart.insert(QStringLiteral("line"), info.cursor.line());
+    urlMessagePart.insert(QStringLiteral("column"), info.cursor.column());
+
+    const QString input = QString::fromUtf8("piped \xc3\xa4\xc3\xb6\xc3\xbc input\nsecond line\n");
+    QJsonObject message;
+    message.insert(QStringLiteral("tempfile"), false);
+    message.insert(QStringLiteral("urls"), QJsonArray() << urlMessagePart);
+    message.insert(QStringLiteral("stdin"), input);
+    message.insert(QStringLiteral("line"), 1);
+    message.insert(QStringLiteral("column"), 4);
+
+    KateHandoffServer server;
+    QVERIFY(server.listen());
+    QSignalSpy received(&server, SIGNAL(messageReceived(QString)));
+
+    HandoffSender sender(QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact)));
+    sender.start();
+    QTRY_COMPARE(received.count(), 1);
+    QVERIFY(sender.wait(5000));
+    QVERIFY(sender.result());
+
+    // handled like the running instance does it
+    const QJsonDocument json = QJsonDocument::fromJson(received.at(0).at(0).toString().toUtf8());
+    QVERIFY(json.isObject());
+    QCOMPARE(json.object(), message);
+    m_app->handleRemoteMessage(json.object());
+
+    // the file of the sender's working directory, at the cursor given with the path
+    KTextEditor::Document *doc = m_app->documentManager()->findDocument(QUrl::fromLocalFile(dir.path() + QStringLiteral("/file.txt")));
+    QVERIFY(doc);
+    QCOMPARE(doc->line(0), QStringLiteral("line 1"));
+    QCOMPARE(doc->views().size(), 1);
+    QCOMPARE(doc->views().first()->cursorPosition(), KTextEditor::Cursor(2, 1));
+
+    // stdin text in a new document, that got the global cursor position
+    KTextEditor::View *view = m_app->activeKateMainWindow()->viewManager()->activeView();
+    QVERIFY(view);
+    QVERIFY(view->document() != doc);
+    QCOMPARE(view->document()->text(), input);
+    QCOMPARE(view->cursorPosition(), KTextEditor::Cursor(1, 4));
+}
+
+void KateHandoffTest::noServer()
+{
+    // nobody listens: fails fast, the caller starts an own instance
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!KateHandoffServer::sendMessage(QStringLiteral("{}"), 5000));
+    QVERIFY(timer.elapsed() < 5000);
+}
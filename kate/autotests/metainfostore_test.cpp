@@ -0,0 +1,171 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "metainfostore_test.h"
+#include "katemetainfostore.h"
+
+#include <QtTestWidgets>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+
+QTEST_MAIN(KateMetaInfoStoreTest)
+
+static KateMetaInfoStore::Entry makeEntry(const QByteArray &checksum, const QDateTime &time = QDateTime::currentDateTimeUtc())
+{
+    KateMetaInfoStore::Entry entry;
+    entry.checksum = checksum;
+    entry.time = time;
+    entry.config.insert(QStringLiteral("Bookmarks"), QStringLiteral("1,5,7"));
+    entry.config.insert(QStringLiteral("Encoding"), QStringLiteral("UTF-8"));
+    return entry;
+}
+
+void KateMetaInfoStoreTest::init()
+{
+    m_tempdir = new QTemporaryDir;
+    QVERIFY(m_tempdir->isValid());
+}
+
+void KateMetaInfoStoreTest::cleanup()
+{
+    delete m_tempdir;
+}
+
+QString KateMetaInfoStoreTest::storeFile() const
+{
+    return m_tempdir->path() + QStringLiteral("/metainfos");
+}
+
+void KateMetaInfoStoreTest::roundTrip()
+{
+    const QUrl url(QStringLiteral("file:///tmp/a.cpp"));
+    {
+        KateMetaInfoStore store(storeFile());
+        QCOMPARE(store.count(), 0);
+        store.insert(url, makeEntry("abc"));
+        store.insert(url, makeEntry("def"));
+        QCOMPARE(store.count(), 1);
+    }
+
+    KateMetaInfoStore store(storeFile());
+    QCOMPARE(store.count(), 1);
+
+    KateMetaInfoStore::Entry entry;
+    QVERIFY(store.entry(url, entry));
+    QCOMPARE(entry.checksum, QByteArray("def"));
+    QCOMPARE(entry.config.value(QStringLiteral("Bookmarks")), QStringLiteral("1,5,7"));
+    QVERIFY(!store.entry(QUrl(QStringLiteral("file:///tmp/b.cpp")), entry));
+}
+
+void KateMetaInfoStoreTest::remove()
+{
+    const QUrl a(QStringLiteral("file:///tmp/a.cpp"));
+    const QUrl b(QStringLiteral("file:///tmp/b.cpp"));
+    {
+        KateMetaInfoStore store(storeFile());
+        store.insert(a, makeEntry("a"));
+        store.insert(b, makeEntry("b"));
+        store.flush();
+        store.remove(a);
+    }
+
+    KateMetaInfoStore store(storeFile());
+    KateMetaInfoStore::Entry entry;
+    QVERIFY(!store.entry(a, entry));
+    QVERIFY(store.entry(b, entry));
+    QCOMPARE(store.count(), 1);
+}
+
+void KateMetaInfoStoreTest::removeOlderThan()
+{
+    const QUrl oldUrl(QStringLiteral("file:///tmp/old.cpp"));
+    const QUrl newUrl(QStringLiteral("file:///tmp/new.cpp"));
+    {
+        KateMetaInfoStore store(storeFile());
+        store.insert(oldUrl, makeEntry("old", QDateTime::currentDateTimeUtc().addDays(-30)));
+        store.insert(newUrl, makeEntry("new"));
+        store.removeOlderThan(10);
+        QCOMPARE(store.count(), 1);
+    }
+
+    KateMetaInfoStore store(storeFile());
+    KateMetaInfoStore::Entry entry;
+    QVERIFY(!store.entry(oldUrl, entry));
+    QVERIFY(store.entry(newUrl, entry));
+}
+
+void KateMetaInfoStoreTest::compaction()
+{
+    const QUrl url(QStringLiteral("file:///tmp/a.cpp"));
+    KateMetaInfoStore store(storeFile());
+
+    // each flush appends one record for the same key
+    for (int i = 0; i < 100; ++i) {
+        store.insert(url, makeEntry(QByteArray::number(i)));
+        store.flush();
+    }
+    store.waitForFinished();
+    const qint64 appendedSize = QFileInfo(storeFile()).size();
+
+    // the last flush exceeds the slack, the file is rewritten with just the live entry
+    for (int i = 0; i < 903; ++i) {
+        store.insert(url, makeEntry(QByteArray::number(i)));
+        store.flush();
+    }
+    store.waitForFinished();
+    QVERIFY(QFileInfo(storeFile()).size() < appendedSize);
+
+    KateMetaInfoStore reopened(storeFile());
+    KateMetaInfoStore::Entry entry;
+    QVERIFY(reopened.entry(url, entry));
+    QCOMPARE(entry.checksum, QByteArray("902"));
+}
+
+void KateMetaInfoStoreTest::brokenTail()
+{
+    const QUrl a(QStringLiteral("file:///tmp/a.cpp"));
+    const QUrl b(QStringLiteral("file:///tmp/b.cpp"));
+    {
+        KateMetaInfoStore store(storeFile());
+        store.insert(a, makeEntry("a"));
+    }
+
+    // simulate a crash in the middle of writing a record
+    {
+        QFile file(storeFile());
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("\x00\x00\x00\x14garbage", 11);
+    }
+
+    {
+        KateMetaInfoStore store(storeFile());
+        KateMetaInfoStore::Entry entry;
+        QVERIFY(store.entry(a, entry));
+        store.insert(b, makeEntry("b"));
+    }
+
+    // the broken tail is gone, later records are readable
+    KateMetaInfoStore store(storeFile());
+    KateMetaInfoStore::Entry entry;
+    QVERIFY(store.entry(a, entry));
+    QVERIFY(store.entry(b, entry));
+    QCOMPARE(store.count(), 2);
+}
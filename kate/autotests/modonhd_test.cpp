@@ -0,0 +1,135 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "modonhd_test.h"
+#include "katedocmanager.h"
+#include "kateapp.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <ktexteditor/document.h>
+#include <ktexteditor/modificationinterface.h>
+
+#include <QtTestWidgets>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QCommandLineParser>
+
+QTEST_MAIN(KateModOnHdTest)
+
+void KateModOnHdTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<KTextEditor::ModificationInterface::ModifiedOnDiskReason>("KTextEditor::ModificationInterface::ModifiedOnDiskReason");
+
+    // Kate's own notification instead of the message of the editor, without main window no dialog is shown
+    KConfigGroup(KSharedConfig::openConfig(), "General").writeEntry("Modified Notification", true);
+
+    m_app = new KateApp(QCommandLineParser());
+}
+
+void KateModOnHdTest::cleanupTestCase()
+{
+    delete m_app;
+}
+
+/**
+ * open a file with the given content
+ */
+static KTextEditor::Document *openFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+        return nullptr;
+    }
+    file.close();
+    return KateApp::self()->documentManager()->openUrl(QUrl::fromLocalFile(fileName));
+}
+
+/**
+ * rewrite a file, like a git checkout does
+ */
+static bool writeFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(content) == content.size();
+}
+
+void KateModOnHdTest::touchOnly()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/touched.txt");
+    KTextEditor::Document *doc = openFile(fileName, "unchanged\n");
+    QVERIFY(doc);
+    QSignalSpy reports(doc, SIGNAL(modifiedOnDisk(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)));
+
+    // new time stamp, same content: reported, but not as modification
+    QVERIFY(writeFile(fileName, "unchanged\n"));
+    QTRY_VERIFY_WITH_TIMEOUT(reports.count() > 0, 10000);
+    QCOMPARE(reports.last().at(1).toBool(), false);
+
+    KateDocumentInfo *info = KateApp::self()->documentManager()->documentInfo(doc);
+    QVERIFY(info);
+    QVERIFY(!info->modifiedOnDisc);
+    QCOMPARE(info->modifiedOnDiscReason, KTextEditor::ModificationInterface::OnDiskUnmodified);
+
+    QVERIFY(KateApp::self()->documentManager()->closeDocument(doc));
+}
+
+void KateModOnHdTest::realChange()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/changed.txt");
+    KTextEditor::Document *doc = openFile(fileName, "before\n");
+    QVERIFY(doc);
+    QSignalSpy reports(doc, SIGNAL(modifiedOnDisk(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)));
+
+    QVERIFY(writeFile(fileName, "after\n"));
+    QTRY_VERIFY_WITH_TIMEOUT(reports.count() > 0, 10000);
+    QCOMPARE(reports.last().at(1).toBool(), true);
+
+    KateDocumentInfo *info = KateApp::self()->documentManager()->documentInfo(doc);
+    QVERIFY(info);
+    QVERIFY(info->modifiedOnDisc);
+    QCOMPARE(info->modifiedOnDiscReason, KTextEditor::ModificationInterface::OnDiskModified);
+
+    QVERIFY(KateApp::self()->documentManager()->closeDocument(doc));
+}
+
+void KateModOnHdTest::deletion()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/deleted.txt");
+    KTextEditor::Document *doc = openFile(fileName, "gone soon\n");
+    QVERIFY(doc);
+    QSignalSpy reports(doc, SIGNAL(modifiedOnDisk(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)));
+
+    QVERIFY(QFile::remove(fileName));
+    QTRY_VERIFY_WITH_TIMEOUT(reports.count() > 0, 10000);
+    QCOMPARE(reports.last().at(1).toBool(), true);
+
+    KateDocumentInfo *info = KateApp::self()->documentManager()->documentInfo(doc);
+    QVERIFY(info);
+    QVERIFY(info->modifiedOnDisc);
+    QCOMPARE(info->modifiedOnDiscReason, KTextEditor::ModificationInterface::OnDiskDeleted);
+
+    QVERIFY(KateApp::self()->documentManager()->closeDocument(doc));
+}
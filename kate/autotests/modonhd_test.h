@@ -0,0 +1,48 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_MODONHD_TEST_H
+#define KATE_MODONHD_TEST_H
+
+#include <QObject>
+
+/**
+ * Modified-on-disk reports as the document manager sees them.
+ * KTextEditor compares the git-blob digest of the file with the loaded
+ * content before it reports a change, touched files with unchanged
+ * content are never flagged.
+ */
+class KateModOnHdTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void touchOnly();
+    void realChange();
+    void deletion();
+
+private:
+    class KateApp *m_app;
+};
+
+#endif
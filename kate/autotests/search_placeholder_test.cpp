@@ -0,0 +1,111 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "search_placeholder_test.h"
+#include "katedocmanager.h"
+#include "katemainwindow.h"
+#include "kateapp.h"
+#include "search_open_files.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <QtTestWidgets>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QCommandLineParser>
+
+QTEST_MAIN(KateSearchPlaceholderTest)
+
+static const int DocumentCount = 3;
+
+void KateSearchPlaceholderTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    // the test relies on lazily restored documents, whatever the user configured
+    KConfigGroup(KSharedConfig::openConfig(), "General").writeEntry("Lazy Document Loading", true);
+
+    m_app = new KateApp(QCommandLineParser());
+}
+
+void KateSearchPlaceholderTest::cleanupTestCase()
+{
+    delete m_app;
+}
+
+void KateSearchPlaceholderTest::searchOpenFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup(&config, "Open Documents").writeEntry("Count", DocumentCount);
+    QStringList urls;
+    for (int i = 0; i < DocumentCount; ++i) {
+        const QString fileName = dir.path() + QStringLiteral("/file%1.txt").arg(i);
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("first line\nthe needle\n");
+        file.close();
+
+        urls << QUrl::fromLocalFile(fileName).toString();
+        KConfigGroup(&config, QStringLiteral("Document %1").arg(i)).writeEntry("URL", urls.last());
+    }
+
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    QVERIFY(docManager->closeAllDocuments());
+    KateMainWindow *mainWindow = m_app->newMainWindow();
+    docManager->restoreDocumentList(&config);
+
+    // only the first document is loaded, the other ones are empty placeholders
+    QList<KTextEditor::Document *> documents;
+    for (const QString &url : qAsConst(urls)) {
+        KTextEditor::Document *doc = docManager->findDocument(QUrl(url));
+        QVERIFY(doc);
+        documents << doc;
+    }
+    QVERIFY(docManager->isLoaded(documents.first()));
+    QVERIFY(!docManager->isLoaded(documents.last()));
+    QCOMPARE(documents.last()->lines(), 1);
+
+    // the search in the open files finds the needle in each of them
+    SearchOpenFiles search;
+    QSignalSpy matches(&search, &SearchOpenFiles::matchFound);
+    QSignalSpy done(&search, &SearchOpenFiles::searchDone);
+    search.startSearch(documents, QRegularExpression(QStringLiteral("needle")));
+    QTRY_COMPARE(done.count(), 1);
+
+    QStringList found;
+    for (const QList<QVariant> &match : qAsConst(matches)) {
+        found << match.at(0).toString();
+        QCOMPARE(match.at(4).toInt(), 1);
+    }
+    QCOMPARE(found, urls);
+
+    // loaded in place, the documents stay the same
+    for (int i = 0; i < DocumentCount; ++i) {
+        QVERIFY(docManager->isLoaded(documents.at(i)));
+        QCOMPARE(docManager->findDocument(QUrl(urls.at(i))), documents.at(i));
+    }
+
+    delete mainWindow;
+}
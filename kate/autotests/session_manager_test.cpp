@@ -165,4 +165,53 @@ void KateSessionManagerTest::startNonEmpty()
     QCOMPARE(m.sessionList().size(), 2);
 }
 
+/**
+ * create an empty session file, named like the manager names them
+ */
+static bool createSessionFile(const QString &dir, const QString &name)
+{
+    QFile file(dir + QLatin1Char('/') + QString::fromLatin1(QUrl::toPercentEncoding(name, QByteArray(), QByteArray("."))) + QLatin1String(".katesession"));
+    return file.open(QIODevice::WriteOnly);
+}
 
+void KateSessionManagerTest::largeSessionList()
+{
+    const int sessionCount = 2000;
+    for (int i = 0; i < sessionCount; ++i) {
+        QVERIFY(createSessionFile(m_tempdir->path(), QStringLiteral("session %1").arg(i)));
+    }
+
+    KateSessionManager m(this, m_tempdir->path());
+    QCOMPARE(m.sessionList().size(), sessionCount);
+    QSignalSpy changed(&m, SIGNAL(sessionListChanged()));
+
+    // nothing changed: no signal, no work beyond listing the dir
+    QElapsedTimer timer;
+    timer.start();
+    const int refreshes = 100;
+    for (int i = 0; i < refreshes; ++i) {
+        QVERIFY(QMetaObject::invokeMethod(&m, "updateSessionList"));
+    }
+    qDebug() << "us per refresh of" << sessionCount << "sessions:" << (timer.nsecsElapsed() / refreshes / 1000);
+    QCOMPARE(changed.count(), 0);
+
+    // some gone, some new
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(QFile::remove(m_tempdir->path() + QStringLiteral("/session%20%1.katesession").arg(i)));
+    }
+    QVERIFY(createSessionFile(m_tempdir->path(), QStringLiteral("new/1")));
+    QVERIFY(createSessionFile(m_tempdir->path(), QStringLiteral("new 2")));
+
+    QVERIFY(QMetaObject::invokeMethod(&m, "updateSessionList"));
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(m.sessionList().size(), sessionCount - 3);
+
+    QSet<QString> names;
+    for (const KateSession::Ptr &session : m.sessionList()) {
+        names.insert(session->name());
+    }
+    QVERIFY(names.contains(QStringLiteral("new/1")));
+    QVERIFY(names.contains(QStringLiteral("new 2")));
+    QVERIFY(!names.contains(QStringLiteral("session 0")));
+    QVERIFY(names.contains(QStringLiteral("session 5")));
+}
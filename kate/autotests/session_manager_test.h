@@ -42,6 +42,7 @@ private Q_SLOTS:
 
     void deletingSessionFilesUnderRunningApp();
     void startNonEmpty();
+    void largeSessionList();
 
 private:
     class QTemporaryDir *m_tempdir;
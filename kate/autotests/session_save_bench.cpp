@@ -0,0 +1,124 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "session_save_bench.h"
+#include "katesessionmanager.h"
+#include "katesessionwriter.h"
+#include "katedocmanager.h"
+#include "kateapp.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <QtTestWidgets>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QCommandLineParser>
+
+QTEST_MAIN(KateSessionSaveBench)
+
+static const int DocumentCount = 5000;
+
+void KateSessionSaveBench::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    // the benchmark saves lazily restored documents, whatever the user configured
+    KConfigGroup(KSharedConfig::openConfig(), "General").writeEntry("Lazy Document Loading", true);
+
+    m_app = new KateApp(QCommandLineParser());
+}
+
+void KateSessionSaveBench::cleanupTestCase()
+{
+    delete m_app;
+}
+
+void KateSessionSaveBench::saveLargeSession()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    KateSessionManager manager(this, dir.path());
+    QVERIFY(manager.activateSession(QStringLiteral("large"), false, false));
+
+    // placeholders of a lazy restored session, they write their session config like loaded ones
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    for (int i = 0; i < DocumentCount; ++i) {
+        KateDocumentInfo info;
+        info.pendingLoad = true;
+        info.pendingUrl = QUrl::fromLocalFile(QStringLiteral("/bench/dir%1/file%2.cpp").arg(i % 50).arg(i));
+        info.pendingConfig.insert(QStringLiteral("URL"), info.pendingUrl.toString());
+        info.pendingConfig.insert(QStringLiteral("Encoding"), QStringLiteral("UTF-8"));
+        info.pendingConfig.insert(QStringLiteral("Mode"), QStringLiteral("C++"));
+        docManager->createDoc(info);
+    }
+    const int documents = docManager->documentList().size();
+
+    QElapsedTimer timer;
+    qint64 guiThread = 0;
+    QBENCHMARK {
+        timer.start();
+        QVERIFY(manager.saveActiveSession());
+        guiThread = timer.nsecsElapsed();
+        manager.waitForSaved();
+    }
+    const qint64 total = timer.nsecsElapsed();
+    qDebug() << "ms in the GUI thread:" << (guiThread / 1000000) << "ms until written:" << (total / 1000000);
+
+    // all documents made it to the file
+    KConfig config(manager.activeSession()->file(), KConfig::SimpleConfig);
+    QCOMPARE(config.group("Open Documents").readEntry("Count", 0), documents);
+    const KConfigGroup last(&config, QStringLiteral("Document %1").arg(documents - 1));
+    QCOMPARE(last.readEntry("URL"), QStringLiteral("file:///bench/dir49/file4999.cpp"));
+}
+
+void KateSessionSaveBench::coalesceSaves()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/coalesce.katesession");
+    KateSessionWriter writer;
+    KConfig config(fileName, KConfig::SimpleConfig);
+
+    // a large first save keeps the writer thread busy
+    for (int i = 0; i < DocumentCount; ++i) {
+        config.group(QStringLiteral("Document %1").arg(i)).writeEntry("URL", QStringLiteral("file:///bench/file%1.cpp").arg(i));
+    }
+    writer.save(&config);
+    for (const QString &group : config.groupList()) {
+        config.deleteGroup(group);
+    }
+
+    // quick saves in a row meanwhile are coalesced into one write, the last state wins
+    const int saves = 20;
+    for (int i = 0; i < saves; ++i) {
+        config.group("General").writeEntry("Round", i);
+        writer.save(&config);
+    }
+    writer.waitForSaved(fileName);
+    qDebug() << "writes for" << (saves + 1) << "saves:" << writer.writeCount();
+    QVERIFY(writer.writeCount() >= 1);
+    QVERIFY(writer.writeCount() < saves);
+
+    KConfig written(fileName, KConfig::SimpleConfig);
+    QCOMPARE(written.group("General").readEntry("Round", -1), saves - 1);
+    QVERIFY(!written.hasGroup("Document 0"));
+}
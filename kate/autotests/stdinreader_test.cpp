@@ -0,0 +1,137 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "stdinreader_test.h"
+#include "katestdinreader.h"
+
+#include <KTextEditor/Document>
+#include <KTextEditor/Editor>
+#include <KTextEditor/View>
+
+#include <QtTestWidgets>
+#include <QTextCodec>
+
+#include <unistd.h>
+
+QTEST_MAIN(KateStdinReaderTest)
+
+static void writeAll(int fd, const QByteArray &data)
+{
+    QCOMPARE(::write(fd, data.constData(), data.size()), ssize_t(data.size()));
+}
+
+void KateStdinReaderTest::init()
+{
+    QCOMPARE(::pipe(m_pipe), 0);
+}
+
+void KateStdinReaderTest::cleanup()
+{
+    ::close(m_pipe[0]);
+    if (m_pipe[1] >= 0) {
+        ::close(m_pipe[1]);
+    }
+}
+
+void KateStdinReaderTest::streamBlocks()
+{
+    QScopedPointer<KTextEditor::Document> doc(KTextEditor::Editor::instance()->createDocument(nullptr));
+    KateStdinReader *reader = new KateStdinReader(doc.data(), QTextCodec::codecForName("UTF-8"), false, m_pipe[0]);
+    QSignalSpy finished(reader, &KateStdinReader::finished);
+
+    // the first block shows up before the input ends
+    writeAll(m_pipe[1], "first\r");
+    QTRY_COMPARE(doc->text(), QStringLiteral("first"));
+
+    // line feed of the split CR LF and a multi byte character split across blocks
+    const QByteArray umlaut = QStringLiteral("ä").toUtf8();
+    writeAll(m_pipe[1], "\nsecond " + umlaut.left(1));
+    QTRY_COMPARE(doc->text(), QStringLiteral("first\nsecond "));
+    writeAll(m_pipe[1], umlaut.mid(1) + "\n");
+    QTRY_COMPARE(doc->text(), QStringLiteral("first\nsecond ä\n"));
+    QCOMPARE(finished.count(), 0);
+
+    ::close(m_pipe[1]);
+    m_pipe[1] = -1;
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(doc->text(), QStringLiteral("first\nsecond ä\n"));
+}
+
+void KateStdinReaderTest::follow()
+{
+    QScopedPointer<KTextEditor::Document> doc(KTextEditor::Editor::instance()->createDocument(nullptr));
+    QScopedPointer<KTextEditor::View> view(doc->createView(nullptr));
+    new KateStdinReader(doc.data(), QTextCodec::codecForName("UTF-8"), true, m_pipe[0]);
+
+    writeAll(m_pipe[1], "a\nb\n");
+    QTRY_COMPARE(view->cursorPosition(), KTextEditor::Cursor(2, 0));
+
+    // moved away: stays there
+    view->setCursorPosition(KTextEditor::Cursor(0, 0));
+    writeAll(m_pipe[1], "c\n");
+    QTRY_COMPARE(doc->lines(), 4);
+    QCOMPARE(view->cursorPosition(), KTextEditor::Cursor(0, 0));
+
+    // back at the end: follows again
+    view->setCursorPosition(doc->documentEnd());
+    writeAll(m_pipe[1], "d\n");
+    QTRY_COMPARE(view->cursorPosition(), KTextEditor::Cursor(4, 0));
+}
+
+void KateStdinReaderTest::noUndoHistory()
+{
+    QScopedPointer<KTextEditor::Document> doc(KTextEditor::Editor::instance()->createDocument(nullptr));
+    QScopedPointer<KTextEditor::View> view(doc->createView(nullptr));
+    QAction *undo = view->action("edit_undo");
+    QVERIFY(undo);
+
+    // an edit is undoable
+    doc->insertText(KTextEditor::Cursor(0, 0), QStringLiteral("typed\n"));
+    QVERIFY(undo->isEnabled());
+
+    // the streamed input is not held in the undo history, per block, not only at the end
+    new KateStdinReader(doc.data(), QTextCodec::codecForName("UTF-8"), true, m_pipe[0]);
+    writeAll(m_pipe[1], "a\nb\n");
+    QTRY_COMPARE(doc->text(), QStringLiteral("typed\na\nb\n"));
+    QVERIFY(!undo->isEnabled());
+
+    writeAll(m_pipe[1], "c\n");
+    QTRY_COMPARE(doc->lines(), 5);
+    QVERIFY(!undo->isEnabled());
+}
+
+void KateStdinReaderTest::documentClosed()
+{
+    KTextEditor::Document *doc = KTextEditor::Editor::instance()->createDocument(nullptr);
+    QPointer<KateStdinReader> reader = new KateStdinReader(doc, nullptr, false, m_pipe[0]);
+
+    // the reader dies with its document
+    delete doc;
+    QVERIFY(!reader);
+}
+
+void KateStdinReaderTest::readAll()
+{
+    writeAll(m_pipe[1], "one\r\ntwo\n" + QStringLiteral("ü").toUtf8());
+    ::close(m_pipe[1]);
+    m_pipe[1] = -1;
+
+    QCOMPARE(KateStdinReader::readAll(QTextCodec::codecForName("UTF-8"), m_pipe[0]), QStringLiteral("one\ntwo\nü"));
+}
@@ -0,0 +1,255 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "view_restore_test.h"
+#include "katedocmanager.h"
+#include "katemainwindow.h"
+#include "kateviewmanager.h"
+#include "kateviewspace.h"
+#include "katetabbar.h"
+#include "kateapp.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <ktexteditor/view.h>
+
+#include <QtTestWidgets>
+#include <QClipboard>
+#include <QMenu>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QCommandLineParser>
+
+QTEST_MAIN(KateViewRestoreTest)
+
+static const int DocumentCount = 1000;
+static const int ViewSpaceCount = 4;
+
+void KateViewRestoreTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    // the test relies on lazily restored documents, whatever the user configured
+    KConfigGroup(KSharedConfig::openConfig(), "General").writeEntry("Lazy Document Loading", true);
+
+    m_app = new KateApp(QCommandLineParser());
+}
+
+void KateViewRestoreTest::cleanupTestCase()
+{
+    delete m_app;
+}
+
+void KateViewRestoreTest::restoreLargeSession()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // session with all documents spread over two splitters with two view spaces each
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup openDocuments(&config, "Open Documents");
+    openDocuments.writeEntry("Count", DocumentCount);
+
+    QVector<QStringList> lruLists(ViewSpaceCount);
+    for (int i = 0; i < DocumentCount; ++i) {
+        const QString fileName = dir.path() + QStringLiteral("/file%1.txt").arg(i);
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray("document ") + QByteArray::number(i) + '\n');
+        file.close();
+
+        const QString url = QUrl::fromLocalFile(fileName).toString();
+        KConfigGroup(&config, QStringLiteral("Document %1").arg(i)).writeEntry("URL", url);
+        lruLists[i % ViewSpaceCount] << url;
+    }
+
+    KConfigGroup window(&config, "MainWindow0");
+    window.writeEntry("Active ViewSpace", 2);
+
+    KConfigGroup root(&config, "MainWindow0-Splitter 0");
+    root.writeEntry("Orientation", int(Qt::Horizontal));
+    root.writeEntry("Sizes", QList<int>() << 400 << 400);
+    root.writeEntry("Children", QStringList() << QStringLiteral("MainWindow0-Splitter 1") << QStringLiteral("MainWindow0-Splitter 2"));
+
+    for (int s = 1; s <= 2; ++s) {
+        KConfigGroup splitter(&config, QStringLiteral("MainWindow0-Splitter %1").arg(s));
+        splitter.writeEntry("Orientation", int(Qt::Vertical));
+        splitter.writeEntry("Sizes", QList<int>() << 300 << 300);
+        splitter.writeEntry("Children", QStringList()
+                            << QStringLiteral("MainWindow0-ViewSpace %1").arg(2 * s - 2)
+                            << QStringLiteral("MainWindow0-ViewSpace %1").arg(2 * s - 1));
+    }
+
+    for (int v = 0; v < ViewSpaceCount; ++v) {
+        KConfigGroup viewSpace(&config, QStringLiteral("MainWindow0-ViewSpace %1").arg(v));
+        viewSpace.writeEntry("Documents", lruLists[v]);
+        viewSpace.writeEntry("Active View", lruLists[v].last());
+    }
+
+    // like a session switch in a running window
+    KateMainWindow *mainWindow = m_app->newMainWindow();
+    KateViewManager *viewManager = mainWindow->viewManager();
+    QVERIFY(viewManager->activeView());
+
+    QSignalSpy created(viewManager, SIGNAL(viewCreated(KTextEditor::View*)));
+
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    QElapsedTimer timer;
+    timer.start();
+    docManager->restoreDocumentList(&config);
+    const qint64 documents = timer.nsecsElapsed();
+
+    // the new documents are registered as tabs, the window keeps its view
+    QCOMPARE(created.count(), 0);
+
+    viewManager->restoreViewConfiguration(window);
+    const qint64 total = timer.nsecsElapsed();
+    qDebug() << "ms for the documents:" << (documents / 1000000) << "ms until views are restored:" << (total / 1000000);
+
+    QCOMPARE(docManager->documentList().size(), DocumentCount);
+
+    // only the active view of each view space is there, all tabs are
+    qDebug() << "views created eagerly:" << created.count();
+    QCOMPARE(created.count(), ViewSpaceCount);
+    QCOMPARE(viewManager->views().size(), ViewSpaceCount);
+
+    const QList<KateViewSpace *> viewSpaces = viewManager->findChildren<KateViewSpace *>();
+    QCOMPARE(viewSpaces.size(), ViewSpaceCount);
+    KateViewSpace *activeSpace = nullptr;
+    foreach (KateViewSpace *vs, viewSpaces) {
+        QCOMPARE(vs->lruDocumentList().size(), DocumentCount / ViewSpaceCount);
+        QVERIFY(vs->currentView());
+        if (vs->isActiveSpace()) {
+            activeSpace = vs;
+        }
+    }
+    QVERIFY(activeSpace);
+    QCOMPARE(viewManager->activeView(), activeSpace->currentView());
+    QCOMPARE(viewManager->activeView()->document()->url().toString(), lruLists[2].last());
+
+    // only the shown documents are loaded, plus the first one that was around anyway
+    int loaded = 0;
+    foreach (KTextEditor::Document *doc, docManager->documentList()) {
+        if (docManager->isLoaded(doc)) {
+            ++loaded;
+        }
+    }
+    QCOMPARE(loaded, ViewSpaceCount + 1);
+
+    // activating a tab creates its view and loads the document
+    KTextEditor::Document *doc = activeSpace->lruDocumentList().first();
+    QVERIFY(!docManager->isLoaded(doc));
+    QVERIFY(doc->views().isEmpty());
+    KTextEditor::View *view = viewManager->activateView(doc);
+    QVERIFY(view);
+    QCOMPARE(created.count(), ViewSpaceCount + 1);
+    QCOMPARE(view->document(), doc);
+    QVERIFY(docManager->isLoaded(doc));
+    QCOMPARE(doc->text(), QStringLiteral("document 2\n"));
+
+    delete mainWindow;
+}
+
+void KateViewRestoreTest::placeholderContextMenu()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup(&config, "Open Documents").writeEntry("Count", 2);
+    QStringList urls;
+    for (int i = 0; i < 2; ++i) {
+        const QString fileName = dir.path() + QStringLiteral("/tab%1.txt").arg(i);
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("tab\n");
+        file.close();
+
+        urls << QUrl::fromLocalFile(fileName).toString();
+        KConfigGroup(&config, QStringLiteral("Document %1").arg(i)).writeEntry("URL", urls.last());
+    }
+
+    KConfigGroup window(&config, "MainWindow0");
+    window.writeEntry("Active ViewSpace", 0);
+    KConfigGroup(&config, "MainWindow0-Splitter 0").writeEntry("Children", QStringList() << QStringLiteral("MainWindow0-ViewSpace 0"));
+    KConfigGroup viewSpaceGroup(&config, "MainWindow0-ViewSpace 0");
+    viewSpaceGroup.writeEntry("Documents", urls);
+    viewSpaceGroup.writeEntry("Active View", urls.last());
+
+    // start without the documents of the other tests
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    QVERIFY(docManager->closeAllDocuments());
+
+    KateMainWindow *mainWindow = m_app->newMainWindow();
+    KateViewManager *viewManager = mainWindow->viewManager();
+    docManager->restoreDocumentList(&config);
+    viewManager->restoreViewConfiguration(window);
+
+    // the first document only has a tab
+    KTextEditor::Document *placeholder = docManager->findDocument(QUrl(urls.first()));
+    QVERIFY(placeholder);
+    QVERIFY(!docManager->isLoaded(placeholder));
+    QVERIFY(placeholder->url().isEmpty());
+
+    KateViewSpace *viewSpace = viewManager->activeViewSpace();
+    KateTabBar *tabBar = viewSpace->findChild<KateTabBar *>();
+    QVERIFY(tabBar);
+    // tab ids are handed out in order, there were only a few tabs in this view space
+    int tabId = -1;
+    for (int id = 0; tabId < 0 && id < 100; ++id) {
+        if (tabBar->containsTab(id) && tabBar->tabText(id) == QLatin1String("tab0.txt")) {
+            tabId = id;
+        }
+    }
+    QVERIFY(tabId >= 0);
+
+    // a url change of the placeholder does not clear the tab url
+    emit placeholder->documentUrlChanged(placeholder);
+    QCOMPARE(tabBar->tabUrl(tabId), QUrl(urls.first()));
+
+    // the file actions are enabled, copy the location
+    QApplication::clipboard()->clear();
+    bool actionsEnabled = false;
+    const QString copyText = mainWindow->action("file_copy_filepath")->text();
+    QTimer::singleShot(0, [&actionsEnabled, copyText]() {
+        QMenu *menu = qobject_cast<QMenu *>(QApplication::activePopupWidget());
+        if (!menu) {
+            return;
+        }
+        foreach (QAction *action, menu->actions()) {
+            if (action->text() == copyText) {
+                actionsEnabled = action->isEnabled();
+                menu->setActiveAction(action);
+            }
+        }
+        QTest::keyClick(menu, Qt::Key_Return);
+    });
+    emit tabBar->contextMenuRequest(tabId, tabBar->mapToGlobal(QPoint(0, 0)));
+
+    QTRY_VERIFY(actionsEnabled);
+    QTRY_COMPARE(QApplication::clipboard()->text(), QUrl(urls.first()).toLocalFile());
+
+    // nothing of this needed the document content
+    QVERIFY(!docManager->isLoaded(placeholder));
+
+    delete mainWindow;
+}
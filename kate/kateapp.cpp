@@ -21,6 +21,9 @@
 
 #include "kateviewmanager.h"
 #include "katemainwindow.h"
+#include "katestartuptrace.h"
+#include "katestdinreader.h"
+#include "katehandoff.h"
 
 #include <KConfig>
 #include <KSharedConfig>
@@ -36,6 +39,9 @@
 #include <QTextCodec>
 #include <QApplication>
 #include <QFileOpenEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include "../../urlinfo.h"
 
@@ -53,6 +59,8 @@ KateApp::KateApp(const QCommandLineParser &args)
     , m_adaptor(this)
     , m_pluginManager(this)
     , m_sessionManager(this)
+    , m_handoffServer(nullptr)
+    , m_stdinRead(false)
 {
     /**
      * re-route some signals to application wrapper
@@ -71,6 +79,17 @@ KateApp::KateApp(const QCommandLineParser &args)
 
 KateApp::~KateApp()
 {
+    /**
+     * update the startup trace with everything recorded after the first paint
+     */
+    KateStartupTrace::write();
+
+    /**
+     * stop taking files from other instances, like for dbus below
+     */
+    delete m_handoffServer;
+    m_handoffServer = nullptr;
+
     /**
      * unregister from dbus before we get unusable...
      */
@@ -93,6 +112,12 @@ KateApp *KateApp::self()
     return appSelf;
 }
 
+void KateApp::setStdinText(const QString &text)
+{
+    m_stdinRead = true;
+    m_stdinText = text;
+}
+
 bool KateApp::init()
 {
     // set KATE_PID for use in child processes
@@ -115,6 +140,19 @@ bool KateApp::init()
         QDBusConnection::sessionBus().registerObject(QStringLiteral("/MainApplication"), this);
     }
 
+#ifndef USE_QT_SINGLE_APP
+    // local socket handoff, for starting kates without working dbus
+    m_handoffServer = new KateHandoffServer(this);
+    if (m_handoffServer->listen()) {
+        connect(m_handoffServer, &KateHandoffServer::messageReceived, this, [this](const QString &message) {
+            remoteMessageReceived(message, nullptr);
+        });
+    }
+#endif
+
+    // the startup trace ends with the first paint
+    KateStartupTrace::watchFirstPaint(activeKateMainWindow());
+
     return true;
 }
 
@@ -210,24 +248,11 @@ bool KateApp::startupKate()
         }
     }
 
-    // handle stdin input
-    if (m_args.isSet(QStringLiteral("stdin"))) {
-        QTextStream input(stdin, QIODevice::ReadOnly);
-
-        // set chosen codec
-        if (codec) {
-            input.setCodec(codec);
-        }
-
-        QString line;
-        QString text;
-
-        do {
-            line = input.readLine();
-            text.append(line + QLatin1Char('\n'));
-        } while (!line.isNull());
-
-        openInput(text, codec_name);
+    // handle stdin input, streamed into a new document, unless it was read already
+    if (m_args.isSet(QStringLiteral("stdin")) && m_stdinRead) {
+        openInput(m_stdinText, codec_name);
+    } else if (m_args.isSet(QStringLiteral("stdin"))) {
+        openInputStream(codec, m_args.isSet(QStringLiteral("follow")));
     } else if (doc) {
         activeKateMainWindow()->viewManager()->activateView(doc);
     }
@@ -349,6 +374,25 @@ bool KateApp::setCursor(int line, int column)
     return true;
 }
 
+bool KateApp::openInputStream(QTextCodec *codec, bool follow)
+{
+    activeKateMainWindow()->viewManager()->openUrl(QUrl(), codec ? QString::fromLatin1(codec->name()) : QString(), true);
+
+    if (!activeKateMainWindow()->viewManager()->activeView()) {
+        return false;
+    }
+
+    KTextEditor::Document *doc = activeKateMainWindow()->viewManager()->activeView()->document();
+
+    if (!doc) {
+        return false;
+    }
+
+    // owned by the document, deletes itself once all input is there
+    new KateStdinReader(doc, codec, follow);
+    return true;
+}
+
 bool KateApp::openInput(const QString &text, const QString &encoding)
 {
     activeKateMainWindow()->viewManager()->openUrl(QUrl(), encoding, true);
@@ -371,6 +415,7 @@ KateMainWindow *KateApp::newMainWindow(KConfig *sconfig_, const QString &sgroup_
     KConfig *sconfig = sconfig_ ? sconfig_ : KSharedConfig::openConfig().data();
     QString sgroup = !sgroup_.isEmpty() ? sgroup_ : QStringLiteral("MainWindow0");
 
+    KateStartupTrace::Span span("KateApp::newMainWindow");
     KateMainWindow *mainWindow = new KateMainWindow(sconfig, sgroup);
     mainWindow->show();
 
@@ -464,10 +509,28 @@ void KateApp::remoteMessageReceived(const QString &message, QObject *)
     if (!jsonMessage.isObject())
         return;
 
+    handleRemoteMessage(jsonMessage.object());
+}
+
+QStringList KateApp::handleRemoteMessage(const QJsonObject &message)
+{
+    /**
+     * switch session first, the files shall end up in it
+     */
+    const QString session = message.value(QLatin1String("session")).toString();
+    if (!session.isEmpty()) {
+        sessionManager()->activateSession(session);
+    }
+
+    const QString encoding = message.value(QLatin1String("encoding")).toString();
+    const bool isTempFile = message.value(QLatin1String("tempfile")).toBool();
+    const bool wantTokens = message.value(QLatin1String("tokens")).toBool();
+
     /**
      * open all passed urls
      */
-    const QJsonArray urls = jsonMessage.object().value(QLatin1String("urls")).toArray();
+    QStringList tokens;
+    const QJsonArray urls = message.value(QLatin1String("urls")).toArray();
     Q_FOREACH(QJsonValue urlObject, urls) {
         /**
          * get url meta data
@@ -479,11 +542,28 @@ void KateApp::remoteMessageReceived(const QString &message, QObject *)
         /**
          * open file + set line/column if requested
          */
-        openUrl(url, QString(), false);
+        KTextEditor::Document *doc = openDocUrl(url, encoding, isTempFile);
         if (line >= 0 && column >= 0) {
             setCursor(line, column);
         }
 
+        if (doc && wantTokens) {
+            tokens << QStringLiteral("%1").arg((qptrdiff)doc);
+        }
+    }
+
+    /**
+     * text read from stdin of the sender
+     */
+    if (message.contains(QLatin1String("stdin"))) {
+        openInput(message.value(QLatin1String("stdin")).toString(), encoding);
+    }
+
+    /**
+     * global cursor position from --line / --column
+     */
+    if (message.contains(QLatin1String("line")) || message.contains(QLatin1String("column"))) {
+        setCursor(message.value(QLatin1String("line")).toInt(), message.value(QLatin1String("column")).toInt());
     }
 
     if (auto win = activeKateMainWindow()) {
@@ -492,4 +572,6 @@ void KateApp::remoteMessageReceived(const QString &message, QObject *)
         win->raise();
         win->activateWindow();
     }
+
+    return tokens;
 }
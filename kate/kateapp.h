@@ -40,6 +40,9 @@ class KateDocManager;
 class KateAppCommands;
 class KateAppAdaptor;
 class QCommandLineParser;
+class QTextCodec;
+class QJsonObject;
+class KateHandoffServer;
 
 /**
  * Kate Application
@@ -64,6 +67,14 @@ public:
      */
     bool init();
 
+    /**
+     * Use text already read from stdin instead of streaming stdin, if --stdin is given.
+     * Needed if stdin was read for the handoff to a running instance that didn't take it.
+     * Must be called before init().
+     * @param text text read from stdin
+     */
+    void setStdinText(const QString &text);
+
     /**
      * application destructor
      */
@@ -221,6 +232,29 @@ public:
      */
     bool openInput(const QString &text, const QString &encoding);
 
+    /**
+     * helper to handle stdin input without reading it all first
+     * open a new document/view, the input is streamed into it while the event loop runs
+     * @param codec codec of the input, nullptr for the locale codec
+     * @param follow keep the view at the end while input arrives
+     * @return success
+     */
+    bool openInputStream(QTextCodec *codec, bool follow);
+
+    /**
+     * Handle the files & co. a starting kate hands over to this instance.
+     * The message is a JSON object, all keys are optional:
+     *  - "urls": list of objects with "url", "line" and "column", line and column are -1 if not given
+     *  - "encoding", "tempfile": apply to all urls
+     *  - "session": session to activate first
+     *  - "stdin": text to open in a new document
+     *  - "line", "column": cursor position to set at the end
+     *  - "tokens": return the tokens of the opened documents, for a blocking kate
+     * @param message message to handle
+     * @return tokens of the opened documents, if requested
+     */
+    QStringList handleRemoteMessage(const QJsonObject &message);
+
     //
     // KTextEditor::Application interface, called by wrappers via invokeMethod
     //
@@ -322,8 +356,9 @@ public Q_SLOTS:
 
     /**
      * A message is received from an external instance, if we use QtSingleApplication
+     * or the local socket handoff
      *
-     * \p message is a serialized message (at the moment just the file list separated by ';')
+     * \p message is a serialized JSON message, see handleRemoteMessage()
      * \p socket is the QLocalSocket used for the communication
      */
     void remoteMessageReceived(const QString &message, QObject *socket);
@@ -369,6 +404,17 @@ private:
      * session manager
      */
     KateSessionManager m_sessionManager;
+
+    /**
+     * local socket handoff, if D-Bus is not around or too slow
+     */
+    KateHandoffServer *m_handoffServer;
+
+    /**
+     * stdin text read before, see setStdinText()
+     */
+    bool m_stdinRead;
+    QString m_stdinText;
 };
 
 #endif
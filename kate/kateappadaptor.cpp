@@ -26,6 +26,10 @@
 #include "katedebug.h"
 #include <KWindowSystem>
 
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
 KateAppAdaptor::KateAppAdaptor(KateApp *app)
     : QDBusAbstractAdaptor(app)
     , m_app(app)
@@ -113,6 +117,41 @@ int KateAppAdaptor::desktopNumber()
     return appInfo.desktop();
 }
 
+QVariantMap KateAppAdaptor::instanceInfo(const QString &activity)
+{
+    QVariantMap info;
+    info.insert(QStringLiteral("session"), activeSession());
+    info.insert(QStringLiteral("onActivity"), activity.isEmpty() || m_app->isOnActivity(activity));
+
+    if (KateMainWindow *win = m_app->activeKateMainWindow()) {
+        KWindowInfo appInfo(win->winId(), NET::WMDesktop);
+        info.insert(QStringLiteral("desktop"), appInfo.desktop());
+    }
+    return info;
+}
+
+QStringList KateAppAdaptor::handleMessage(const QString &message)
+{
+    const QJsonDocument jsonMessage = QJsonDocument::fromJson(message.toUtf8());
+    if (!jsonMessage.isObject()) {
+        return QStringList();
+    }
+
+    /**
+     * only a blocking kate waits for the tokens, don't let the others wait for the documents to load
+     */
+    const QJsonObject object = jsonMessage.object();
+    if (object.value(QLatin1String("tokens")).toBool()) {
+        return m_app->handleRemoteMessage(object);
+    }
+
+    KateApp *app = m_app;
+    QTimer::singleShot(0, app, [app, object]() {
+        app->handleRemoteMessage(object);
+    });
+    return QStringList();
+}
+
 QString KateAppAdaptor::activeSession()
 {
     return m_app->sessionManager()->activeSession()->name();
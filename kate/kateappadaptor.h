@@ -103,6 +103,21 @@ public Q_SLOTS:
 
     int desktopNumber();
 
+    /**
+     * all a starting kate needs to know to decide about reusing this instance, in one call
+     * @param activity current activity, may be empty
+     * @return map with "session" (string), "onActivity" (bool) and "desktop" (int)
+     */
+    QVariantMap instanceInfo(const QString &activity);
+
+    /**
+     * open files & co. handed over by a starting kate in one call, see KateApp::handleRemoteMessage()
+     * if no tokens are requested, the work is queued and the call returns at once
+     * @param message JSON message
+     * @return tokens of the opened documents, if requested
+     */
+    QStringList handleMessage(const QString &message);
+
     /**
      * activate this kate instance
      */
@@ -179,6 +179,14 @@ KateConfigDialog::KateConfigDialog(KateMainWindow *parent, KTextEditor::View *vi
     sessionConfigUi->restoreVC->setChecked( cgGeneral.readEntry("Restore Window Configuration", true) );
     connect(sessionConfigUi->restoreVC, &QCheckBox::toggled, this, &KateConfigDialog::slotChanged);
 
+    // lazy document loading
+    sessionConfigUi->lazyLoad->setChecked( cgGeneral.readEntry("Lazy Document Loading", true) );
+    connect(sessionConfigUi->lazyLoad, &QCheckBox::toggled, this, &KateConfigDialog::slotChanged);
+
+    // deferred plugin loading
+    sessionConfigUi->deferredPlugins->setChecked( cgGeneral.readEntry("Deferred Plugin Loading", true) );
+    connect(sessionConfigUi->deferredPlugins, &QCheckBox::toggled, this, &KateConfigDialog::slotChanged);
+
     sessionConfigUi->spinBoxRecentFilesCount->setValue(recentFilesMaxCount());
     connect(sessionConfigUi->spinBoxRecentFilesCount, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &KateConfigDialog::slotChanged);
 
@@ -209,6 +217,9 @@ KateConfigDialog::KateConfigDialog(KateMainWindow *parent, KTextEditor::View *vi
     item->setHeader(i18n("Plugin Manager"));
     item->setIcon(QIcon::fromTheme(QStringLiteral("preferences-plugin")));
 
+    // config pages of deferred plugins are needed now
+    KateApp::self()->pluginManager()->loadDeferredPlugins();
+
     KatePluginList &pluginList(KateApp::self()->pluginManager()->pluginList());
     foreach(const KatePluginInfo & plugin, pluginList) {
         if (plugin.load) {
@@ -329,6 +340,10 @@ void KateConfigDialog::slotApply()
 
         cg.writeEntry("Restore Window Configuration", sessionConfigUi->restoreVC->isChecked());
 
+        cg.writeEntry("Lazy Document Loading", sessionConfigUi->lazyLoad->isChecked());
+
+        cg.writeEntry("Deferred Plugin Loading", sessionConfigUi->deferredPlugins->isChecked());
+
         cg.writeEntry("Recent File List Entry Count", sessionConfigUi->spinBoxRecentFilesCount->value());
 
         if (sessionConfigUi->startNewSessionRadioButton->isChecked()) {
@@ -0,0 +1,532 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katediff.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <climits>
+#include <string.h>
+
+namespace
+{
+
+/**
+ * Searching the middle of a range costs more than this: take the point reached furthest instead.
+ * The difference might not be the shortest one then, but huge unrelated inputs stay fast.
+ */
+const int TooExpensive = 4096;
+
+/**
+ * One line, the line feed included, if there is one.
+ */
+struct Line {
+    int begin;
+    int length;
+};
+
+/**
+ * A block of changed lines, deleted lines of the old text replaced by inserted ones of the new text.
+ */
+struct Change {
+    int oldLine;
+    int newLine;
+    int deleted;
+    int inserted;
+};
+
+QVector<Line> splitLines(const QByteArray &text)
+{
+    QVector<Line> lines;
+    const char *data = text.constData();
+    const int size = text.size();
+    int begin = 0;
+    while (begin < size) {
+        const char *lineFeed = static_cast<const char *>(memchr(data + begin, '\n', size - begin));
+        const int length = lineFeed ? int(lineFeed - data) - begin + 1 : size - begin;
+        lines.append({begin, length});
+        begin += length;
+    }
+    return lines;
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+}
+
+/**
+ * Line content for diff -b: runs of white space are one space, trailing white space and the line feed are dropped.
+ * Only lines that change are copied.
+ */
+QByteArray collapseSpace(const char *data, int length)
+{
+    if (length > 0 && data[length - 1] == '\n') {
+        --length;
+    }
+
+    bool plain = length == 0 || !isSpace(data[length - 1]);
+    for (int i = 0; plain && i < length; ++i) {
+        plain = !isSpace(data[i]) || (data[i] == ' ' && (i + 1 == length || !isSpace(data[i + 1])));
+    }
+    if (plain) {
+        return QByteArray::fromRawData(data, length);
+    }
+
+    QByteArray result;
+    result.reserve(length);
+    int i = 0;
+    while (i < length) {
+        if (!isSpace(data[i])) {
+            result.append(data[i++]);
+            continue;
+        }
+
+        while (i < length && isSpace(data[i])) {
+            ++i;
+        }
+        if (i < length) {
+            result.append(' ');
+        }
+    }
+    return result;
+}
+
+/**
+ * Number the lines, equal lines get equal numbers, the texts must outlive the numbering.
+ */
+class LineNumbering
+{
+public:
+    explicit LineNumbering(bool ignoreSpaceChange)
+        : m_ignoreSpaceChange(ignoreSpaceChange)
+    {
+    }
+
+    QVector<int> number(const QByteArray &text, const QVector<Line> &lines)
+    {
+        QVector<int> ids;
+        ids.reserve(lines.size());
+        for (const Line &line : lines) {
+            const char *data = text.constData() + line.begin;
+            const QByteArray key = m_ignoreSpaceChange ? collapseSpace(data, line.length) : QByteArray::fromRawData(data, line.length);
+            const auto it = m_ids.constFind(key);
+            if (it != m_ids.constEnd()) {
+                ids.append(it.value());
+            } else {
+                ids.append(m_ids.size());
+                m_ids.insert(key, m_ids.size());
+            }
+        }
+        return ids;
+    }
+
+private:
+    const bool m_ignoreSpaceChange;
+    QHash<QByteArray, int> m_ids;
+};
+
+/**
+ * Marks the changed lines of two numbered texts, see E. Myers, An O(ND) Difference Algorithm and Its Variations.
+ */
+class Comparison
+{
+public:
+    Comparison(const QVector<int> &a, const QVector<int> &b)
+        : m_a(a)
+        , m_b(b)
+        , m_changedA(a.size(), 0)
+        , m_changedB(b.size(), 0)
+        , m_offset(b.size() + 1)
+        , m_forward(a.size() + b.size() + 3)
+        , m_backward(a.size() + b.size() + 3)
+    {
+    }
+
+    void run()
+    {
+        struct Range {
+            int xoff, xlim, yoff, ylim;
+        };
+
+        QVector<Range> todo;
+        todo.append({0, m_a.size(), 0, m_b.size()});
+        while (!todo.isEmpty()) {
+            Range r = todo.takeLast();
+
+            // common head and tail lines are no changes
+            while (r.xoff < r.xlim && r.yoff < r.ylim && m_a[r.xoff] == m_b[r.yoff]) {
+                ++r.xoff;
+                ++r.yoff;
+            }
+            while (r.xoff < r.xlim && r.yoff < r.ylim && m_a[r.xlim - 1] == m_b[r.ylim - 1]) {
+                --r.xlim;
+                --r.ylim;
+            }
+
+            if (r.xoff == r.xlim) {
+                for (int y = r.yoff; y < r.ylim; ++y) {
+                    m_changedB[y] = 1;
+                }
+            } else if (r.yoff == r.ylim) {
+                for (int x = r.xoff; x < r.xlim; ++x) {
+                    m_changedA[x] = 1;
+                }
+            } else {
+                int xmid, ymid;
+                findMiddle(r.xoff, r.xlim, r.yoff, r.ylim, xmid, ymid);
+                todo.append({xmid, r.xlim, ymid, r.ylim});
+                todo.append({r.xoff, xmid, r.yoff, ymid});
+            }
+        }
+
+        slideChanges(m_changedA, m_changedB, m_a);
+        slideChanges(m_changedB, m_changedA, m_b);
+    }
+
+    QVector<Change> changes() const
+    {
+        QVector<Change> result;
+        const int n = m_a.size();
+        const int m = m_b.size();
+        int x = 0;
+        int y = 0;
+        while (x < n || y < m) {
+            if ((x < n && m_changedA[x]) || (y < m && m_changedB[y])) {
+                const int oldLine = x;
+                const int newLine = y;
+                while (x < n && m_changedA[x]) {
+                    ++x;
+                }
+                while (y < m && m_changedB[y]) {
+                    ++y;
+                }
+                result.append({oldLine, newLine, x - oldLine, y - newLine});
+            } else {
+                ++x;
+                ++y;
+            }
+        }
+        return result;
+    }
+
+private:
+    /**
+     * Find a point on a shortest edit path through the range, searching from both ends at once.
+     * Diagonal k holds the points with x - y == k, the vectors hold the furthest x reached on each.
+     */
+    void findMiddle(int xoff, int xlim, int yoff, int ylim, int &xmid, int &ymid)
+    {
+        int *fd = m_forward.data() + m_offset;
+        int *bd = m_backward.data() + m_offset;
+
+        const int dmin = xoff - ylim;
+        const int dmax = xlim - yoff;
+        const int fmid = xoff - yoff;
+        const int bmid = xlim - ylim;
+        const bool odd = (fmid - bmid) & 1;
+        int fmin = fmid, fmax = fmid;
+        int bmin = bmid, bmax = bmid;
+        fd[fmid] = xoff;
+        bd[bmid] = xlim;
+
+        for (int cost = 1;; ++cost) {
+            // one more step forward on each diagonal
+            if (fmin > dmin) {
+                fd[--fmin - 1] = -1;
+            } else {
+                ++fmin;
+            }
+            if (fmax < dmax) {
+                fd[++fmax + 1] = -1;
+            } else {
+                --fmax;
+            }
+            for (int d = fmax; d >= fmin; d -= 2) {
+                const int low = fd[d - 1];
+                const int high = fd[d + 1];
+                int x = (low < high) ? high : low + 1;
+                int y = x - d;
+                while (x < xlim && y < ylim && m_a[x] == m_b[y]) {
+                    ++x;
+                    ++y;
+                }
+                fd[d] = x;
+                if (odd && bmin <= d && d <= bmax && bd[d] <= x) {
+                    xmid = x;
+                    ymid = y;
+                    return;
+                }
+            }
+
+            // one more step backward on each diagonal
+            if (bmin > dmin) {
+                bd[--bmin - 1] = INT_MAX;
+            } else {
+                ++bmin;
+            }
+            if (bmax < dmax) {
+                bd[++bmax + 1] = INT_MAX;
+            } else {
+                --bmax;
+            }
+            for (int d = bmax; d >= bmin; d -= 2) {
+                const int low = bd[d - 1];
+                const int high = bd[d + 1];
+                int x = (low < high) ? low : high - 1;
+                int y = x - d;
+                while (x > xoff && y > yoff && m_a[x - 1] == m_b[y - 1]) {
+                    --x;
+                    --y;
+                }
+                bd[d] = x;
+                if (!odd && fmin <= d && d <= fmax && x <= fd[d]) {
+                    xmid = x;
+                    ymid = y;
+                    return;
+                }
+            }
+
+            if (cost >= TooExpensive) {
+                // split where the forward search got furthest
+                int best = -1;
+                for (int d = fmax; d >= fmin; d -= 2) {
+                    const int x = qMin(fd[d], xlim);
+                    const int y = x - d;
+                    const bool inside = y >= yoff && y <= ylim && x + y > xoff + yoff && x + y < xlim + ylim;
+                    if (inside && x + y > best) {
+                        best = x + y;
+                        xmid = x;
+                        ymid = y;
+                    }
+                }
+                if (best >= 0) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * Slide each group of changed lines as far up as possible, joining groups on the way,
+     * then as far down as possible, until it stops growing. Last, if the group ends up
+     * further down than the changes in the other text it corresponds to, move it back to them.
+     * A group can slide if the line before it equals its last line (or the line after it its first one).
+     * @param changed changed flags of the text
+     * @param other changed flags of the other text, used to track the corresponding lines
+     * @param ids line numbers of the text
+     */
+    static void slideChanges(QVector<char> &changed, const QVector<char> &other, const QVector<int> &ids)
+    {
+        const int n = changed.size();
+        const int m = other.size();
+        int i = 0; // line in this text
+        int j = 0; // corresponding line in the other text
+
+        while (true) {
+            // next group, unchanged lines pair up with unchanged lines of the other text
+            while (i < n && !changed[i]) {
+                while (j < m && other[j]) {
+                    ++j;
+                }
+                ++i;
+                ++j;
+            }
+            if (i == n) {
+                break;
+            }
+
+            int start = i;
+            while (i < n && changed[i]) {
+                ++i;
+            }
+            while (j < m && other[j]) {
+                ++j;
+            }
+
+            int corresponding;
+            int length;
+            do {
+                length = i - start;
+
+                // up, joins the groups before
+                while (start > 0 && ids[start - 1] == ids[i - 1]) {
+                    changed[--start] = 1;
+                    changed[--i] = 0;
+                    while (start > 0 && changed[start - 1]) {
+                        --start;
+                    }
+                    --j;
+                    while (j >= 0 && other[j]) {
+                        --j;
+                    }
+                }
+
+                // end of the group, if it ends together with changes in the other text
+                corresponding = (j > 0 && other[j - 1]) ? i : n;
+
+                // down, joins the groups after
+                while (i < n && ids[start] == ids[i]) {
+                    changed[start++] = 0;
+                    changed[i++] = 1;
+                    while (i < n && changed[i]) {
+                        ++i;
+                    }
+                    ++j;
+                    while (j < m && other[j]) {
+                        ++j;
+                        corresponding = i;
+                    }
+                }
+            } while (length != i - start);
+
+            // back up to the changes of the other text
+            while (corresponding < i) {
+                changed[--start] = 1;
+                changed[--i] = 0;
+                --j;
+                while (j >= 0 && other[j]) {
+                    --j;
+                }
+            }
+        }
+    }
+
+private:
+    const QVector<int> &m_a;
+    const QVector<int> &m_b;
+    QVector<char> m_changedA;
+    QVector<char> m_changedB;
+    const int m_offset;
+    QVector<int> m_forward;
+    QVector<int> m_backward;
+};
+
+/**
+ * Line range of a hunk header: start,count, the line before for empty ranges, no count for one line.
+ */
+QByteArray range(int start, int count)
+{
+    if (count == 0) {
+        return QByteArray::number(start) + ",0";
+    }
+    if (count == 1) {
+        return QByteArray::number(start + 1);
+    }
+    return QByteArray::number(start + 1) + ',' + QByteArray::number(count);
+}
+
+void appendLine(QByteArray &out, char prefix, const QByteArray &text, const Line &line)
+{
+    out.append(prefix);
+    out.append(text.constData() + line.begin, line.length);
+    if (text.at(line.begin + line.length - 1) != '\n') {
+        out.append("\n\\ No newline at end of file\n");
+    }
+}
+
+}
+
+QByteArray KateDiff::unified(const QByteArray &oldText, const QByteArray &newText,
+                             const QByteArray &oldHeader, const QByteArray &newHeader,
+                             Options options, int context)
+{
+    const QVector<Line> oldLines = splitLines(oldText);
+    const QVector<Line> newLines = splitLines(newText);
+
+    LineNumbering numbering(options.testFlag(IgnoreSpaceChange));
+    const QVector<int> oldIds = numbering.number(oldText, oldLines);
+    const QVector<int> newIds = numbering.number(newText, newLines);
+
+    Comparison comparison(oldIds, newIds);
+    comparison.run();
+    const QVector<Change> changes = comparison.changes();
+    if (changes.isEmpty()) {
+        return QByteArray();
+    }
+
+    QByteArray out;
+    out.append("--- ").append(oldHeader).append('\n');
+    out.append("+++ ").append(newHeader).append('\n');
+
+    for (int first = 0; first < changes.size();) {
+        // changes with at most twice the context in between share a hunk
+        int last = first;
+        while (last + 1 < changes.size()
+               && changes[last + 1].oldLine - (changes[last].oldLine + changes[last].deleted) <= 2 * context) {
+            ++last;
+        }
+
+        const Change &head = changes[first];
+        const Change &tail = changes[last];
+        const int oldBegin = qMax(0, head.oldLine - context);
+        const int newBegin = head.newLine - (head.oldLine - oldBegin);
+        const int oldEnd = qMin(oldLines.size(), tail.oldLine + tail.deleted + context);
+        const int newEnd = tail.newLine + tail.inserted + (oldEnd - tail.oldLine - tail.deleted);
+
+        out.append("@@ -").append(range(oldBegin, oldEnd - oldBegin));
+        out.append(" +").append(range(newBegin, newEnd - newBegin)).append(" @@\n");
+
+        // unchanged lines are taken from the old text, like diff does
+        int line = oldBegin;
+        for (int i = first; i <= last; ++i) {
+            const Change &change = changes[i];
+            for (; line < change.oldLine; ++line) {
+                appendLine(out, ' ', oldText, oldLines[line]);
+            }
+            for (int k = 0; k < change.deleted; ++k) {
+                appendLine(out, '-', oldText, oldLines[change.oldLine + k]);
+            }
+            for (int k = 0; k < change.inserted; ++k) {
+                appendLine(out, '+', newText, newLines[change.newLine + k]);
+            }
+            line = change.oldLine + change.deleted;
+        }
+        for (; line < oldEnd; ++line) {
+            appendLine(out, ' ', oldText, oldLines[line]);
+        }
+
+        first = last + 1;
+    }
+
+    return out;
+}
+
+QByteArray KateDiff::header(const QString &name, const QDateTime &time)
+{
+    QByteArray result = name.toUtf8();
+    if (!time.isValid()) {
+        return result;
+    }
+
+    // 2019-01-31 12:34:56.789000000 +0100, diff has nanoseconds
+    const int offset = time.offsetFromUtc();
+    const int minutes = qAbs(offset) / 60;
+    result.append('\t');
+    result.append(time.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")).toLatin1());
+    result.append("000000 ");
+    result.append(offset < 0 ? '-' : '+');
+    result.append(QByteArray::number(minutes / 60).rightJustified(2, '0'));
+    result.append(QByteArray::number(minutes % 60).rightJustified(2, '0'));
+    return result;
+}
@@ -0,0 +1,82 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_DIFF_H
+#define KATE_DIFF_H
+
+#include "kateprivate_export.h"
+
+#include <QByteArray>
+#include <QFlags>
+
+class QDateTime;
+class QString;
+
+/**
+ * Line based comparison of two texts, with the output of diff -u.
+ *
+ * The lines are mapped to numbers first, equal lines get equal numbers,
+ * the comparison itself only looks at these numbers. Common leading and
+ * trailing lines are skipped, the rest is compared with the O(ND) algorithm
+ * of Myers in linear space. Afterwards groups of changed lines are slid
+ * to the same positions GNU diff picks, for ambiguous alignments the output
+ * is the one of diff -u. Only for very repetitive input diff might align
+ * equally long differences another way, it discards confusing lines first.
+ *
+ * Works on bytes, no decoding needed, safe to use in any thread.
+ */
+class KATE_TESTS_EXPORT KateDiff
+{
+public:
+    enum Option {
+        NoOptions = 0,
+        /**
+         * ignore changes in the amount of white space, like diff -b
+         */
+        IgnoreSpaceChange = 1
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    /**
+     * Compare two texts.
+     * @param oldText text shown with "-"
+     * @param newText text shown with "+"
+     * @param oldHeader text of the "---" line, see header()
+     * @param newHeader text of the "+++" line, see header()
+     * @param options comparison options
+     * @param context number of unchanged lines around the changes
+     * @return unified diff, empty if the texts are equal
+     */
+    static QByteArray unified(const QByteArray &oldText, const QByteArray &newText,
+                              const QByteArray &oldHeader, const QByteArray &newHeader,
+                              Options options = NoOptions, int context = 3);
+
+    /**
+     * Header text like diff writes it: the name, a tab and the time stamp.
+     * @param name file name or other label
+     * @param time modification time, left out if invalid
+     * @return header text, UTF-8
+     */
+    static QByteArray header(const QString &name, const QDateTime &time);
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(KateDiff::Options)
+
+#endif
@@ -25,6 +25,7 @@
 #include "kateviewmanager.h"
 #include "katesavemodifieddialog.h"
 #include "katedebug.h"
+#include "katestartuptrace.h"
 
 #include <ktexteditor/view.h>
 #include <ktexteditor/editor.h>
@@ -38,6 +39,8 @@
 
 #include <QByteArray>
 #include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
 #include <QHash>
 #include <QTextCodec>
 #include <QTimer>
@@ -45,16 +48,72 @@
 #include <QListView>
 #include <QProgressDialog>
 #include <QFileDialog>
+#include <QStandardPaths>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * Write stored config entries into a config group.
+ */
+static void writeEntries(KConfigGroup &group, const QMap<QString, QString> &entries)
+{
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        group.writeEntry(it.key(), it.value());
+    }
+}
+
+/**
+ * maximal number of cached canonical paths
+ */
+static const int MaxCanonicalPaths = 10000;
+
+/**
+ * maximal number of bytes read ahead of the documents opened in the GUI thread
+ */
+static const qint64 PrefetchBudget = 64 * 1024 * 1024;
+
+/**
+ * Reads a local file in a worker thread.
+ * KTextEditor reads, decodes and checksums the file itself on open,
+ * the prefetch ensures that this read is served from the page cache.
+ */
+class KateDocumentPrefetch : public QRunnable
+{
+public:
+    explicit KateDocumentPrefetch(const QString &fileName)
+        : m_fileName(fileName)
+    {
+    }
+
+    void run() override
+    {
+        QFile file(m_fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return;
+        }
+
+        QByteArray buffer(256 * 1024, Qt::Uninitialized);
+        while (file.read(buffer.data(), buffer.size()) > 0) {
+        }
+    }
+
+private:
+    const QString m_fileName;
+};
 
 KateDocManager::KateDocManager(QObject *parent)
     : QObject(parent)
-    , m_metaInfos(QStringLiteral("katemetainfos"), KConfig::NoGlobals)
+    , m_metaInfos(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/metainfos"))
     , m_saveMetaInfos(true)
     , m_daysMetaInfos(0)
 {
     // set our application wrapper
     KTextEditor::Editor::instance()->setApplication(KateApp::self()->wrapper());
 
+    // take over the meta-information of older versions
+    importMetaInfos();
+
     // create one doc, we always have at least one around!
     createDoc();
 }
@@ -66,16 +125,9 @@ KateDocManager::~KateDocManager()
         // saving meta-infos when file is saved is not enough, we need to do it once more at the end
         saveMetaInfos(m_docList);
 
-        // purge saved filesessions
+        // purge saved filesessions, the store writes all pending changes on destruction
         if (m_daysMetaInfos > 0) {
-            const QStringList groups = m_metaInfos.groupList();
-            QDateTime def(QDate(1970, 1, 1));
-            for (QStringList::const_iterator it = groups.begin(); it != groups.end(); ++it) {
-                QDateTime last = m_metaInfos.group(*it).readEntry("Time", def);
-                if (last.daysTo(QDateTime::currentDateTimeUtc()) > m_daysMetaInfos) {
-                    m_metaInfos.deleteGroup(*it);
-                }
-            }
+            m_metaInfos.removeOlderThan(m_daysMetaInfos);
         }
     }
 
@@ -96,8 +148,15 @@ KTextEditor::Document *KateDocManager::createDoc(const KateDocumentInfo &docInfo
     m_docList.append(doc);
     m_docInfos.insert(doc, new KateDocumentInfo(docInfo));
 
+    // placeholder of a lazy restored document, plugins only see the document itself, tell them the url it will load
+    if (docInfo.pendingLoad) {
+        doc->setProperty("pendingUrl", docInfo.pendingUrl);
+    }
+    indexDocument(doc);
+
     // connect internal signals...
     connect(doc, &KTextEditor::Document::modifiedChanged, this, &KateDocManager::slotModChanged1);
+    connect(doc, &KTextEditor::Document::documentUrlChanged, this, &KateDocManager::slotDocumentUrlChanged);
     connect(doc, SIGNAL(modifiedOnDisk(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)),
             this, SLOT(slotModifiedOnDisc(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)));
 
@@ -120,19 +179,122 @@ KTextEditor::Document *KateDocManager::findDocument(const QUrl &url) const
 
     // Resolve symbolic links for local files (done anyway in KTextEditor)
     if (u.isLocalFile()) {
-        QString normalizedUrl = QFileInfo(u.toLocalFile()).canonicalFilePath();
+        QString normalizedUrl = canonicalFilePath(u.toLocalFile());
         if (!normalizedUrl.isEmpty()) {
             u = QUrl::fromLocalFile(normalizedUrl);
         }
     }
 
-    foreach(KTextEditor::Document * it, m_docList) {
-        if (it->url() == u) {
-            return it;
+    const auto it = m_urlIndex.constFind(u);
+    return (it != m_urlIndex.constEnd()) ? it.value().first() : nullptr;
+}
+
+QString KateDocManager::canonicalFilePath(const QString &path) const
+{
+    const auto it = m_canonicalPaths.constFind(path);
+    if (it != m_canonicalPaths.constEnd()) {
+        return it.value();
+    }
+
+    // don't cache non-existing files, they might be created later
+    const QString canonical = QFileInfo(path).canonicalFilePath();
+    if (!canonical.isEmpty()) {
+        if (m_canonicalPaths.size() >= MaxCanonicalPaths) {
+            m_canonicalPaths.clear();
         }
+        m_canonicalPaths.insert(path, canonical);
+    }
+    return canonical;
+}
+
+void KateDocManager::indexDocument(KTextEditor::Document *doc)
+{
+    unindexDocument(doc);
+
+    const QUrl url = documentUrl(doc);
+    if (url.isEmpty()) {
+        return;
+    }
+
+    // first document with some url wins, like the linear search did before
+    m_indexedUrls.insert(doc, url);
+    m_urlIndex[url].append(doc);
+}
+
+void KateDocManager::unindexDocument(KTextEditor::Document *doc)
+{
+    const QUrl url = m_indexedUrls.take(doc);
+    if (url.isEmpty()) {
+        return;
+    }
+
+    // another document with the same url takes over, if any
+    auto it = m_urlIndex.find(url);
+    if (it == m_urlIndex.end()) {
+        return;
+    }
+    it.value().removeOne(doc);
+    if (it.value().isEmpty()) {
+        m_urlIndex.erase(it);
+    }
+}
+
+void KateDocManager::slotDocumentUrlChanged(KTextEditor::Document *doc)
+{
+    m_canonicalPaths.clear();
+    indexDocument(doc);
+}
+
+KateDocumentInfo *KateDocManager::pendingInfo(KTextEditor::Document *doc) const
+{
+    KateDocumentInfo *info = m_docInfos.value(doc);
+    return (info && info->pendingLoad) ? info : nullptr;
+}
+
+bool KateDocManager::isLoaded(KTextEditor::Document *doc) const
+{
+    return !pendingInfo(doc);
+}
+
+QUrl KateDocManager::documentUrl(KTextEditor::Document *doc) const
+{
+    if (KateDocumentInfo *info = pendingInfo(doc)) {
+        return info->pendingUrl;
+    }
+    return doc->url();
+}
+
+QString KateDocManager::documentName(KTextEditor::Document *doc) const
+{
+    if (KateDocumentInfo *info = pendingInfo(doc)) {
+        return info->pendingUrl.fileName();
+    }
+    return doc->documentName();
+}
+
+void KateDocManager::loadDocument(KTextEditor::Document *doc)
+{
+    KateDocumentInfo *info = pendingInfo(doc);
+    if (!info) {
+        return;
     }
 
-    return nullptr;
+    /**
+     * replay the session config we kept for this document, this finally loads the file
+     */
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup cg(&config, "Document");
+    writeEntries(cg, info->pendingConfig);
+
+    info->pendingLoad = false;
+    info->pendingUrl.clear();
+    info->pendingConfig.clear();
+    doc->setProperty("pendingUrl", QVariant());
+
+    connect(doc, SIGNAL(completed()), this, SLOT(documentOpened()));
+    connect(doc, &KParts::ReadOnlyPart::canceled, this, &KateDocManager::documentOpened);
+
+    doc->readSessionConfig(cg);
 }
 
 QList<KTextEditor::Document *> KateDocManager::openUrls(const QList<QUrl> &urls, const QString &encoding, bool isTempFile, const KateDocumentInfo &docInfo)
@@ -141,10 +303,39 @@ QList<KTextEditor::Document *> KateDocManager::openUrls(const QList<QUrl> &urls,
 
     emit aboutToCreateDocuments();
 
-    foreach(const QUrl & url, urls) {
-        docs << openUrl(url, encoding, isTempFile, docInfo);
+    /**
+     * for many files, read the local ones ahead in worker threads while the
+     * GUI thread creates the documents, stay within the prefetch budget
+     */
+    QVector<qint64> prefetchSizes(urls.size(), 0);
+    qint64 prefetchedBytes = 0;
+    int prefetched = (urls.size() > 1) ? 0 : urls.size();
+
+    for (int i = 0; i < urls.size(); ++i) {
+        for (; prefetched < urls.size() && prefetchedBytes < PrefetchBudget; ++prefetched) {
+            const QUrl &url = urls.at(prefetched);
+            // already open documents are not read again
+            if (!url.isLocalFile() || findDocument(url)) {
+                continue;
+            }
+
+            const QFileInfo fi(url.toLocalFile());
+            if (!fi.isFile() || fi.size() > PrefetchBudget) {
+                continue;
+            }
+
+            prefetchSizes[prefetched] = fi.size();
+            prefetchedBytes += fi.size();
+            m_prefetchPool.start(new KateDocumentPrefetch(fi.filePath()));
+        }
+
+        docs << openUrl(urls.at(i), encoding, isTempFile, docInfo);
+        prefetchedBytes -= prefetchSizes.at(i);
     }
 
+    // all documents are there, drop prefetches that did not start yet, running ones just finish
+    m_prefetchPool.clear();
+
     emit documentsCreated(docs);
 
     return docs;
@@ -169,6 +360,11 @@ KTextEditor::Document *KateDocManager::openUrl(const QUrl &url, const QString &e
     // always new document if url is empty...
     if (!u.isEmpty()) {
         doc = findDocument(u);
+
+        // explicit open of a lazy restored document, load it now
+        if (doc) {
+            loadDocument(doc);
+        }
     }
 
     if (!doc) {
@@ -246,6 +442,7 @@ bool KateDocManager::closeDocuments(const QList<KTextEditor::Document *> &docume
         emit documentWillBeDeleted(doc);
 
         // really delete the document and its infos
+        unindexDocument(doc);
         delete m_docInfos.take(doc);
         delete m_docList.takeAt(m_docList.indexOf(doc));
 
@@ -255,6 +452,9 @@ bool KateDocManager::closeDocuments(const QList<KTextEditor::Document *> &docume
         last++;
     }
 
+    // closed files might be renamed or deleted now
+    m_canonicalPaths.clear();
+
     /**
      * never ever empty the whole document list
      * do this before documentsDeleted is emitted, to have no flicker
@@ -424,13 +624,20 @@ void KateDocManager::saveDocumentList(KConfig *config)
     int i = 0;
     foreach(KTextEditor::Document * doc, m_docList) {
         KConfigGroup cg(config, QStringLiteral("Document %1").arg(i));
-        doc->writeSessionConfig(cg);
+        if (KateDocumentInfo *info = pendingInfo(doc)) {
+            // never loaded, keep what we restored
+            writeEntries(cg, info->pendingConfig);
+        } else {
+            doc->writeSessionConfig(cg);
+        }
         i++;
     }
 }
 
 void KateDocManager::restoreDocumentList(KConfig *config)
 {
+    KateStartupTrace::Span span("KateDocManager::restoreDocumentList");
+
     KConfigGroup openDocGroup(config, "Open Documents");
     unsigned int count = openDocGroup.readEntry("Count", 0);
 
@@ -445,14 +652,39 @@ void KateDocManager::restoreDocumentList(KConfig *config)
     progress.setCancelButton(nullptr);
     progress.setRange(0, count);
 
+    /**
+     * in lazy mode only placeholders are registered, they are loaded once shown
+     * the first document is already around, just load it
+     */
+    const bool lazy = KConfigGroup(KSharedConfig::openConfig(), "General").readEntry("Lazy Document Loading", true);
+
+    /**
+     * one batch, the view managers register all documents at once afterwards
+     * instead of creating views and tabs per document
+     */
+    QList<KTextEditor::Document *> docs;
+    emit aboutToCreateDocuments();
+
     for (unsigned int i = 0; i < count; i++) {
         KConfigGroup cg(config, QStringLiteral("Document %1").arg(i));
         KTextEditor::Document *doc = nullptr;
 
+        const QUrl url(cg.readEntry("URL"));
+        if (lazy && i > 0 && !url.isEmpty()) {
+            KateDocumentInfo info;
+            info.pendingLoad = true;
+            info.pendingUrl = url;
+            info.pendingConfig = cg.entryMap();
+            docs << createDoc(info);
+            progress.setValue(i);
+            continue;
+        }
+
         if (i == 0) {
             doc = m_docList.first();
         } else {
             doc = createDoc();
+            docs << doc;
         }
 
         connect(doc, SIGNAL(completed()), this, SLOT(documentOpened()));
@@ -462,6 +694,8 @@ void KateDocManager::restoreDocumentList(KConfig *config)
 
         progress.setValue(i);
     }
+
+    emit documentsCreated(docs);
 }
 
 void KateDocManager::slotModifiedOnDisc(KTextEditor::Document *doc, bool b, KTextEditor::ModificationInterface::ModifiedOnDiskReason reason)
@@ -482,29 +716,29 @@ bool KateDocManager::loadMetaInfos(KTextEditor::Document *doc, const QUrl &url)
         return false;
     }
 
-    if (!m_metaInfos.hasGroup(url.toDisplayString())) {
+    KateMetaInfoStore::Entry entry;
+    if (!m_metaInfos.entry(url, entry)) {
         return false;
     }
 
     const QByteArray checksum = doc->checksum().toHex();
     bool ok = true;
     if (!checksum.isEmpty()) {
-        KConfigGroup urlGroup(&m_metaInfos, url.toDisplayString());
-        const QString old_checksum = urlGroup.readEntry("Checksum");
-
-        if (QString::fromLatin1(checksum) == old_checksum) {
+        if (checksum == entry.checksum) {
             QSet<QString> flags;
             if (documentInfo(doc)->openedByUser) {
                 flags << QStringLiteral ("SkipEncoding");
             }
             flags << QStringLiteral ("SkipUrl");
+
+            KConfig config(QString(), KConfig::SimpleConfig);
+            KConfigGroup urlGroup(&config, "Document");
+            writeEntries(urlGroup, entry.config);
             doc->readSessionConfig(urlGroup, flags);
         } else {
-            urlGroup.deleteGroup();
+            m_metaInfos.remove(url);
             ok = false;
         }
-
-        m_metaInfos.sync();
     }
 
     return ok && doc->url() == url;
@@ -537,25 +771,54 @@ void KateDocManager::saveMetaInfos(const QList<KTextEditor::Document *> &documen
 
         const QByteArray checksum = doc->checksum().toHex();
         if (!checksum.isEmpty()) {
-
             /**
-             * write the group with checksum and time
+             * document session config, collected in memory
              */
-            KConfigGroup urlGroup(&m_metaInfos, doc->url().toString());
-            urlGroup.writeEntry("Checksum", QString::fromLatin1(checksum));
-            urlGroup.writeEntry("Time", now);
+            KConfig config(QString(), KConfig::SimpleConfig);
+            KConfigGroup urlGroup(&config, "Document");
+            doc->writeSessionConfig(urlGroup);
 
             /**
-             * write document session config
+             * entry with checksum and time, written in the next batch by the store
              */
-            doc->writeSessionConfig(urlGroup);
+            KateMetaInfoStore::Entry entry;
+            entry.checksum = checksum;
+            entry.time = now;
+            entry.config = urlGroup.entryMap();
+            m_metaInfos.insert(doc->url(), entry);
         }
     }
+}
 
-    /**
-     * sync to not loose data
-     */
-    m_metaInfos.sync();
+/**
+ * Take over the meta-information of the KConfig based store older versions used.
+ */
+void KateDocManager::importMetaInfos()
+{
+    const QString oldFile = QStandardPaths::locate(QStandardPaths::GenericConfigLocation, QStringLiteral("katemetainfos"));
+    if (oldFile.isEmpty()) {
+        return;
+    }
+
+    {
+        KConfig oldMetaInfos(oldFile, KConfig::SimpleConfig);
+        const QStringList groups = oldMetaInfos.groupList();
+        for (const QString &group : groups) {
+            KConfigGroup urlGroup(&oldMetaInfos, group);
+            KateMetaInfoStore::Entry entry;
+            entry.checksum = urlGroup.readEntry("Checksum").toLatin1();
+            entry.time = urlGroup.readEntry("Time", QDateTime(QDate(1970, 1, 1)));
+            entry.config = urlGroup.entryMap();
+            entry.config.remove(QStringLiteral("Checksum"));
+            entry.config.remove(QStringLiteral("Time"));
+            m_metaInfos.insert(QUrl(group), entry);
+        }
+    }
+
+    // only drop the old file once everything is on disk
+    m_metaInfos.flush();
+    m_metaInfos.waitForFinished();
+    QFile::remove(oldFile);
 }
 
 void KateDocManager::slotModChanged(KTextEditor::Document *doc)
@@ -31,9 +31,14 @@
 #include <QMap>
 #include <QPair>
 #include <QDateTime>
+#include <QThreadPool>
+#include <QUrl>
+#include <QVector>
 
 #include <KConfig>
 
+#include "katemetainfostore.h"
+
 class KateMainWindow;
 
 class KateDocumentInfo
@@ -47,6 +52,7 @@ public:
         , modifiedOnDiscReason(KTextEditor::ModificationInterface::OnDiskUnmodified)
         , openedByUser(false)
         , openSuccess(true)
+        , pendingLoad(false)
     {}
 
     bool modifiedOnDisc;
@@ -54,6 +60,14 @@ public:
 
     bool openedByUser;
     bool openSuccess;
+
+    /**
+     * placeholder of a lazy restored session document:
+     * the url and the session config are applied once the document is loaded
+     */
+    bool pendingLoad;
+    QUrl pendingUrl;
+    QMap<QString, QString> pendingConfig;
 };
 
 class KateDocManager : public QObject
@@ -68,7 +82,12 @@ public:
 
     KateDocumentInfo *documentInfo(KTextEditor::Document *doc);
 
-    /** Returns the documentNumber of the doc with url URL or -1 if no such doc is found */
+    /**
+     * Find the document with the given url, lazy restored placeholders included.
+     * Constant time lookup in the url index, plugins get it via KTextEditor::Application::findUrl().
+     * @param url url to search
+     * @return document or nullptr if no such document is found
+     */
     KTextEditor::Document *findDocument(const QUrl &url) const;
 
     const QList<KTextEditor::Document *> &documentList() const {
@@ -97,6 +116,28 @@ public:
     void saveDocumentList(KConfig *config);
     void restoreDocumentList(KConfig *config);
 
+    /**
+     * Is the content of this document loaded?
+     * Documents restored lazily from a session stay placeholders until shown.
+     * @param doc document to check
+     * @return false for not yet loaded placeholders
+     */
+    bool isLoaded(KTextEditor::Document *doc) const;
+
+    /**
+     * Url of the document, for placeholders the url that will be loaded.
+     * @param doc document
+     * @return document url
+     */
+    QUrl documentUrl(KTextEditor::Document *doc) const;
+
+    /**
+     * Name of the document, for placeholders the file name of the url that will be loaded.
+     * @param doc document
+     * @return document name
+     */
+    QString documentName(KTextEditor::Document *doc) const;
+
     inline bool getSaveMetaInfos() {
         return m_saveMetaInfos;
     }
@@ -134,6 +175,12 @@ public Q_SLOTS:
      */
     void saveSelected(const QList<KTextEditor::Document *> &);
 
+    /**
+     * load the content of a lazy restored document, does nothing for already loaded ones
+     * called once the document is shown, plugins can call it via invokeMethod, too
+     */
+    void loadDocument(KTextEditor::Document *doc);
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the \p document was created.
@@ -197,15 +244,46 @@ private Q_SLOTS:
     void slotModifiedOnDisc(KTextEditor::Document *doc, bool b, KTextEditor::ModificationInterface::ModifiedOnDiskReason reason);
     void slotModChanged(KTextEditor::Document *doc);
     void slotModChanged1(KTextEditor::Document *doc);
+    void slotDocumentUrlChanged(KTextEditor::Document *doc);
 
 private:
     bool loadMetaInfos(KTextEditor::Document *doc, const QUrl &url);
     void saveMetaInfos(const QList<KTextEditor::Document *> &docs);
+    void importMetaInfos();
+    KateDocumentInfo *pendingInfo(KTextEditor::Document *doc) const;
+
+    /**
+     * (re-)add the document to the url index, remove it from there
+     */
+    void indexDocument(KTextEditor::Document *doc);
+    void unindexDocument(KTextEditor::Document *doc);
+
+    /**
+     * cached QFileInfo::canonicalFilePath(), that is a chain of syscalls
+     */
+    QString canonicalFilePath(const QString &path) const;
 
     QList<KTextEditor::Document *> m_docList;
     QHash<KTextEditor::Document *, KateDocumentInfo *> m_docInfos;
 
-    KConfig m_metaInfos;
+    /**
+     * url => documents with that url, in the order they were indexed,
+     * and the url each document is indexed with
+     */
+    QHash<QUrl, QVector<KTextEditor::Document *>> m_urlIndex;
+    QHash<KTextEditor::Document *, QUrl> m_indexedUrls;
+
+    /**
+     * path => canonical path, invalidated if documents change their url or are closed
+     */
+    mutable QHash<QString, QString> m_canonicalPaths;
+
+    /**
+     * reads files ahead while openUrls() creates many documents
+     */
+    QThreadPool m_prefetchPool;
+
+    KateMetaInfoStore m_metaInfos;
     bool m_saveMetaInfos;
     int m_daysMetaInfos;
 
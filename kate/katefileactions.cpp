@@ -20,6 +20,8 @@
 **/
 
 #include "katefileactions.h"
+#include "kateapp.h"
+#include "katedocmanager.h"
 
 #include <ktexteditor/application.h>
 #include <ktexteditor/document.h>
@@ -39,19 +41,27 @@
 #include <QProcess>
 #include <QUrl>
 
+/**
+ * Url of @p doc, also for placeholders of not yet loaded documents.
+ */
+static QUrl documentUrl(KTextEditor::Document* doc)
+{
+    return KateApp::self()->documentManager()->documentUrl(doc);
+}
+
 void KateFileActions::copyFilePathToClipboard(KTextEditor::Document* doc)
 {
-    QApplication::clipboard()->setText(doc->url().toDisplayString(QUrl::PreferLocalFile));
+    QApplication::clipboard()->setText(documentUrl(doc).toDisplayString(QUrl::PreferLocalFile));
 }
 
 void KateFileActions::openContainingFolder(KTextEditor::Document* doc)
 {
-    KIO::highlightInFileManager({doc->url()});
+    KIO::highlightInFileManager({documentUrl(doc)});
 }
 
 void KateFileActions::openFilePropertiesDialog(KTextEditor::Document* doc)
 {
-    KFileItem fileItem(doc->url());
+    KFileItem fileItem(documentUrl(doc));
     QDialog* dlg = new KPropertiesDialog(fileItem);
     dlg->setAttribute(Qt::WA_DeleteOnClose);
     dlg->show();
@@ -66,13 +76,16 @@ void KateFileActions::renameDocumentFile(QWidget* parent, KTextEditor::Document*
         return;
     }
 
+    // the document is reopened from the new location, so a placeholder must be loaded first
+    KateApp::self()->documentManager()->loadDocument(doc);
+
     const QUrl oldFileUrl = doc->url();
 
     if (oldFileUrl.isEmpty()) { // NEW
         return;
     }
 
-    const QString oldFileName = doc->url().fileName();
+    const QString oldFileName = oldFileUrl.fileName();
     bool ok = false;
     QString newFileName = QInputDialog::getText(parent, // ADAPTED
         i18n("Rename file"), i18n("New file name"), QLineEdit::Normal, oldFileName, &ok);
@@ -117,7 +130,7 @@ void KateFileActions::deleteDocumentFile(QWidget* parent, KTextEditor::Document*
         return;
     }
 
-    const auto&& url = doc->url();
+    const QUrl url = documentUrl(doc);
 
     if (url.isEmpty()) { // NEW
         return;
@@ -166,6 +179,6 @@ bool KateFileActions::compareWithExternalProgram(KTextEditor::Document* document
 
     QProcess process;
     QStringList arguments;
-    arguments << documentA->url().toLocalFile() << documentB->url().toLocalFile();
+    arguments << documentUrl(documentA).toLocalFile() << documentUrl(documentB).toLocalFile();
     return process.startDetached(diffExecutable, arguments);
 }
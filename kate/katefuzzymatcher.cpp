@@ -0,0 +1,185 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katefuzzymatcher.h"
+
+#include <QVarLengthArray>
+
+#include <limits>
+#include <utility>
+
+/**
+ * scoring, see match()
+ */
+static const int ScoreMatch = 16;
+static const int BonusSegment = 10;
+static const int BonusBoundary = 8;
+static const int BonusCamel = 7;
+static const int BonusConsecutive = 6;
+static const int BonusBasename = 4;
+static const int BonusCase = 1;
+static const int GapStart = -3;
+static const int GapExtension = -1;
+
+/**
+ * score of impossible matches, far away from all real scores, so adding gap costs can't overflow
+ */
+static const int Invalid = std::numeric_limits<int>::min() / 2;
+
+static inline bool isValid(int score)
+{
+    return score > Invalid / 2;
+}
+
+static inline ushort foldCase(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u < 128) {
+        return (u >= 'A' && u <= 'Z') ? (u + ('a' - 'A')) : u;
+    }
+    return c.toLower().unicode();
+}
+
+static inline quint64 charBit(QChar c)
+{
+    const ushort u = foldCase(c);
+    if (u >= 'a' && u <= 'z') {
+        return quint64(1) << (u - 'a');
+    }
+    if (u >= '0' && u <= '9') {
+        return quint64(1) << (26 + u - '0');
+    }
+    return quint64(1) << (36 + u % 28);
+}
+
+/**
+ * bonus for matching the character at the given position
+ */
+static inline int positionBonus(const QStringRef &text, int pos, int basenameStart)
+{
+    int bonus = 0;
+    if (pos == 0) {
+        bonus = BonusSegment;
+    } else {
+        const QChar prev = text.at(pos - 1);
+        if (prev == QLatin1Char('/') || prev == QLatin1Char('\\')) {
+            bonus = BonusSegment;
+        } else if (prev == QLatin1Char('_') || prev == QLatin1Char('-') || prev == QLatin1Char('.') || prev == QLatin1Char(' ')) {
+            bonus = BonusBoundary;
+        } else if (prev.isLower() && text.at(pos).isUpper()) {
+            bonus = BonusCamel;
+        }
+    }
+
+    if (pos >= basenameStart) {
+        bonus += BonusBasename;
+    }
+    return bonus;
+}
+
+quint64 KateFuzzyMatcher::charMask(const QStringRef &text)
+{
+    quint64 mask = 0;
+    for (const QChar c : text) {
+        mask |= charBit(c);
+    }
+    return mask;
+}
+
+bool KateFuzzyMatcher::match(const QString &pattern, const QStringRef &text, int basenameStart, int &score)
+{
+    const int m = pattern.size();
+    const int n = text.size();
+    if (m == 0 || m > n) {
+        return false;
+    }
+
+    /**
+     * cheap subsequence check first, most texts fail here
+     * remember first possible position, no match can start before it
+     */
+    int first = -1;
+    for (int i = 0, j = 0; i < m; ++i, ++j) {
+        const ushort c = foldCase(pattern.at(i));
+        while (j < n && foldCase(text.at(j)) != c) {
+            ++j;
+        }
+        if (j == n) {
+            return false;
+        }
+        if (i == 0) {
+            first = j;
+        }
+    }
+
+    /**
+     * best scoring alignment, row i holds the best score with pattern[i] matched at text[j]
+     * the gap costs are linear, the best gapped predecessor is carried along in a running maximum
+     */
+    QVarLengthArray<int, 256> rowA(n);
+    QVarLengthArray<int, 256> rowB(n);
+    int *prev = rowA.data();
+    int *cur = rowB.data();
+    for (int i = 0; i < m; ++i) {
+        const QChar pc = pattern.at(i);
+        const ushort folded = foldCase(pc);
+        int gapped = Invalid;
+
+        for (int j = 0; j < n; ++j) {
+            if (i > 0 && j >= 2) {
+                gapped = qMax(gapped + GapExtension, prev[j - 2] + GapStart);
+            }
+
+            const QChar tc = text.at(j);
+            if (j < first + i || foldCase(tc) != folded) {
+                cur[j] = Invalid;
+                continue;
+            }
+
+            const int bonus = positionBonus(text, j, basenameStart);
+            const int charScore = ScoreMatch + bonus + ((tc == pc) ? BonusCase : 0);
+            if (i == 0) {
+                // the first character counts twice, a match should start at a boundary
+                cur[j] = charScore + bonus;
+                continue;
+            }
+
+            int best = gapped;
+            if (j >= 1 && isValid(prev[j - 1])) {
+                best = qMax(best, prev[j - 1] + BonusConsecutive);
+            }
+            cur[j] = isValid(best) ? (best + charScore) : Invalid;
+        }
+
+        std::swap(prev, cur);
+    }
+
+    int best = Invalid;
+    for (int j = 0; j < n; ++j) {
+        best = qMax(best, prev[j]);
+    }
+
+    if (!isValid(best)) {
+        return false;
+    }
+
+    score = best;
+    return true;
+}
@@ -0,0 +1,65 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_FUZZY_MATCHER_H
+#define KATE_FUZZY_MATCHER_H
+
+#include "kateprivate_export.h"
+
+#include <QString>
+
+/**
+ * Case insensitive fuzzy matching of a pattern against file names and paths.
+ *
+ * A text matches if the pattern is a subsequence of it. The score rewards
+ * consecutive characters, characters at the start of path segments and words
+ * and characters inside the base name, gaps between matched characters cost.
+ */
+class KATE_TESTS_EXPORT KateFuzzyMatcher
+{
+public:
+    /**
+     * Character set of a text as bit mask, for cheap prefiltering:
+     * a text can only match if its mask contains all bits of the pattern mask.
+     * @param text text to compute the mask for
+     * @return character mask
+     */
+    static quint64 charMask(const QStringRef &text);
+
+    static quint64 charMask(const QString &text) {
+        return charMask(QStringRef(&text));
+    }
+
+    /**
+     * Match pattern against text.
+     * @param pattern pattern to search, non-empty
+     * @param text text to match
+     * @param basenameStart offset of the base name in text, 0 if text is a file name
+     * @param score set to the score of the best match, higher is better
+     * @return true if the pattern matches
+     */
+    static bool match(const QString &pattern, const QStringRef &text, int basenameStart, int &score);
+
+    static bool match(const QString &pattern, const QString &text, int basenameStart, int &score) {
+        return match(pattern, QStringRef(&text), basenameStart, score);
+    }
+};
+
+#endif
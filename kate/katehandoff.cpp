@@ -0,0 +1,186 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katehandoff.h"
+#include "katedebug.h"
+
+#include <QDataStream>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtEndian>
+
+#ifndef Q_OS_WIN
+#include <unistd.h>
+#endif
+
+static const char ack[] = "ack";
+
+/**
+ * larger messages are dropped, even stdin input doesn't get near this
+ */
+static const quint32 MaxMessageSize = 256 * 1024 * 1024;
+
+KateHandoffServer::KateHandoffServer(QObject *parent)
+    : QObject(parent)
+    , m_server(nullptr)
+{
+}
+
+KateHandoffServer::~KateHandoffServer()
+{
+    // the server closes and removes the socket on destruction
+}
+
+QString KateHandoffServer::serverName()
+{
+#ifndef Q_OS_WIN
+    const QString user = QString::number(::getuid(), 16);
+#else
+    const QString user = QString::fromLocal8Bit(qgetenv("USERNAME"));
+#endif
+
+    /**
+     * instances on other displays of the same user are not reused, like for D-Bus
+     */
+    const QByteArray display = qgetenv("WAYLAND_DISPLAY") + '|' + qgetenv("DISPLAY");
+    return QStringLiteral("kate-handoff-%1-%2").arg(user).arg(qHash(display), 0, 16);
+}
+
+bool KateHandoffServer::listen()
+{
+    if (m_server) {
+        return true;
+    }
+
+    const QString name = serverName();
+    QLocalServer *server = new QLocalServer(this);
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+
+    if (!server->listen(name)) {
+        /**
+         * someone there? else this is the left over of a crashed instance
+         */
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(100)) {
+            delete server;
+            return false;
+        }
+
+        QLocalServer::removeServer(name);
+        if (!server->listen(name)) {
+            qCWarning(LOG_KATE) << "can't listen for handoff on" << name << server->errorString();
+            delete server;
+            return false;
+        }
+    }
+
+    m_server = server;
+    connect(m_server, &QLocalServer::newConnection, this, &KateHandoffServer::slotNewConnection);
+    return true;
+}
+
+void KateHandoffServer::slotNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QLocalSocket::readyRead, this, &KateHandoffServer::slotReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &KateHandoffServer::slotDisconnected);
+
+        // data might be there already
+        readMessage(socket);
+    }
+}
+
+void KateHandoffServer::slotReadyRead()
+{
+    if (QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender())) {
+        readMessage(socket);
+    }
+}
+
+void KateHandoffServer::readMessage(QLocalSocket *socket)
+{
+    const auto it = m_buffers.find(socket);
+    if (it == m_buffers.end() || socket->bytesAvailable() <= 0) {
+        return;
+    }
+
+    QByteArray &buffer = it.value();
+    buffer.append(socket->readAll());
+
+    /**
+     * frame: 32 bit big endian length + data, as written by QDataStream::writeBytes
+     */
+    if (buffer.size() < int(sizeof(quint32))) {
+        return;
+    }
+
+    const quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData()));
+    if (size > MaxMessageSize) {
+        qCWarning(LOG_KATE) << "dropping too large handoff message";
+        socket->abort();
+        return;
+    }
+
+    if (quint32(buffer.size()) - sizeof(quint32) < size) {
+        return;
+    }
+
+    const QString message = QString::fromUtf8(buffer.constData() + sizeof(quint32), int(size));
+    buffer.clear();
+
+    socket->write(ack, qstrlen(ack));
+    socket->disconnectFromServer();
+
+    /**
+     * handle it after the sender got its answer
+     */
+    emit messageReceived(message);
+}
+
+void KateHandoffServer::slotDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    m_buffers.remove(socket);
+    socket->deleteLater();
+}
+
+bool KateHandoffServer::sendMessage(const QString &message, int timeout)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName());
+    if (!socket.waitForConnected(timeout)) {
+        return false;
+    }
+
+    const QByteArray data = message.toUtf8();
+    QDataStream stream(&socket);
+    stream.writeBytes(data.constData(), data.size());
+
+    bool res = socket.waitForBytesWritten(timeout);
+    res = res && socket.waitForReadyRead(timeout);
+    res = res && (socket.read(qstrlen(ack)) == ack);
+    return res;
+}
@@ -0,0 +1,100 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_HANDOFF_H
+#define KATE_HANDOFF_H
+
+#include "kateprivate_export.h"
+
+#include <QHash>
+#include <QObject>
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * Local socket fallback for the handoff of files to a running instance,
+ * used if the session bus is not around or the chosen instance left it.
+ * Not used after a D-Bus timeout, the instance might still handle the call.
+ *
+ * The first instance of the user on the display listens, the messages are
+ * the same JSON messages the D-Bus handoff uses, framed like QtLocalPeer does:
+ * length prefixed UTF-8, answered with "ack" once queued.
+ */
+class KATE_TESTS_EXPORT KateHandoffServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KateHandoffServer(QObject *parent = nullptr);
+    ~KateHandoffServer() override;
+
+    /**
+     * Start listening, fails if another instance already does.
+     * @return success
+     */
+    bool listen();
+
+    /**
+     * Send a message to the listening instance.
+     * @param message JSON message, see KateApp::handleRemoteMessage()
+     * @param timeout timeout in milliseconds for connecting and for the answer
+     * @return true if the message was accepted
+     */
+    static bool sendMessage(const QString &message, int timeout);
+
+    /**
+     * Per user and display name of the socket.
+     * @return server name
+     */
+    static QString serverName();
+
+Q_SIGNALS:
+    /**
+     * A complete message arrived.
+     * @param message received JSON message
+     */
+    void messageReceived(const QString &message);
+
+private Q_SLOTS:
+    void slotNewConnection();
+    void slotReadyRead();
+    void slotDisconnected();
+
+private:
+    /**
+     * read available data, emits messageReceived() once the message is complete
+     * @param socket connection to read from
+     */
+    void readMessage(QLocalSocket *socket);
+
+private:
+    /**
+     * listening server, nullptr until listen() succeeded
+     */
+    QLocalServer *m_server;
+
+    /**
+     * data received so far per connection
+     */
+    QHash<QLocalSocket *, QByteArray> m_buffers;
+};
+
+#endif
@@ -1174,7 +1174,8 @@ bool KateMainWindow::event(QEvent *e)
 
 QObject *KateMainWindow::pluginView(const QString &name)
 {
-    KTextEditor::Plugin *plugin = KateApp::self()->pluginManager()->plugin(name);
+    // a deferred plugin has no views yet, don't load it just for this lookup
+    KTextEditor::Plugin *plugin = KateApp::self()->pluginManager()->loadedPlugin(name);
     if (!plugin) {
         return nullptr;
     }
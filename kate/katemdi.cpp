@@ -26,6 +26,7 @@
 
 #include <KActionCollection>
 #include <KActionMenu>
+#include <KConfig>
 #include <KConfigGroup>
 #include <KMessageBox>
 #include <KXMLGUIFactory>
@@ -719,6 +720,9 @@ MainWindow::MainWindow(QWidget *parentWidget)
     : KParts::MainWindow(parentWidget, Qt::Window)
     , m_sidebarsVisible(true)
     , m_restoreConfig(nullptr)
+    , m_lateRestore(false)
+    , m_lateRestoreFirst(0)
+    , m_lateRestoreDepth(0)
     , m_guiClient(new GUIClient(this))
 {
     // init the internal widgets
@@ -1009,6 +1013,11 @@ void MainWindow::finishRestore()
 
         m_hSplitter->setSizes(hs);
         m_vSplitter->setSizes(vs);
+
+        // remember the settings for toolviews created later
+        m_lateRestoreConfig.reset(new KConfig(QString(), KConfig::SimpleConfig));
+        KConfigGroup lateGroup(m_lateRestoreConfig.data(), QStringLiteral("MainWindow"));
+        cg.copyTo(&lateGroup);
     }
 
     // clear this stuff, we are done ;)
@@ -1016,6 +1025,40 @@ void MainWindow::finishRestore()
     m_restoreGroup.clear();
 }
 
+void MainWindow::startLateRestore()
+{
+    // nested, nothing remembered or inside a normal restore, that handles all toolviews itself
+    if (m_lateRestoreDepth++ > 0 || !m_lateRestoreConfig || m_restoreConfig) {
+        return;
+    }
+
+    m_lateRestore = true;
+    m_lateRestoreFirst = m_toolviews.size();
+    m_restoreConfig = m_lateRestoreConfig.data();
+    m_restoreGroup = QStringLiteral("MainWindow");
+}
+
+void MainWindow::finishLateRestore()
+{
+    if (--m_lateRestoreDepth > 0 || !m_lateRestore) {
+        return;
+    }
+
+    const KConfigGroup cg(m_restoreConfig, m_restoreGroup);
+    m_lateRestore = false;
+    m_restoreConfig = nullptr;
+    m_restoreGroup.clear();
+
+    // the new toolviews are already at the right sidebar, show them if they were visible
+    for (int i = m_lateRestoreFirst; i < m_toolviews.size(); ++i) {
+        ToolView *tv = m_toolviews[i];
+        tv->persistent = cg.readEntry(QStringLiteral("Kate-MDI-ToolView-%1-Persistent").arg(tv->id), false);
+        if (cg.readEntry(QStringLiteral("Kate-MDI-ToolView-%1-Visible").arg(tv->id), false)) {
+            showToolView(tv);
+        }
+    }
+}
+
 void MainWindow::saveSession(KConfigGroup &config)
 {
     saveMainWindowSettings(config);
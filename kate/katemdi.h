@@ -36,6 +36,9 @@
 #include <QChildEvent>
 #include <QPointer>
 #include <QFrame>
+#include <QScopedPointer>
+
+class KConfig;
 
 class KActionMenu;
 class QAction;
@@ -388,6 +391,17 @@ public:
      */
     void finishRestore();
 
+    /**
+     * start restoring toolviews created after the restore, e.g. by plugins loaded later,
+     * uses a copy of the settings of the last restore
+     */
+    void startLateRestore();
+
+    /**
+     * finish restoring toolviews created since startLateRestore(), shows the ones visible in the session
+     */
+    void finishLateRestore();
+
     /**
      * save the current session config to given object and group
      * @param group config group to use
@@ -445,6 +459,16 @@ private:
      */
     QString m_restoreGroup;
 
+    /**
+     * copy of the settings of the last restore, for toolviews created later
+     * late restore active: toolviews created since then start at index m_lateRestoreFirst
+     * nested late restores are part of the outermost one
+     */
+    QScopedPointer<KConfig> m_lateRestoreConfig;
+    bool m_lateRestore;
+    int m_lateRestoreFirst;
+    int m_lateRestoreDepth;
+
     /**
      * out guiclient
      */
@@ -0,0 +1,284 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katemetainfostore.h"
+#include "katedebug.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QUrl>
+#include <QVector>
+
+/**
+ * file header: magic + format version
+ */
+static const quint32 StoreMagic = 0x4B4D4946;
+static const quint32 StoreVersion = 1;
+
+/**
+ * changes are collected this long before they are written
+ */
+static const int FlushDelay = 2000;
+
+/**
+ * compact once the file has this many more records than live entries
+ */
+static const int CompactionSlack = 1000;
+
+/**
+ * One record of the store file.
+ */
+struct KateMetaInfoRecord {
+    QByteArray key;
+    bool removed;
+    KateMetaInfoStore::Entry entry;
+};
+
+static QDataStream &operator<<(QDataStream &stream, const KateMetaInfoRecord &record)
+{
+    return stream << record.key << record.removed << record.entry.checksum << record.entry.time << record.entry.config;
+}
+
+static QDataStream &operator>>(QDataStream &stream, KateMetaInfoRecord &record)
+{
+    return stream >> record.key >> record.removed >> record.entry.checksum >> record.entry.time >> record.entry.config;
+}
+
+/**
+ * Writes one batch of records, either appended or as complete new file.
+ */
+class KateMetaInfoWriteJob : public QRunnable
+{
+public:
+    KateMetaInfoWriteJob(const QString &fileName, const QVector<KateMetaInfoRecord> &records, bool rewrite)
+        : m_fileName(fileName)
+        , m_records(records)
+        , m_rewrite(rewrite)
+    {
+    }
+
+    void run() override
+    {
+        QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+
+        /**
+         * compaction: write complete file atomically
+         */
+        if (m_rewrite) {
+            QSaveFile file(m_fileName);
+            if (!file.open(QIODevice::WriteOnly)) {
+                qCWarning(LOG_KATE) << "can't write meta-information to" << m_fileName;
+                return;
+            }
+            QDataStream stream(&file);
+            write(stream, true);
+            file.commit();
+            return;
+        }
+
+        /**
+         * normal batch: append records
+         */
+        QFile file(m_fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCWarning(LOG_KATE) << "can't write meta-information to" << m_fileName;
+            return;
+        }
+        QDataStream stream(&file);
+        write(stream, file.size() == 0);
+    }
+
+private:
+    void write(QDataStream &stream, bool header) const
+    {
+        stream.setVersion(QDataStream::Qt_5_6);
+        if (header) {
+            stream << StoreMagic << StoreVersion;
+        }
+        for (const KateMetaInfoRecord &record : m_records) {
+            stream << record;
+        }
+    }
+
+private:
+    const QString m_fileName;
+    const QVector<KateMetaInfoRecord> m_records;
+    const bool m_rewrite;
+};
+
+KateMetaInfoStore::KateMetaInfoStore(const QString &fileName)
+    : m_fileName(fileName)
+    , m_records(0)
+    , m_rewrite(false)
+{
+    m_writer.setMaxThreadCount(1);
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FlushDelay);
+    connect(&m_flushTimer, &QTimer::timeout, this, &KateMetaInfoStore::flush);
+
+    load();
+}
+
+KateMetaInfoStore::~KateMetaInfoStore()
+{
+    flush();
+    waitForFinished();
+}
+
+QByteArray KateMetaInfoStore::key(const QUrl &url)
+{
+    return QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1);
+}
+
+void KateMetaInfoStore::load()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != StoreMagic || version != StoreVersion) {
+        m_rewrite = true;
+        return;
+    }
+
+    /**
+     * replay all records, last one wins
+     * a broken tail, e.g. after a crash, is dropped by rewriting the file
+     */
+    while (!stream.atEnd()) {
+        KateMetaInfoRecord record;
+        stream >> record;
+        if (stream.status() != QDataStream::Ok) {
+            m_rewrite = true;
+            break;
+        }
+
+        ++m_records;
+        if (record.removed) {
+            m_entries.remove(record.key);
+        } else {
+            m_entries.insert(record.key, record.entry);
+        }
+    }
+}
+
+bool KateMetaInfoStore::entry(const QUrl &url, Entry &entry) const
+{
+    const auto it = m_entries.constFind(key(url));
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    entry = it.value();
+    return true;
+}
+
+void KateMetaInfoStore::insert(const QUrl &url, const Entry &entry)
+{
+    const QByteArray k = key(url);
+    m_entries.insert(k, entry);
+    m_pending.insert(k);
+    scheduleFlush();
+}
+
+void KateMetaInfoStore::remove(const QUrl &url)
+{
+    const QByteArray k = key(url);
+    if (m_entries.remove(k)) {
+        m_pending.insert(k);
+        scheduleFlush();
+    }
+}
+
+void KateMetaInfoStore::removeOlderThan(int days)
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it.value().time.daysTo(now) > days) {
+            m_pending.insert(it.key());
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    scheduleFlush();
+}
+
+void KateMetaInfoStore::scheduleFlush()
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void KateMetaInfoStore::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty() && !m_rewrite) {
+        return;
+    }
+
+    /**
+     * too many stale records in the file? write a compact one
+     */
+    const bool rewrite = m_rewrite || (m_records + m_pending.size() > 2 * m_entries.size() + CompactionSlack);
+
+    QVector<KateMetaInfoRecord> records;
+    if (rewrite) {
+        records.reserve(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            records.append({it.key(), false, it.value()});
+        }
+        m_records = records.size();
+        m_rewrite = false;
+    } else {
+        records.reserve(m_pending.size());
+        for (const QByteArray &k : qAsConst(m_pending)) {
+            const auto it = m_entries.constFind(k);
+            if (it == m_entries.constEnd()) {
+                records.append({k, true, Entry()});
+            } else {
+                records.append({k, false, it.value()});
+            }
+        }
+        m_records += records.size();
+    }
+    m_pending.clear();
+
+    m_writer.start(new KateMetaInfoWriteJob(m_fileName, records, rewrite));
+}
+
+void KateMetaInfoStore::waitForFinished()
+{
+    m_writer.waitForDone();
+}
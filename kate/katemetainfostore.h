@@ -0,0 +1,180 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_METAINFO_STORE_H
+#define KATE_METAINFO_STORE_H
+
+#include "kateprivate_export.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+class QUrl;
+
+/**
+ * Persistent store for the meta-information of documents,
+ * e.g. bookmarks and cursor position, keyed by the hash of the document url.
+ *
+ * The store is an append-only file of binary records, the last record for a
+ * key wins. Changes are coalesced and appended in batches by a worker thread,
+ * the file is compacted once it contains too many stale records.
+ */
+class KATE_TESTS_EXPORT KateMetaInfoStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Meta-information of one document.
+     */
+    struct Entry {
+        /**
+         * checksum of the file content, the entry is only valid for this content
+         */
+        QByteArray checksum;
+
+        /**
+         * time of last update
+         */
+        QDateTime time;
+
+        /**
+         * document session config entries
+         */
+        QMap<QString, QString> config;
+    };
+
+    /**
+     * Open the store.
+     * @param fileName file to read and write, read synchronously
+     */
+    explicit KateMetaInfoStore(const QString &fileName);
+
+    /**
+     * Close the store, writes all pending changes.
+     */
+    ~KateMetaInfoStore() override;
+
+    /**
+     * Get the meta-information of a document.
+     * @param url document url
+     * @param entry filled if found
+     * @return true if found
+     */
+    bool entry(const QUrl &url, Entry &entry) const;
+
+    /**
+     * Set the meta-information of a document, written later.
+     * @param url document url
+     * @param entry new meta-information
+     */
+    void insert(const QUrl &url, const Entry &entry);
+
+    /**
+     * Remove the meta-information of a document, written later.
+     * @param url document url
+     */
+    void remove(const QUrl &url);
+
+    /**
+     * Remove all entries not updated for the given number of days.
+     * @param days maximal age in days
+     */
+    void removeOlderThan(int days);
+
+    /**
+     * Number of stored entries.
+     * @return entry count
+     */
+    int count() const {
+        return m_entries.size();
+    }
+
+    /**
+     * Hand all pending changes to the writer thread now.
+     */
+    void flush();
+
+    /**
+     * Wait until all handed out changes are on disk.
+     */
+    void waitForFinished();
+
+private:
+    /**
+     * Key of an url: sha1 of the encoded url.
+     */
+    static QByteArray key(const QUrl &url);
+
+    /**
+     * Read the store file.
+     */
+    void load();
+
+    /**
+     * Start the coalescing timer.
+     */
+    void scheduleFlush();
+
+private:
+    /**
+     * store file
+     */
+    const QString m_fileName;
+
+    /**
+     * key => meta-information
+     */
+    QHash<QByteArray, Entry> m_entries;
+
+    /**
+     * changed keys not yet handed to the writer, removed ones have no entry in m_entries
+     */
+    QSet<QByteArray> m_pending;
+
+    /**
+     * records in the file, to decide about compaction
+     */
+    int m_records;
+
+    /**
+     * file is unreadable or has a broken tail, rewrite it completely
+     */
+    bool m_rewrite;
+
+    /**
+     * single writer thread, keeps the order of the batches
+     */
+    QThreadPool m_writer;
+
+    /**
+     * coalesces changes into batches
+     */
+    QTimer m_flushTimer;
+};
+
+#endif
@@ -22,15 +22,20 @@
 #include "kateapp.h"
 #include "katedocmanager.h"
 #include "katemainwindow.h"
+#include "katediff.h"
 
 #include <KMessageBox>
-#include <KProcess>
 #include <KRun>
 #include <KLocalizedString>
 #include <KIconLoader>
 
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
 #include <QTemporaryFile>
-#include <QTextStream>
+#include <QTextCodec>
 #include <QHeaderView>
 #include <QLabel>
 #include <QPushButton>
@@ -58,10 +63,62 @@ public:
     KTextEditor::Document *document;
 };
 
+/**
+ * Compares the editor contents with the file on disk, like diff -ub.
+ * Encoding the text, reading the file and comparing all happen in the pool.
+ */
+class KateDiffJob : public QRunnable
+{
+public:
+    KateDiffJob(QObject *dialog, QMutex *mutex, QByteArray *target, bool *failed,
+                const QString &text, QTextCodec *codec, const QString &name, const QString &fileName)
+        : m_dialog(dialog)
+        , m_mutex(mutex)
+        , m_target(target)
+        , m_failed(failed)
+        , m_text(text)
+        , m_codec(codec)
+        , m_name(name)
+        , m_fileName(fileName)
+    {
+    }
+
+    void run() override
+    {
+        const QByteArray oldHeader = KateDiff::header(m_name, QDateTime::currentDateTime());
+        const QByteArray oldText = m_codec->fromUnicode(m_text);
+
+        QByteArray result;
+        QFile file(m_fileName);
+        const bool failed = !file.open(QIODevice::ReadOnly);
+        if (!failed) {
+            const QByteArray newHeader = KateDiff::header(m_fileName, QFileInfo(file).lastModified());
+            result = KateDiff::unified(oldText, file.readAll(), oldHeader, newHeader, KateDiff::IgnoreSpaceChange);
+        }
+
+        {
+            QMutexLocker locker(m_mutex);
+            *m_target = result;
+            *m_failed = failed;
+        }
+        QMetaObject::invokeMethod(m_dialog, "slotDiffDone", Qt::QueuedConnection);
+    }
+
+private:
+    QObject *const m_dialog;
+    QMutex *const m_mutex;
+    QByteArray *const m_target;
+    bool *const m_failed;
+    const QString m_text;
+    QTextCodec *const m_codec;
+    const QString m_name;
+    const QString m_fileName;
+};
+
 KateMwModOnHdDialog::KateMwModOnHdDialog(DocVector docs, QWidget *parent, const char *name)
     : QDialog(parent),
-      m_proc(nullptr),
-      m_diffFile(nullptr),
+      m_diffFailed(false),
+      m_diffRunning(false),
       m_blockAddDocument(false)
 {
     setWindowTitle(i18n("Documents Modified on Disk"));
@@ -113,7 +170,7 @@ KateMwModOnHdDialog::KateMwModOnHdDialog(DocVector docs, QWidget *parent, const
     btnDiff->setWhatsThis(i18n(
                               "Calculates the difference between the editor contents and the disk "
                               "file for the selected document, and shows the difference with the "
-                              "default application. Requires diff(1)."));
+                              "default application."));
     hb->addWidget(btnDiff);
     connect(btnDiff, &QPushButton::clicked, this, &KateMwModOnHdDialog::slotDiff);
 
@@ -145,18 +202,8 @@ KateMwModOnHdDialog::~KateMwModOnHdDialog()
 {
     KateMainWindow::unsetModifiedOnDiscDialogIfIf(this);
 
-    if (m_proc) {
-        m_proc->kill();
-        m_proc->waitForFinished();
-        delete m_proc;
-        m_proc = Q_NULLPTR;
-    }
-
-    if (m_diffFile) {
-        m_diffFile->setAutoRemove(true);
-        delete m_diffFile;
-        m_diffFile = Q_NULLPTR;
-    }
+    // a running comparison still reports to us, wait for it
+    m_diffPool.waitForDone();
 }
 
 void KateMwModOnHdDialog::slotIgnore()
@@ -245,7 +292,7 @@ void KateMwModOnHdDialog::slotSelectionChanged(QTreeWidgetItem *current, QTreeWi
 // class KateModOnHdPrompt.
 void KateMwModOnHdDialog::slotDiff()
 {
-    if (!btnDiff->isEnabled()) { // diff button already pressed, proc not finished yet
+    if (!btnDiff->isEnabled()) { // diff button already pressed, diff not finished yet
         return;
     }
 
@@ -260,72 +307,64 @@ void KateMwModOnHdDialog::slotDiff()
         return;
     }
 
-    if (m_diffFile) {
+    if (m_diffRunning) {
         return;
     }
 
-    m_diffFile = new QTemporaryFile();
-    m_diffFile->open();
-
-    // Start a KProcess that creates a diff
-    m_proc = new KProcess(this);
-    m_proc->setOutputChannelMode(KProcess::MergedChannels);
-    *m_proc << QStringLiteral("diff") << QStringLiteral("-ub") << QStringLiteral("-") << doc->url().toLocalFile();
-    connect(m_proc, &KProcess::readyRead, this, &KateMwModOnHdDialog::slotDataAvailable);
-    connect(m_proc, static_cast<void (KProcess::*)(int, QProcess::ExitStatus)>(&KProcess::finished), this, &KateMwModOnHdDialog::slotPDone);
+    QTextCodec *codec = QTextCodec::codecForName(doc->encoding().toLatin1());
+    if (!codec) {
+        codec = QTextCodec::codecForName("UTF-8");
+    }
 
     setCursor(Qt::WaitCursor);
     btnDiff->setEnabled(false);
+    m_diffRunning = true;
 
-    m_proc->start();
-
-    QTextStream ts(m_proc);
-    int lastln = doc->lines() - 1;
-    for (int l = 0; l < lastln; ++l) {
-        ts << doc->line(l) << QLatin1Char('\n');
-    }
-    ts << doc->line(lastln);
-    ts.flush();
-    m_proc->closeWriteChannel();
+    // text() shares the contents, the copy for the worker is cheap
+    m_diffPool.start(new KateDiffJob(this, &m_diffMutex, &m_diffResult, &m_diffFailed,
+                                     doc->text(), codec, doc->url().toString(), doc->url().toLocalFile()));
 }
 
-void KateMwModOnHdDialog::slotDataAvailable()
+void KateMwModOnHdDialog::slotDiffDone()
 {
-    m_diffFile->write(m_proc->readAll());
-}
+    QByteArray diff;
+    bool failed;
+    {
+        QMutexLocker locker(&m_diffMutex);
+        diff = m_diffResult;
+        failed = m_diffFailed;
+        m_diffResult.clear();
+    }
 
-void KateMwModOnHdDialog::slotPDone()
-{
+    m_diffRunning = false;
     setCursor(Qt::ArrowCursor);
     slotSelectionChanged(twDocuments->currentItem(), nullptr);
 
-    const QProcess::ExitStatus es = m_proc->exitStatus();
-    delete m_proc;
-    m_proc = nullptr;
-
-    if (es != QProcess::NormalExit) {
+    if (failed) {
         KMessageBox::sorry(this,
-                           i18n("The diff command failed. Please make sure that "
-                                "diff(1) is installed and in your PATH."),
+                           i18n("The file on disk could not be read."),
                            i18n("Error Creating Diff"));
-        delete m_diffFile;
-        m_diffFile = nullptr;
         return;
     }
 
-    if (m_diffFile->size() == 0) {
+    if (diff.isEmpty()) {
         KMessageBox::information(this,
                                  i18n("Ignoring amount of white space changed, the files are identical."),
                                  i18n("Diff Output"));
-        delete m_diffFile;
-        m_diffFile = nullptr;
         return;
     }
 
-    m_diffFile->setAutoRemove(false);
-    QUrl url = QUrl::fromLocalFile(m_diffFile->fileName());
-    delete m_diffFile;
-    m_diffFile = nullptr;
+    QTemporaryFile diffFile;
+    if (!diffFile.open() || diffFile.write(diff) != diff.size() || !diffFile.flush()) {
+        KMessageBox::sorry(this,
+                           i18n("The difference could not be written to a temporary file."),
+                           i18n("Error Creating Diff"));
+        return;
+    }
+
+    diffFile.setAutoRemove(false);
+    const QUrl url = QUrl::fromLocalFile(diffFile.fileName());
+    diffFile.close();
 
     // KRun::runUrl should delete the file, once the client exits
     KRun::runUrl(url, QStringLiteral("text/x-patch"), this, KRun::RunFlags(KRun::DeleteTemporaryFiles));
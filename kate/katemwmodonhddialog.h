@@ -24,9 +24,9 @@
 
 #include <QVector>
 #include <QDialog>
+#include <QMutex>
+#include <QThreadPool>
 
-class KProcess;
-class QTemporaryFile;
 class QTreeWidget;
 class QTreeWidgetItem;
 
@@ -50,16 +50,27 @@ private Q_SLOTS:
     void slotReload();
     void slotDiff();
     void slotSelectionChanged(QTreeWidgetItem *current, QTreeWidgetItem *);
-    void slotDataAvailable();
-    void slotPDone();
+
+    /**
+     * the difference computed by the worker thread is there, show it
+     */
+    void slotDiffDone();
 
 private:
     enum Action { Ignore, Overwrite, Reload };
     void handleSelected(int action);
     class QTreeWidget *twDocuments;
     class QPushButton *btnDiff;
-    KProcess *m_proc;
-    QTemporaryFile *m_diffFile;
+
+    /**
+     * computes the difference off the gui thread
+     */
+    QThreadPool m_diffPool;
+    QMutex m_diffMutex;
+    QByteArray m_diffResult;
+    bool m_diffFailed;
+    bool m_diffRunning;
+
     QStringList m_stateTexts;
     bool m_blockAddDocument;
 
@@ -25,17 +25,25 @@
 #include "kateapp.h"
 #include "katemainwindow.h"
 #include "katedebug.h"
+#include "katestartuptrace.h"
 
 #include <KConfig>
 #include <KConfigGroup>
 #include <KPluginFactory>
 #include <KPluginLoader>
+#include <KSharedConfig>
 
+#include <QEvent>
 #include <QFile>
 #include <QFileInfo>
 
 #include <ktexteditor/sessionconfiginterface.h>
 
+/**
+ * load deferred plugins at the latest after this time, even if no main window got painted
+ */
+static const int DeferredLoadDelay = 1000;
+
 QString KatePluginInfo::saveName() const
 {
     return QFileInfo(metaData.fileName()).baseName();
@@ -44,6 +52,9 @@ QString KatePluginInfo::saveName() const
 KatePluginManager::KatePluginManager(QObject *parent) : QObject(parent)
 {
     setupPluginList();
+
+    m_deferredTimer.setSingleShot(true);
+    connect(&m_deferredTimer, &QTimer::timeout, this, &KatePluginManager::loadNextDeferredPlugin);
 }
 
 KatePluginManager::~KatePluginManager()
@@ -110,6 +121,8 @@ void KatePluginManager::setupPluginList()
 
 void KatePluginManager::loadConfig(KConfig *config)
 {
+    KateStartupTrace::Span span("KatePluginManager::loadConfig");
+
     // first: unload the plugins
     unloadAllPlugins();
 
@@ -125,11 +138,28 @@ void KatePluginManager::loadConfig(KConfig *config)
         }
     }
 
+    /**
+     * deferred loading: only remember the plugins and their config, they are loaded
+     * once the first main window is painted or they are used
+     */
+    const bool deferred = KConfigGroup(KSharedConfig::openConfig(), "General").readEntry("Deferred Plugin Loading", true);
+    if (deferred) {
+        m_deferredConfig.reset(new KConfig(QString(), KConfig::SimpleConfig));
+    }
+
     /**
      * load plugins
      */
     for (KatePluginList::iterator it = m_pluginList.begin(); it != m_pluginList.end(); ++it) {
         if (it->load) {
+            if (deferred) {
+                m_deferredPlugins.append(&(*it));
+                if (config) {
+                    KConfigGroup(config, QStringLiteral("Plugin:%1:").arg(it->saveName())).copyTo(m_deferredConfig.data());
+                }
+                continue;
+            }
+
             /**
              * load plugin + trigger update of GUI for already existing main windows
              */
@@ -143,6 +173,10 @@ void KatePluginManager::loadConfig(KConfig *config)
             }
         }
     }
+
+    if (!m_deferredPlugins.isEmpty()) {
+        m_deferredTimer.start(DeferredLoadDelay);
+    }
 }
 
 void KatePluginManager::writeConfig(KConfig *config)
@@ -161,10 +195,27 @@ void KatePluginManager::writeConfig(KConfig *config)
             interface->writeSessionConfig(group);
         }
     }
+
+    // deferred plugins did not touch their config yet, keep what they were restored with
+    if (m_deferredPlugins.isEmpty()) {
+        return;
+    }
+    const QStringList groups = m_deferredConfig->groupList();
+    for (KatePluginInfo *item : qAsConst(m_deferredPlugins)) {
+        const QString prefix = QStringLiteral("Plugin:%1:").arg(item->saveName());
+        for (const QString &group : groups) {
+            if (group.startsWith(prefix)) {
+                KConfigGroup(m_deferredConfig.data(), group).copyTo(config);
+            }
+        }
+    }
 }
 
 void KatePluginManager::unloadAllPlugins()
 {
+    m_deferredPlugins.clear();
+    m_deferredTimer.stop();
+
     for (KatePluginList::iterator it = m_pluginList.begin(); it != m_pluginList.end(); ++it) {
         if (it->plugin) {
             unloadPlugin(&(*it));
@@ -179,6 +230,77 @@ void KatePluginManager::enableAllPluginsGUI(KateMainWindow *win, KConfigBase *co
             enablePluginGUI(&(*it), win, config);
         }
     }
+
+    /**
+     * deferred plugins: remember the config of their views, start loading once the window is painted
+     */
+    if (m_deferredPlugins.isEmpty()) {
+        return;
+    }
+    if (config) {
+        for (KatePluginInfo *item : qAsConst(m_deferredPlugins)) {
+            KConfigGroup(config, QStringLiteral("Plugin:%1:MainWindow:0").arg(item->saveName())).copyTo(m_deferredConfig.data());
+        }
+    }
+    win->installEventFilter(this);
+}
+
+bool KatePluginManager::eventFilter(QObject *obj, QEvent *event)
+{
+    if (event->type() == QEvent::Paint) {
+        obj->removeEventFilter(this);
+
+        // first frame is there, load the rest in the following event loop iterations
+        if (!m_deferredPlugins.isEmpty()) {
+            m_deferredTimer.start(0);
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
+void KatePluginManager::loadNextDeferredPlugin()
+{
+    if (m_deferredPlugins.isEmpty()) {
+        return;
+    }
+
+    loadDeferredPlugin(m_deferredPlugins.first());
+
+    // one plugin per iteration, input events are handled in between
+    if (!m_deferredPlugins.isEmpty()) {
+        m_deferredTimer.start(0);
+    }
+}
+
+void KatePluginManager::loadDeferredPlugins()
+{
+    while (!m_deferredPlugins.isEmpty()) {
+        loadDeferredPlugin(m_deferredPlugins.first());
+    }
+    m_deferredTimer.stop();
+}
+
+void KatePluginManager::loadDeferredPlugin(KatePluginInfo *item)
+{
+    if (!loadPlugin(item)) {
+        return;
+    }
+
+    /**
+     * create the views, their toolviews are restored like at window creation
+     */
+    for (int i = 0; i < KateApp::self()->mainWindowsCount(); i++) {
+        KateMainWindow *win = KateApp::self()->mainWindow(i);
+        win->startLateRestore();
+        enablePluginGUI(item, win, m_deferredConfig.data());
+        win->finishLateRestore();
+    }
+
+    // restore config
+    if (auto interface = qobject_cast<KTextEditor::SessionConfigInterface *> (item->plugin)) {
+        KConfigGroup group(m_deferredConfig.data(), QStringLiteral("Plugin:%1:").arg(item->saveName()));
+        interface->readSessionConfig(group);
+    }
 }
 
 void KatePluginManager::disableAllPluginsGUI(KateMainWindow *win)
@@ -192,6 +314,11 @@ void KatePluginManager::disableAllPluginsGUI(KateMainWindow *win)
 
 bool KatePluginManager::loadPlugin(KatePluginInfo *item)
 {
+    KateStartupTrace::Span span("load plugin", item->saveName());
+
+    // loaded now, no longer deferred
+    m_deferredPlugins.removeAll(item);
+
     /**
      * try to load the plugin
      */
@@ -213,6 +340,12 @@ bool KatePluginManager::loadPlugin(KatePluginInfo *item)
 
 void KatePluginManager::unloadPlugin(KatePluginInfo *item)
 {
+    // not loaded yet, just forget it
+    if (m_deferredPlugins.removeAll(item)) {
+        item->load = false;
+        return;
+    }
+
     disablePluginGUI(item);
     delete item->plugin;
     KTextEditor::Plugin *plugin = item->plugin;
@@ -232,6 +365,7 @@ void KatePluginManager::enablePluginGUI(KatePluginInfo *item, KateMainWindow *wi
     QObject *createdView = nullptr;
     if (!win->pluginViews().contains(item->plugin)) {
         // create the view + try to correctly load shortcuts, if it's a GUI Client
+        KateStartupTrace::Span span("createView", item->saveName());
         createdView = item->plugin->createView(win->wrapper());
         if (createdView) {
             win->pluginViews().insert(item->plugin, createdView);
@@ -305,10 +439,24 @@ KTextEditor::Plugin *KatePluginManager::plugin(const QString &name)
         return nullptr;
     }
 
+    /**
+     * first use of a deferred plugin, load it now
+     */
+    KatePluginInfo *item = m_name2Plugin.value(name);
+    if (m_deferredPlugins.contains(item)) {
+        loadDeferredPlugin(item);
+    }
+
     /**
      * real plugin instance, if any ;)
      */
-    return m_name2Plugin.value(name)->plugin;
+    return item->plugin;
+}
+
+KTextEditor::Plugin *KatePluginManager::loadedPlugin(const QString &name) const
+{
+    KatePluginInfo *item = m_name2Plugin.value(name);
+    return item ? item->plugin : nullptr;
 }
 
 bool KatePluginManager::pluginAvailable(const QString &name)
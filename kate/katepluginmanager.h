@@ -30,6 +30,8 @@
 #include <QObject>
 #include <QList>
 #include <QMap>
+#include <QScopedPointer>
+#include <QTimer>
 
 class KConfig;
 class KateMainWindow;
@@ -80,15 +82,46 @@ public:
         return m_pluginList;
     }
 
+    /**
+     * Get a plugin, a deferred one is loaded now.
+     * @param name plugin name
+     * @return plugin or nullptr if not loaded
+     */
     KTextEditor::Plugin *plugin(const QString &name);
+
+    /**
+     * Get a plugin only if it is loaded already, a deferred one stays deferred.
+     * @param name plugin name
+     * @return plugin or nullptr if not loaded
+     */
+    KTextEditor::Plugin *loadedPlugin(const QString &name) const;
     bool pluginAvailable(const QString &name);
 
     KTextEditor::Plugin *loadPlugin(const QString &name, bool permanent = true);
     void unloadPlugin(const QString &name, bool permanent = true);
 
+    /**
+     * Load all plugins whose loading was deferred, e.g. before their config is needed.
+     */
+    void loadDeferredPlugins();
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override;
+
+private Q_SLOTS:
+    /**
+     * Load the next deferred plugin, one per event loop iteration.
+     */
+    void loadNextDeferredPlugin();
+
 private:
     void setupPluginList();
 
+    /**
+     * Load a deferred plugin, create its views and restore its session config.
+     */
+    void loadDeferredPlugin(KatePluginInfo *item);
+
     /**
      * all known plugins
      */
@@ -99,6 +132,22 @@ private:
      * uses the info stored in the plugin list
      */
     QMap<QString, KatePluginInfo *> m_name2Plugin;
+
+    /**
+     * plugins to load once the first main window is painted or on first use
+     */
+    QList<KatePluginInfo *> m_deferredPlugins;
+
+    /**
+     * copy of the session config of the deferred plugins and their views,
+     * the session config itself is rewritten on save
+     */
+    QScopedPointer<KConfig> m_deferredConfig;
+
+    /**
+     * drives the loading of the deferred plugins
+     */
+    QTimer m_deferredTimer;
 };
 
 #endif
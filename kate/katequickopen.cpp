@@ -38,7 +38,6 @@
 
 #include <QEvent>
 #include <QFileInfo>
-#include <QSortFilterProxyModel>
 #include <QCoreApplication>
 #include <QPointer>
 #include <QStandardItemModel>
@@ -69,25 +68,18 @@ KateQuickOpen::KateQuickOpen(QWidget *parent, KateMainWindow *mainWindow)
     m_listView = new QTreeView();
     layout->addWidget(m_listView, 1);
     m_listView->setTextElideMode(Qt::ElideLeft);
+    m_listView->setUniformRowHeights(true);
 
-    m_base_model = new KateQuickOpenModel(m_mainWindow, this);
+    m_model = new KateQuickOpenModel(m_mainWindow, this);
+    m_model->setMatchMode(m_matchMode);
 
-    m_model = new QSortFilterProxyModel(this);
-    m_model->setFilterRole(Qt::DisplayRole);
-    m_model->setSortRole(Qt::DisplayRole);
-    m_model->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    m_model->setSortCaseSensitivity(Qt::CaseInsensitive);
-    m_model->setFilterKeyColumn(m_matchMode);
-
-    connect(m_inputLine, &KLineEdit::textChanged, m_model, &QSortFilterProxyModel::setFilterWildcard);
+    connect(m_inputLine, &KLineEdit::textChanged, m_model, &KateQuickOpenModel::setFilterString);
     connect(m_inputLine, &KLineEdit::returnPressed, this, &KateQuickOpen::slotReturnPressed);
-    connect(m_model, &QSortFilterProxyModel::rowsInserted, this, &KateQuickOpen::reselectFirst);
-    connect(m_model, &QSortFilterProxyModel::rowsRemoved, this, &KateQuickOpen::reselectFirst);
+    connect(m_model, &KateQuickOpenModel::modelReset, this, &KateQuickOpen::reselectFirst);
 
     connect(m_listView, &QTreeView::activated, this, &KateQuickOpen::slotReturnPressed);
 
     m_listView->setModel(m_model);
-    m_model->setSourceModel(m_base_model);
 
     m_inputLine->installEventFilter(this);
     m_listView->installEventFilter(this);
@@ -138,6 +130,12 @@ bool KateQuickOpen::eventFilter(QObject *obj, QEvent *event)
     return QWidget::eventFilter(obj, event);
 }
 
+void KateQuickOpen::setMatchMode(int mode)
+{
+    m_matchMode = mode;
+    m_model->setMatchMode(mode);
+}
+
 void KateQuickOpen::reselectFirst()
 {
     QModelIndex index = m_model->index(0, 0);
@@ -146,7 +144,7 @@ void KateQuickOpen::reselectFirst()
 
 void KateQuickOpen::update()
 {
-    m_base_model->refresh();
+    m_model->refresh();
     m_listView->resizeColumnToContents(0);
 
     // If we have a very long file name we restrict the size of the first column
@@ -27,7 +27,6 @@ class KLineEdit;
 
 class QModelIndex;
 class QStandardItemModel;
-class QSortFilterProxyModel;
 class QTreeView;
 class KateQuickOpenModel;
 
@@ -42,9 +41,7 @@ public:
      */
     void update();
 
-    void setMatchMode(int mode) {
-        m_matchMode = mode;
-    }
+    void setMatchMode(int mode);
 
     int matchMode() {
         return m_matchMode;
@@ -68,14 +65,9 @@ private:
     KLineEdit *m_inputLine;
 
     /**
-     * our model we search in
-     */
-    KateQuickOpenModel *m_base_model;
-
-    /**
-     * filtered model we search in
+     * our model we search in, does the filtering itself
      */
-    QSortFilterProxyModel *m_model;
+    KateQuickOpenModel *m_model;
 
     int m_matchMode;
 };
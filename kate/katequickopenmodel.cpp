@@ -21,14 +21,120 @@
 
 #include "katemainwindow.h"
 #include "kateviewmanager.h"
+#include "katefuzzymatcher.h"
 #include "kateapp.h"
+#include "katedocmanager.h"
 
 #include <ktexteditor/document.h>
 #include <ktexteditor/view.h>
 
+#include <QMutexLocker>
+#include <QRunnable>
+
+#include <algorithm>
+
+/**
+ * maximal number of shown matches
+ */
+static const int MaxFilterResults = 1000;
+
+/**
+ * filter more candidates than this in the worker thread
+ */
+static const int AsyncFilterThreshold = 20000;
+
+/**
+ * One match of a filter run.
+ */
+struct ScoredEntry {
+    int score;
+    int position; // in the candidates
+    int index;
+};
+
+/**
+ * Filters the entries for one pattern in a worker thread.
+ * Gets (implicitly shared) copies of all data, the model can change meanwhile.
+ */
+class KateQuickOpenFilterJob : public QRunnable
+{
+public:
+    KateQuickOpenFilterJob(QObject *model, QMutex *mutex, KateQuickOpenFilterResult *target, int generation,
+                           const QVector<ModelEntry> &entries, const QVector<quint64> &masks, int matchMode,
+                           const QString &pattern, const QVector<int> &candidates)
+        : m_model(model)
+        , m_mutex(mutex)
+        , m_target(target)
+        , m_generation(generation)
+        , m_entries(entries)
+        , m_masks(masks)
+        , m_matchMode(matchMode)
+        , m_pattern(pattern)
+        , m_candidates(candidates)
+    {
+    }
+
+    void run() override
+    {
+        KateQuickOpenFilterResult result;
+        result.generation = m_generation;
+        result.pattern = m_pattern;
+        KateQuickOpenModel::filter(m_entries, m_masks, m_matchMode, m_pattern, m_candidates, result);
+
+        {
+            QMutexLocker locker(m_mutex);
+            *m_target = result;
+        }
+        QMetaObject::invokeMethod(m_model, "filterDone", Qt::QueuedConnection);
+    }
+
+private:
+    QObject *const m_model;
+    QMutex *const m_mutex;
+    KateQuickOpenFilterResult *const m_target;
+    const int m_generation;
+    const QVector<ModelEntry> m_entries;
+    const QVector<quint64> m_masks;
+    const int m_matchMode;
+    const QString m_pattern;
+    const QVector<int> m_candidates;
+};
+
 KateQuickOpenModel::KateQuickOpenModel(KateMainWindow *mainWindow, QObject *parent) :
-    QAbstractTableModel (parent), m_mainWindow(mainWindow)
+    QAbstractTableModel (parent), m_orderDirty(false), m_matchMode(Columns::FileName), m_filterGeneration(0), m_mainWindow(mainWindow)
 {
+    // one worker, the results arrive in the order the runs were started
+    m_filterPool.setMaxThreadCount(1);
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(0);
+    connect(&m_updateTimer, &QTimer::timeout, this, &KateQuickOpenModel::applyEntryChanges);
+
+    /**
+     * track the documents, the existing ones and all to come
+     */
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    connect(docManager, &KateDocManager::documentCreated, this, &KateQuickOpenModel::slotDocumentCreated);
+    connect(docManager, &KateDocManager::documentWillBeDeleted, this, &KateQuickOpenModel::slotDocumentWillBeDeleted);
+    const QList<KTextEditor::Document *> documents = docManager->documentList();
+    for (KTextEditor::Document *document : documents) {
+        slotDocumentCreated(document);
+    }
+
+    /**
+     * track the project plugin, it may be loaded and unloaded any time
+     * the plugin views of our window are created after us, they are announced, too
+     */
+    connect(m_mainWindow->wrapper(), &KTextEditor::MainWindow::pluginViewCreated, this, &KateQuickOpenModel::slotPluginViewCreated);
+    connect(m_mainWindow->wrapper(), &KTextEditor::MainWindow::pluginViewDeleted, this, &KateQuickOpenModel::slotPluginViewDeleted);
+
+    applyEntryChanges();
+}
+
+KateQuickOpenModel::~KateQuickOpenModel()
+{
+    m_filterPool.clear();
+    m_filterPool.waitForDone();
 }
 
 int KateQuickOpenModel::rowCount(const QModelIndex& parent) const
@@ -36,7 +142,7 @@ int KateQuickOpenModel::rowCount(const QModelIndex& parent) const
     if (parent.isValid()) {
         return 0;
     }
-    return m_modelEntries.size();
+    return m_filterResult.rows.size();
 }
 
 int KateQuickOpenModel::columnCount(const QModelIndex& parent) const
@@ -55,20 +161,20 @@ QVariant KateQuickOpenModel::data(const QModelIndex& idx, int role) const
         return {};
     }
 
-    auto entry = m_modelEntries.at(idx.row());
+    const ModelEntry &entry = m_modelEntries.at(m_filterResult.rows.at(idx.row()));
     if (role == Qt::DisplayRole) {
         switch(idx.column()) {
-            case Columns::FileName: return entry.fileName;
+            case Columns::FileName: return entry.fileName().toString();
             case Columns::FilePath: return entry.filePath;
         }
     } else if (role == Qt::FontRole) {
-        if (entry.bold) {
+        if (entry.documents > 0) {
             QFont font;
             font.setBold(true);
             return font;
         }
     } else if (role == Qt::UserRole) {
-        return entry.url;
+        return (entry.documents > 0) ? entry.url : QUrl::fromLocalFile(entry.filePath);
     }
 
     return {};
@@ -76,63 +182,384 @@ QVariant KateQuickOpenModel::data(const QModelIndex& idx, int role) const
 
 void KateQuickOpenModel::refresh()
 {
-    QObject *projectView = m_mainWindow->pluginView(QStringLiteral("kateprojectplugin"));
-    const QList<KTextEditor::View *> sortedViews = m_mainWindow->viewManager()->sortedViews();
-    const QList<KTextEditor::Document *> openDocs = KateApp::self()->documentManager()->documentList();
-    const QStringList projectDocs = projectView ? projectView->property("projectFiles").toStringList() : QStringList();
+    // show what changed since the last event loop iteration, too
+    if (m_updateTimer.isActive()) {
+        m_updateTimer.stop();
+        applyEntryChanges();
+    }
+}
+
+void KateQuickOpenModel::slotDocumentCreated(KTextEditor::Document *document)
+{
+    connect(document, &KTextEditor::Document::documentUrlChanged, this, &KateQuickOpenModel::slotDocumentChanged);
+    connect(document, &KTextEditor::Document::documentNameChanged, this, &KateQuickOpenModel::slotDocumentChanged);
+    slotDocumentChanged(document);
+}
+
+void KateQuickOpenModel::slotDocumentChanged(KTextEditor::Document *document)
+{
+    // lazy restored documents are not loaded yet, use the url they will load
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    const QUrl url = docManager->documentUrl(document);
+    const QString path = url.toString(QUrl::NormalizePathSegments | QUrl::PreferLocalFile);
 
-    QVector<ModelEntry> allDocuments;
-    allDocuments.resize(sortedViews.size() + openDocs.size() + projectDocs.size());
+    /**
+     * moved to another path? leave the old entry
+     */
+    const auto it = m_documentPaths.find(document);
+    if (it != m_documentPaths.end() && it.value() != path) {
+        const int old = m_entryIndex.value(it.value());
+        beginEntryChange(old);
+        --m_modelEntries[old].documents;
+        endEntryChange(old);
+        m_documentPaths.erase(it);
+    }
 
-    for (auto *view : qAsConst(sortedViews)) {
-        auto doc = view->document();
-        allDocuments.push_back({ doc->url(), doc->documentName(), doc->url().toDisplayString(QUrl::NormalizePathSegments | QUrl::PreferLocalFile), false });
+    const int index = entryForPath(path);
+    beginEntryChange(index);
+    ModelEntry &entry = m_modelEntries[index];
+    if (!m_documentPaths.contains(document)) {
+        m_documentPaths.insert(document, path);
+        ++entry.documents;
     }
+    entry.documentName = docManager->documentName(document);
+    entry.url = url;
+    endEntryChange(index);
+
+    scheduleUpdate();
+}
 
-    QStringList openedUrls;
-    openedUrls.reserve(openDocs.size());
-    for (auto *doc : qAsConst(openDocs)) {
-        const auto normalizedUrl = doc->url().toString(QUrl::NormalizePathSegments | QUrl::PreferLocalFile);
-        allDocuments.push_back({ doc->url(), doc->documentName(), normalizedUrl, false });
-        openedUrls.push_back(normalizedUrl);
+void KateQuickOpenModel::slotDocumentWillBeDeleted(KTextEditor::Document *document)
+{
+    const auto it = m_documentPaths.find(document);
+    if (it == m_documentPaths.end()) {
+        return;
     }
 
-    for (const auto& file : qAsConst(projectDocs)) {
-        QFileInfo fi(file);
-        const auto localFile = QUrl::fromLocalFile(fi.absoluteFilePath());
-        allDocuments.push_back({
-            localFile,
-            fi.fileName(),
-            localFile.toString(QUrl::NormalizePathSegments | QUrl::PreferLocalFile), false });
+    const int index = m_entryIndex.value(it.value());
+    beginEntryChange(index);
+    if (--m_modelEntries[index].documents == 0) {
+        m_modelEntries[index].documentName.clear();
+        m_modelEntries[index].url.clear();
     }
+    endEntryChange(index);
+    m_documentPaths.erase(it);
 
-    /** Sort the arrays by filePath. */
-    std::sort(std::begin(allDocuments), std::end(allDocuments),
-        [](const ModelEntry& a, const ModelEntry& b) {
-        return a.filePath < b.filePath;
-    });
+    scheduleUpdate();
+}
+
+void KateQuickOpenModel::slotPluginViewCreated(const QString &name, QObject *pluginView)
+{
+    if (name == QLatin1String("kateprojectplugin")) {
+        setProjectView(pluginView);
+    }
+}
+
+void KateQuickOpenModel::slotPluginViewDeleted(const QString &name, QObject *pluginView)
+{
+    if (name == QLatin1String("kateprojectplugin") && pluginView == m_projectView) {
+        setProjectView(nullptr);
+    }
+}
+
+void KateQuickOpenModel::setProjectView(QObject *pluginView)
+{
+    if (m_projectView) {
+        disconnect(m_projectView, nullptr, this, nullptr);
+    }
+
+    m_projectView = pluginView;
+    if (m_projectView) {
+        // the plugin is no link dependency, connect by name
+        connect(m_projectView, SIGNAL(projectFilesChanged()), this, SLOT(slotProjectFilesChanged()));
+    }
 
-    /** remove Duplicates. */
-    allDocuments.erase(
-        std::unique(allDocuments.begin(), allDocuments.end(),
-        [](const ModelEntry& a, const ModelEntry& b) {
-            return a.filePath == b.filePath;
-        }),
-        std::end(allDocuments));
-
-    for (auto& doc : allDocuments) {
-        if (Q_UNLIKELY(openedUrls.indexOf(doc.filePath) != -1)) {
-            doc.bold = true;
+    slotProjectFilesChanged();
+}
+
+void KateQuickOpenModel::slotProjectFilesChanged()
+{
+    const QStringList files = m_projectView ? m_projectView->property("projectFiles").toStringList() : QStringList();
+    QSet<QString> projectFiles;
+    projectFiles.reserve(files.size());
+    for (const QString &file : files) {
+        projectFiles.insert(file);
+    }
+
+    /**
+     * apply the difference, often the project only switched or got a few files more or less
+     * bulk change: the order is sorted once afterwards
+     */
+    const bool orderDirty = m_orderDirty;
+    m_orderDirty = true;
+    bool changed = false;
+    for (const QString &file : qAsConst(m_projectFiles)) {
+        if (!projectFiles.contains(file)) {
+            const int index = m_entryIndex.value(file);
+            beginEntryChange(index);
+            m_modelEntries[index].projectFile = false;
+            endEntryChange(index);
+            changed = true;
         }
     }
+    for (const QString &file : qAsConst(projectFiles)) {
+        if (!m_projectFiles.contains(file)) {
+            const int index = entryForPath(file);
+            beginEntryChange(index);
+            m_modelEntries[index].projectFile = true;
+            endEntryChange(index);
+            changed = true;
+        }
+    }
+    m_projectFiles = projectFiles;
 
-    /** sort the arrays via boldness (open or not */
-    std::sort(std::begin(allDocuments), std::end(allDocuments),
-        [](const ModelEntry& a, const ModelEntry& b) {
-        return a.bold > b.bold;
-    });
+    if (changed) {
+        scheduleUpdate();
+    } else {
+        // nothing touched, the order is still valid
+        m_orderDirty = orderDirty;
+    }
+}
+
+int KateQuickOpenModel::entryForPath(const QString &path)
+{
+    const auto it = m_entryIndex.constFind(path);
+    if (it != m_entryIndex.constEnd()) {
+        return it.value();
+    }
+
+    int index;
+    if (m_freeEntries.isEmpty()) {
+        index = m_modelEntries.size();
+        m_modelEntries.append(ModelEntry());
+        m_masks.append(0);
+    } else {
+        index = m_freeEntries.takeLast();
+    }
+
+    ModelEntry &entry = m_modelEntries[index];
+    entry.filePath = path;
+    entry.fileNameStart = path.lastIndexOf(QLatin1Char('/')) + 1;
+    entry.documents = 0;
+    entry.projectFile = false;
+    m_entryIndex.insert(path, index);
+    return index;
+}
+
+bool KateQuickOpenModel::orderLessThan(int a, int b) const
+{
+    const ModelEntry &entryA = m_modelEntries.at(a);
+    const ModelEntry &entryB = m_modelEntries.at(b);
+    if ((entryA.documents > 0) != (entryB.documents > 0)) {
+        return entryA.documents > 0;
+    }
+    return entryA.filePath < entryB.filePath;
+}
+
+void KateQuickOpenModel::beginEntryChange(int index)
+{
+    if (m_orderDirty || !m_modelEntries.at(index).isListed()) {
+        return;
+    }
+
+    const auto lessThan = [this](int a, int b) { return orderLessThan(a, b); };
+    const auto it = std::lower_bound(m_order.begin(), m_order.end(), index, lessThan);
+    Q_ASSERT(it != m_order.end() && *it == index);
+    m_order.erase(it);
+}
+
+void KateQuickOpenModel::endEntryChange(int index)
+{
+    ModelEntry &entry = m_modelEntries[index];
+    if (!entry.isListed()) {
+        // unused, free the slot
+        m_entryIndex.remove(entry.filePath);
+        entry.filePath.clear();
+        entry.documentName.clear();
+        entry.url.clear();
+        m_masks[index] = 0;
+        m_freeEntries.append(index);
+        return;
+    }
+
+    updateMask(index);
+    if (m_orderDirty) {
+        return;
+    }
+
+    const auto lessThan = [this](int a, int b) { return orderLessThan(a, b); };
+    m_order.insert(std::lower_bound(m_order.begin(), m_order.end(), index, lessThan), index);
+}
+
+void KateQuickOpenModel::scheduleUpdate()
+{
+    if (!m_updateTimer.isActive()) {
+        m_updateTimer.start();
+    }
+}
+
+void KateQuickOpenModel::applyEntryChanges()
+{
+    if (m_orderDirty) {
+        m_order.clear();
+        m_order.reserve(m_entryIndex.size());
+        for (int i = 0; i < m_modelEntries.size(); ++i) {
+            if (m_modelEntries.at(i).isListed()) {
+                m_order.append(i);
+            }
+        }
+        std::sort(m_order.begin(), m_order.end(), [this](int a, int b) { return orderLessThan(a, b); });
+        m_orderDirty = false;
+    }
 
     beginResetModel();
-    m_modelEntries = allDocuments;
+    resetFilterResult();
     endResetModel();
+
+    startFilter();
+}
+
+void KateQuickOpenModel::updateMasks()
+{
+    for (int i = 0; i < m_modelEntries.size(); ++i) {
+        updateMask(i);
+    }
+}
+
+void KateQuickOpenModel::updateMask(int index)
+{
+    const ModelEntry &entry = m_modelEntries.at(index);
+    if (!entry.isListed()) {
+        m_masks[index] = 0;
+        return;
+    }
+    m_masks[index] = KateFuzzyMatcher::charMask((m_matchMode == Columns::FilePath) ? QStringRef(&entry.filePath) : entry.fileName());
+}
+
+void KateQuickOpenModel::setMatchMode(int mode)
+{
+    if (mode == m_matchMode) {
+        return;
+    }
+
+    beginResetModel();
+    m_matchMode = mode;
+    updateMasks();
+    resetFilterResult();
+    endResetModel();
+
+    startFilter();
+}
+
+void KateQuickOpenModel::setFilterString(const QString &pattern)
+{
+    m_pattern = pattern;
+    startFilter();
+}
+
+void KateQuickOpenModel::resetFilterResult()
+{
+    // invalidates running filters, too
+    ++m_filterGeneration;
+
+    m_filterResult.generation = m_filterGeneration;
+    m_filterResult.pattern.clear();
+    m_filterResult.matches = m_order;
+    m_filterResult.rows = m_order;
+}
+
+void KateQuickOpenModel::startFilter()
+{
+    // new run, results of older runs are obsolete
+    ++m_filterGeneration;
+    m_filterPool.clear();
+
+    if (m_pattern.isEmpty()) {
+        beginResetModel();
+        resetFilterResult();
+        endResetModel();
+        return;
+    }
+
+    /**
+     * a longer pattern only matches a subset of the shorter one's matches
+     */
+    const QVector<int> candidates = m_pattern.startsWith(m_filterResult.pattern, Qt::CaseInsensitive) ? m_filterResult.matches : m_order;
+
+    if (candidates.size() < AsyncFilterThreshold) {
+        KateQuickOpenFilterResult result;
+        result.generation = m_filterGeneration;
+        result.pattern = m_pattern;
+        filter(m_modelEntries, m_masks, m_matchMode, m_pattern, candidates, result);
+        applyFilterResult(result);
+        return;
+    }
+
+    m_filterPool.start(new KateQuickOpenFilterJob(this, &m_finishedMutex, &m_finishedResult, m_filterGeneration,
+                                                  m_modelEntries, m_masks, m_matchMode, m_pattern, candidates));
+}
+
+void KateQuickOpenModel::filterDone()
+{
+    KateQuickOpenFilterResult result;
+    {
+        QMutexLocker locker(&m_finishedMutex);
+        result = m_finishedResult;
+    }
+
+    // the pattern or the entries changed meanwhile
+    if (result.generation != m_filterGeneration) {
+        return;
+    }
+
+    applyFilterResult(result);
+}
+
+void KateQuickOpenModel::applyFilterResult(const KateQuickOpenFilterResult &result)
+{
+    beginResetModel();
+    m_filterResult = result;
+    endResetModel();
+}
+
+void KateQuickOpenModel::filter(const QVector<ModelEntry> &entries, const QVector<quint64> &masks, int matchMode,
+                                const QString &pattern, const QVector<int> &candidates, KateQuickOpenFilterResult &result)
+{
+    const quint64 patternMask = KateFuzzyMatcher::charMask(pattern);
+
+    QVector<ScoredEntry> scored;
+    for (int position = 0; position < candidates.size(); ++position) {
+        const int index = candidates.at(position);
+
+        // cheap rejection of entries lacking some character of the pattern
+        if ((masks.at(index) & patternMask) != patternMask) {
+            continue;
+        }
+
+        const ModelEntry &entry = entries.at(index);
+        const QStringRef text = (matchMode == Columns::FilePath) ? QStringRef(&entry.filePath) : entry.fileName();
+        const int basenameStart = (matchMode == Columns::FilePath) ? entry.fileNameStart : 0;
+        int score = 0;
+        if (KateFuzzyMatcher::match(pattern, text, basenameStart, score)) {
+            result.matches.append(index);
+            scored.append({score, position, index});
+        }
+    }
+
+    /**
+     * best score first, else keep the order of the candidates: open documents first, then by path
+     */
+    const int count = qMin(MaxFilterResults, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(),
+        [](const ScoredEntry &a, const ScoredEntry &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.position < b.position;
+    });
+
+    result.rows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result.rows.append(scored.at(i).index);
+    }
 }
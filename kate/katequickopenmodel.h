@@ -21,17 +21,54 @@
 #define KATEQUICKOPENMODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <QUrl>
 #include <QVector>
 #include <tuple>
 #include <QVariant>
 
 #include "katemainwindow.h"
 
+/**
+ * One file shown in quick open, an open document and/or a file of the active project.
+ * The path is stored once, the file name is a slice of it.
+ */
 struct ModelEntry {
-    QUrl url; // used for actually opening a selected file (local or remote)
-    QString fileName; // display string for left column
-    QString filePath; // display string for right column
-    bool bold; // format line in bold text or not
+    QString filePath; // key and display string for right column
+    QString documentName; // display string for left column of open documents
+    QUrl url; // used for actually opening an open document (local or remote), project files are local
+    int fileNameStart; // file name of project files is filePath.midRef(fileNameStart)
+    int documents; // number of open documents with this path, shown in bold text
+    bool projectFile; // file of the active project
+
+    /**
+     * Display string for left column.
+     */
+    QStringRef fileName() const {
+        return (documents > 0) ? QStringRef(&documentName) : filePath.midRef(fileNameStart);
+    }
+
+    /**
+     * Is this entry shown at all? Unused entries are free slots.
+     */
+    bool isListed() const {
+        return documents > 0 || projectFile;
+    }
+};
+
+/**
+ * Result of one filter run, see KateQuickOpenModel::setFilterString().
+ */
+struct KateQuickOpenFilterResult {
+    int generation;
+    QString pattern;
+    QVector<int> matches; // all matching entries, the base for refining a longer pattern
+    QVector<int> rows; // top ranked matches, shown
 };
 
 class KateQuickOpenModel : public QAbstractTableModel {
@@ -39,13 +76,187 @@ class KateQuickOpenModel : public QAbstractTableModel {
 public:
     enum Columns : int { FileName, FilePath, Bold };
     explicit KateQuickOpenModel(KateMainWindow *mainWindow, QObject *parent=nullptr);
+    ~KateQuickOpenModel() override;
     int rowCount(const QModelIndex& parent) const override;
     int columnCount(const QModelIndex& parent) const override;
     QVariant data(const QModelIndex& idx, int role) const override;
+
+    /**
+     * Make pending changes of the entries visible, called before quick open is shown.
+     * The entries are kept up to date incrementally, this is cheap.
+     */
     void refresh();
 
+    /**
+     * Show only entries fuzzy matching the pattern, best first.
+     * Refines the last result if the pattern got longer, large lists are filtered in a worker thread.
+     * @param pattern pattern to match, empty to show all
+     */
+    void setFilterString(const QString &pattern);
+
+    /**
+     * Column the filter matches against.
+     * @param mode Columns::FileName or Columns::FilePath
+     */
+    void setMatchMode(int mode);
+
+    /**
+     * Filter entries, thread-safe.
+     * @param entries all entries
+     * @param masks character masks of the matched column of the entries
+     * @param matchMode column to match against
+     * @param pattern pattern to match, non-empty
+     * @param candidates entries to check, equal scores keep this order
+     * @param result filled with matches and ranked rows
+     */
+    static void filter(const QVector<ModelEntry> &entries, const QVector<quint64> &masks, int matchMode,
+                       const QString &pattern, const QVector<int> &candidates, KateQuickOpenFilterResult &result);
+
+private Q_SLOTS:
+    /**
+     * A worker finished filtering.
+     */
+    void filterDone();
+
+    /**
+     * Track documents, the path or name of a tracked document changed.
+     */
+    void slotDocumentCreated(KTextEditor::Document *document);
+    void slotDocumentChanged(KTextEditor::Document *document);
+    void slotDocumentWillBeDeleted(KTextEditor::Document *document);
+
+    /**
+     * Track the project plugin view, it provides the project files.
+     */
+    void slotPluginViewCreated(const QString &name, QObject *pluginView);
+    void slotPluginViewDeleted(const QString &name, QObject *pluginView);
+
+    /**
+     * The files of the active project changed.
+     */
+    void slotProjectFilesChanged();
+
+    /**
+     * Show the changed entries, coalesces all changes of one event loop iteration.
+     */
+    void applyEntryChanges();
+
+private:
+    /**
+     * Remember the project plugin view and read its files.
+     */
+    void setProjectView(QObject *pluginView);
+
+    /**
+     * Entry for a path, a new unlisted one if not known yet.
+     */
+    int entryForPath(const QString &path);
+
+    /**
+     * Bracket changes of an entry that may change its position in the unfiltered order.
+     * Unused entries are freed at the end.
+     */
+    void beginEntryChange(int index);
+    void endEntryChange(int index);
+
+    /**
+     * Order of the unfiltered entries: open documents first, then by path.
+     */
+    bool orderLessThan(int a, int b) const;
+
+    /**
+     * Schedule applyEntryChanges().
+     */
+    void scheduleUpdate();
+
+    /**
+     * (Re-)start filtering for m_pattern.
+     */
+    void startFilter();
+
+    /**
+     * Show a filter result.
+     */
+    void applyFilterResult(const KateQuickOpenFilterResult &result);
+
+    /**
+     * Show all entries unfiltered, the base for the next filter run.
+     * Must be called inside a model reset.
+     */
+    void resetFilterResult();
+
+    /**
+     * Compute the character masks of all entries.
+     */
+    void updateMasks();
+
+    /**
+     * Compute the character mask of one entry.
+     */
+    void updateMask(int index);
+
 private:
+    /**
+     * all entries, indices are stable, unused slots are reused
+     */
     QVector<ModelEntry> m_modelEntries;
+    QVector<int> m_freeEntries;
+
+    /**
+     * path => entry
+     */
+    QHash<QString, int> m_entryIndex;
+
+    /**
+     * listed entries in unfiltered order, see orderLessThan()
+     * after bulk changes it is invalid until the next applyEntryChanges()
+     */
+    QVector<int> m_order;
+    bool m_orderDirty;
+
+    /**
+     * tracked documents => their path
+     */
+    QHash<KTextEditor::Document *, QString> m_documentPaths;
+
+    /**
+     * project plugin view and the files of its active project
+     */
+    QPointer<QObject> m_projectView;
+    QSet<QString> m_projectFiles;
+
+    /**
+     * coalesces entry changes
+     */
+    QTimer m_updateTimer;
+
+    /**
+     * character masks of the matched column, for prefiltering
+     */
+    QVector<quint64> m_masks;
+
+    /**
+     * current filter pattern and match mode
+     */
+    QString m_pattern;
+    int m_matchMode;
+
+    /**
+     * last applied filter result, its rows are shown
+     */
+    KateQuickOpenFilterResult m_filterResult;
+
+    /**
+     * worker for large lists, finished results are handed over in m_finishedResult
+     */
+    QThreadPool m_filterPool;
+    QMutex m_finishedMutex;
+    KateQuickOpenFilterResult m_finishedResult;
+
+    /**
+     * incremented for each filter run and each change of the entries
+     */
+    int m_filterGeneration;
 
     /* TODO: don't rely in a pointer to the main window.
     * this is bad engineering, but current code is too tight
@@ -22,10 +22,18 @@
 #include <QStringList>
 #include <QCoreApplication>
 #include <QDBusConnectionInterface>
+#include <QDBusPendingCall>
+#include <QDBusPendingReply>
+#include <QPair>
 
 int KateRunningInstanceInfo::dummy_session = 0;
 
-bool fillinRunningKateAppInstances(KateRunningInstanceMap *map)
+/**
+ * instances not answering in this time are skipped, they are busy or hang
+ */
+static const int InstanceInfoTimeout = 2000;
+
+bool fillinRunningKateAppInstances(KateRunningInstanceMap *map, bool queryActivity)
 {
     QDBusConnectionInterface *i = QDBusConnection::sessionBus().interface();
     if (!i) {
@@ -39,25 +47,60 @@ bool fillinRunningKateAppInstances(KateRunningInstanceMap *map)
         services = servicesReply.value();
     }
 
-    QString serviceName;
+    // current activity, don't wait for the default timeout if there is no activity manager at all
+    QString currentActivity;
+    if (queryActivity && services.contains(QStringLiteral("org.kde.ActivityManager"))) {
+        QDBusMessage m = QDBusMessage::createMethodCall(
+                                        QStringLiteral("org.kde.ActivityManager"),
+                                        QStringLiteral("/ActivityManager/Activities"), QStringLiteral("org.kde.ActivityManager.Activities"), QStringLiteral("CurrentActivity"));
+        QDBusReply<QString> activity = QDBusConnection::sessionBus().call(m, QDBus::Block, InstanceInfoTimeout);
+        if (activity.isValid()) {
+            currentActivity = activity.value();
+        }
+    }
 
     QString my_pid = QString::number(QCoreApplication::applicationPid());
 
+    // ask all instances at once, the answers arrive in parallel
+    QList<QPair<QString, QDBusPendingCall>> calls;
     foreach(const QString & s, services) {
         if (s.startsWith(QStringLiteral("org.kde.kate-"))) {
             if (s.contains(my_pid)) {
                 continue;
             }
-            KateRunningInstanceInfo *rii = new KateRunningInstanceInfo(s);
-            if (rii->valid) {
-                if (map->contains(rii->sessionName)) {
-                    return false;    //ERROR no two instances may have the same session name
-                }
-                map->insert(rii->sessionName, rii);
-                //std::cerr<<qPrintable(s)<<"running instance:"<< rii->sessionName.toUtf8().data()<<std::endl;
-            } else {
+            QDBusMessage m = QDBusMessage::createMethodCall(s,
+                                    QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("instanceInfo"));
+            m << currentActivity;
+            calls.append(qMakePair(s, QDBusConnection::sessionBus().asyncCall(m, InstanceInfoTimeout)));
+        }
+    }
+
+    for (const auto &call : qAsConst(calls)) {
+        QDBusPendingReply<QVariantMap> reply = call.second;
+        reply.waitForFinished();
+
+        KateRunningInstanceInfo *rii = nullptr;
+        if (reply.isValid()) {
+            rii = new KateRunningInstanceInfo(call.first, reply.value());
+        } else if (reply.error().type() == QDBusError::UnknownMethod) {
+            // older kate, ask the old way
+            rii = new KateRunningInstanceInfo(call.first, currentActivity);
+            if (queryActivity && rii->valid) {
+                rii->queryDesktop();
+            }
+        } else {
+            continue;
+        }
+
+        if (rii->valid) {
+            if (map->contains(rii->sessionName)) {
                 delete rii;
+                return false;    //ERROR no two instances may have the same session name
             }
+            map->insert(rii->sessionName, rii);
+            //std::cerr<<qPrintable(call.first)<<"running instance:"<< rii->sessionName.toUtf8().data()<<std::endl;
+        } else {
+            delete rii;
         }
     }
     return true;
@@ -24,6 +24,8 @@
 #include <QMap>
 #include <QDBusInterface>
 #include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusReply>
 #include <QVariant>
 #include <iostream>
 
@@ -32,19 +34,87 @@ class KateRunningInstanceInfo: public QObject
     Q_OBJECT
 
 public:
-    KateRunningInstanceInfo(const QString &serviceName_):
+    /**
+     * Query the instance, blocking, one call per information.
+     * Only needed for instances without instanceInfo(), e.g. from older versions.
+     * @param serviceName_ dbus service of the instance
+     * @param activity current activity, may be empty
+     */
+    KateRunningInstanceInfo(const QString &serviceName_, const QString &activity = QString()):
         QObject(), valid(false),
         serviceName(serviceName_),
-        dbus_if(new QDBusInterface(serviceName_, QStringLiteral("/MainApplication"),
-                                   QString(), //I don't know why it does not work if I specify org.kde.Kate.Application here
-                                   QDBusConnection::sessionBus(), this)) {
-        if (!dbus_if->isValid()) {
+        onActivity(true),
+        desktop(0) {
+        QDBusInterface dbus_if(serviceName_, QStringLiteral("/MainApplication"),
+                               QString(), //I don't know why it does not work if I specify org.kde.Kate.Application here
+                               QDBusConnection::sessionBus());
+        if (!dbus_if.isValid()) {
             std::cerr << qPrintable(QDBusConnection::sessionBus().lastError().message()) << std::endl;
         }
-        QVariant a_s = dbus_if->property("activeSession");
+        QVariant a_s = dbus_if.property("activeSession");
         /*      std::cerr<<a_s.isValid()<<std::endl;
               std::cerr<<"property:"<<qPrintable(a_s.toString())<<std::endl;
               std::cerr<<qPrintable(QDBusConnection::sessionBus().lastError().message())<<std::endl;*/
+        setSessionName(a_s);
+        if (!valid) {
+            return;
+        }
+
+        if (!activity.isEmpty()) {
+            QDBusReply<bool> there = dbus_if.call(QStringLiteral("isOnActivity"), activity);
+            onActivity = there.isValid() && there.value();
+        }
+    }
+
+    /**
+     * Fill in the answer of the instanceInfo() call of the instance.
+     * @param serviceName_ dbus service of the instance
+     * @param info answer of instanceInfo()
+     */
+    KateRunningInstanceInfo(const QString &serviceName_, const QVariantMap &info):
+        QObject(), valid(false),
+        serviceName(serviceName_),
+        onActivity(info.value(QStringLiteral("onActivity"), true).toBool()),
+        desktop(info.value(QStringLiteral("desktop"), 0).toInt()) {
+        setSessionName(info.value(QStringLiteral("session")));
+    }
+
+    /**
+     * Ask the instance for its virtual desktop, only needed for instances filled in by the legacy constructor.
+     */
+    void queryDesktop() {
+        QDBusInterface dbus_if(serviceName, QStringLiteral("/MainApplication"),
+                               QStringLiteral("org.kde.Kate.Application"), QDBusConnection::sessionBus());
+        QDBusReply<int> number = dbus_if.call(QStringLiteral("desktopNumber"));
+        if (number.isValid()) {
+            desktop = number.value();
+        }
+    }
+
+    /**
+     * Bring the instance to front.
+     */
+    void activate() const {
+        QDBusConnection::sessionBus().call(QDBusMessage::createMethodCall(serviceName,
+                                           QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("activate")));
+    }
+
+    bool valid;
+    const QString serviceName;
+    QString sessionName;
+
+    /**
+     * is the instance on the activity asked for?
+     */
+    bool onActivity;
+
+    /**
+     * virtual desktop of the instance, NET::OnAllDesktops for all, 0 if unknown
+     */
+    int desktop;
+
+private:
+    void setSessionName(const QVariant &a_s) {
         if (!a_s.isValid()) {
             sessionName = QStringLiteral("___NO_SESSION_OPENED__%1").arg(dummy_session++);
             valid = false;
@@ -57,21 +127,21 @@ public:
             valid = true;
         }
     }
-    ~KateRunningInstanceInfo() override {
-        delete dbus_if;
-    }
-    bool valid;
-    const QString serviceName;
-    QDBusInterface *dbus_if;
-    QString sessionName;
 
-private:
     static int dummy_session;
 };
 
 typedef QMap<QString, KateRunningInstanceInfo *> KateRunningInstanceMap;
 
-Q_DECL_EXPORT bool fillinRunningKateAppInstances(KateRunningInstanceMap *map);
+/**
+ * Collect all other running kate instances by session name.
+ * All instances are asked in parallel, one call each; instances not answering in time are skipped.
+ * @param map map to fill
+ * @param queryActivity ask the activity manager for the current activity and the instances whether they are on it
+ *        and on which desktop they are, else onActivity is true for all instances and older instances report desktop 0
+ * @return false if two instances have the same session open
+ */
+Q_DECL_EXPORT bool fillinRunningKateAppInstances(KateRunningInstanceMap *map, bool queryActivity = false);
 Q_DECL_EXPORT void cleanupRunningKateAppInstanceMap(KateRunningInstanceMap *map);
 
 #endif
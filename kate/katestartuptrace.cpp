@@ -0,0 +1,233 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katestartuptrace.h"
+#include "katedebug.h"
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+/**
+ * One recorded event.
+ */
+struct KateTraceEvent {
+    const char *name;
+    QString detail;
+    char phase; // 'X' complete span, 'i' instant
+    qint64 begin;
+    qint64 duration;
+    int thread;
+};
+
+/**
+ * Global tracer state, guarded by the mutex, the clock is started once and read-only afterwards.
+ * The enabled flag is atomic to check it without the mutex.
+ */
+struct KateTraceState {
+    QElapsedTimer clock;
+    QMutex mutex;
+    QString fileName;
+    QVector<KateTraceEvent> events;
+    QHash<Qt::HANDLE, int> threads;
+    QAtomicInt enabled;
+};
+
+Q_GLOBAL_STATIC(KateTraceState, traceState)
+
+/**
+ * Small stable id for the current thread, must be called with the mutex locked.
+ */
+static int threadId(KateTraceState *state)
+{
+    const Qt::HANDLE handle = QThread::currentThreadId();
+    const auto it = state->threads.constFind(handle);
+    if (it != state->threads.constEnd()) {
+        return it.value();
+    }
+    const int id = state->threads.size() + 1;
+    state->threads.insert(handle, id);
+    return id;
+}
+
+static void addEvent(const char *name, const QString &detail, char phase, qint64 begin, qint64 duration)
+{
+    KateTraceState *state = traceState();
+    if (!state->enabled.loadAcquire()) {
+        return;
+    }
+
+    QMutexLocker locker(&state->mutex);
+    state->events.append({name, detail, phase, begin, duration, threadId(state)});
+}
+
+/**
+ * Waits for the first paint of the main window.
+ */
+class KateFirstPaintWatcher : public QObject
+{
+public:
+    explicit KateFirstPaintWatcher(QWidget *window)
+        : QObject(window)
+    {
+        window->installEventFilter(this);
+    }
+
+    bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint) {
+            obj->removeEventFilter(this);
+
+            // the paint itself is done once the event loop comes back
+            QTimer::singleShot(0, []() {
+                KateStartupTrace::addInstant("first paint");
+                KateStartupTrace::addSpan("startup", QString(), 0, KateStartupTrace::now());
+                KateStartupTrace::write();
+            });
+            deleteLater();
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+KateStartupTrace::Span::Span(const char *name, const QString &detail)
+    : m_name(name)
+    , m_enabled(isEnabled())
+    , m_detail(m_enabled ? detail : QString())
+    , m_begin(m_enabled ? now() : 0)
+    , m_finished(!m_enabled)
+{
+}
+
+KateStartupTrace::Span::~Span()
+{
+    finish();
+}
+
+void KateStartupTrace::Span::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    addSpan(m_name, m_detail, m_begin, now());
+}
+
+void KateStartupTrace::start()
+{
+    KateTraceState *state = traceState();
+    state->clock.start();
+
+    const QString fileName = QString::fromLocal8Bit(qgetenv("KATE_STARTUP_TRACE"));
+    if (!fileName.isEmpty()) {
+        enable(fileName);
+    }
+}
+
+void KateStartupTrace::enable(const QString &fileName)
+{
+    KateTraceState *state = traceState();
+    QMutexLocker locker(&state->mutex);
+    state->fileName = fileName;
+    state->enabled.storeRelease(!fileName.isEmpty());
+}
+
+bool KateStartupTrace::isEnabled()
+{
+    return traceState()->enabled.loadAcquire();
+}
+
+qint64 KateStartupTrace::now()
+{
+    const QElapsedTimer &clock = traceState()->clock;
+    return clock.isValid() ? (clock.nsecsElapsed() / 1000) : 0;
+}
+
+void KateStartupTrace::addSpan(const char *name, const QString &detail, qint64 begin, qint64 end)
+{
+    addEvent(name, detail, 'X', begin, end - begin);
+}
+
+void KateStartupTrace::addInstant(const char *name)
+{
+    addEvent(name, QString(), 'i', now(), 0);
+}
+
+void KateStartupTrace::watchFirstPaint(QWidget *window)
+{
+    if (window && isEnabled()) {
+        new KateFirstPaintWatcher(window);
+    }
+}
+
+bool KateStartupTrace::write()
+{
+    KateTraceState *state = traceState();
+    QMutexLocker locker(&state->mutex);
+    if (!state->enabled.loadAcquire()) {
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    for (const KateTraceEvent &event : qAsConst(state->events)) {
+        QJsonObject object;
+        object.insert(QStringLiteral("name"), QString::fromLatin1(event.name));
+        object.insert(QStringLiteral("cat"), QStringLiteral("startup"));
+        object.insert(QStringLiteral("ph"), QString(QLatin1Char(event.phase)));
+        object.insert(QStringLiteral("ts"), double(event.begin));
+        if (event.phase == 'X') {
+            object.insert(QStringLiteral("dur"), double(event.duration));
+        } else {
+            // instant events span the whole process
+            object.insert(QStringLiteral("s"), QStringLiteral("p"));
+        }
+        object.insert(QStringLiteral("pid"), double(pid));
+        object.insert(QStringLiteral("tid"), event.thread);
+        if (!event.detail.isEmpty()) {
+            object.insert(QStringLiteral("args"), QJsonObject{{QStringLiteral("detail"), event.detail}});
+        }
+        events.append(object);
+    }
+
+    QJsonObject trace;
+    trace.insert(QStringLiteral("traceEvents"), events);
+    trace.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+
+    QSaveFile file(state->fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0 || !file.commit()) {
+        qCWarning(LOG_KATE) << "can't write startup trace to" << state->fileName;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,129 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_STARTUP_TRACE_H
+#define KATE_STARTUP_TRACE_H
+
+#include "kateprivate_export.h"
+
+#include <QString>
+
+class QWidget;
+
+/**
+ * Records timestamped spans of the startup phases, written as Chrome trace-event JSON,
+ * viewable with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Enabled by the environment variable KATE_STARTUP_TRACE or the command line
+ * option --startup-trace, both give the file to write. Disabled, recording an
+ * event costs one atomic load, no lock is taken and no string copied.
+ *
+ * The trace is written once the first main window painted, and again on exit
+ * to include all later spans.
+ */
+class KATE_TESTS_EXPORT KateStartupTrace
+{
+public:
+    /**
+     * Scoped span, recorded from construction until finish() or destruction.
+     */
+    class Span
+    {
+    public:
+        /**
+         * Start a span.
+         * @param name name of the span, must be a string literal
+         * @param detail additional detail, e.g. the plugin name
+         */
+        explicit Span(const char *name, const QString &detail = QString());
+
+        /**
+         * End the span, if not already done.
+         */
+        ~Span();
+
+        /**
+         * End the span now.
+         */
+        void finish();
+
+    private:
+        Q_DISABLE_COPY(Span)
+
+        const char *const m_name;
+        const bool m_enabled;
+        const QString m_detail;
+        const qint64 m_begin;
+        bool m_finished;
+    };
+
+    /**
+     * Start the clock, all timestamps are relative to this.
+     * Call first thing in main(), enables tracing if KATE_STARTUP_TRACE is set.
+     */
+    static void start();
+
+    /**
+     * Enable tracing.
+     * @param fileName file to write the trace to
+     */
+    static void enable(const QString &fileName);
+
+    /**
+     * Is tracing enabled?
+     * @return true if spans are recorded
+     */
+    static bool isEnabled();
+
+    /**
+     * Time since start().
+     * @return elapsed microseconds
+     */
+    static qint64 now();
+
+    /**
+     * Record a complete span.
+     * @param name name of the span, must be a string literal
+     * @param detail additional detail, may be empty
+     * @param begin begin timestamp, see now()
+     * @param end end timestamp, see now()
+     */
+    static void addSpan(const char *name, const QString &detail, qint64 begin, qint64 end);
+
+    /**
+     * Record a point in time.
+     * @param name name of the event, must be a string literal
+     */
+    static void addInstant(const char *name);
+
+    /**
+     * Record the first paint of the window, that ends the startup and writes the trace.
+     * @param window main window, shown soon
+     */
+    static void watchFirstPaint(QWidget *window);
+
+    /**
+     * Write all recorded events to the trace file.
+     * @return success
+     */
+    static bool write();
+};
+
+#endif
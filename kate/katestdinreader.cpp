@@ -0,0 +1,199 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "katestdinreader.h"
+#include "katedebug.h"
+
+#include <KTextEditor/Document>
+#include <KTextEditor/View>
+
+#include <QSocketNotifier>
+#include <QTextCodec>
+#include <QTextDecoder>
+#include <QTimer>
+
+#include <errno.h>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * bytes read and appended per event loop round
+ */
+static const int BlockSize = 1024 * 1024;
+
+/**
+ * drop the undo history of the document, the streamed input must not be held there a second time
+ * the slot lives in the KTextEditor implementation, not in the interface
+ */
+static void clearUndoHistory(QObject *document)
+{
+    if (QMetaObject::invokeMethod(document, "clearUndo")) {
+        return;
+    }
+
+    for (QObject *child : document->children()) {
+        if (qstrcmp(child->metaObject()->className(), "KateUndoManager") == 0 && QMetaObject::invokeMethod(child, "clearUndo")) {
+            return;
+        }
+    }
+
+    qCWarning(LOG_KATE) << "can't clear the undo history of the input document";
+}
+
+/**
+ * read up to size bytes, as much as is available
+ * @return bytes read, 0 at the end of the input, -1 on errors
+ */
+static qint64 readChunk(int fd, char *data, int size)
+{
+    qint64 res;
+    do {
+#ifdef Q_OS_WIN
+        res = ::_read(fd, data, size);
+#else
+        res = ::read(fd, data, size);
+#endif
+    } while (res < 0 && errno == EINTR);
+    return res;
+}
+
+KateStdinReader::KateStdinReader(KTextEditor::Document *document, QTextCodec *codec, bool follow, int fd)
+    : QObject(document)
+    , m_document(document)
+    , m_decoder((codec ? codec : QTextCodec::codecForLocale())->makeDecoder())
+    , m_follow(follow)
+    , m_fd(fd)
+    , m_notifier(nullptr)
+    , m_pendingCarriageReturn(false)
+{
+#ifndef Q_OS_WIN
+    /**
+     * read if data is there, the ui stays responsive while a slow pipe fills
+     */
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &KateStdinReader::readBlock);
+#else
+    /**
+     * no readiness notification for pipes, read block after block
+     */
+    QTimer::singleShot(0, this, SLOT(readBlock()));
+#endif
+}
+
+KateStdinReader::~KateStdinReader()
+{
+}
+
+void KateStdinReader::readBlock()
+{
+    if (!m_document) {
+        finish();
+        return;
+    }
+
+    QByteArray buffer(BlockSize, Qt::Uninitialized);
+    const qint64 size = readChunk(m_fd, buffer.data(), buffer.size());
+
+    if (size < 0 && errno == EAGAIN) {
+        return;
+    }
+
+    if (size <= 0) {
+        if (size < 0) {
+            qCWarning(LOG_KATE) << "can't read input:" << qt_error_string(errno);
+        }
+        append(QString(), true);
+        finish();
+        return;
+    }
+
+    append(m_decoder->toUnicode(buffer.constData(), int(size)), false);
+
+    if (!m_notifier) {
+        QTimer::singleShot(0, this, SLOT(readBlock()));
+    }
+}
+
+void KateStdinReader::append(QString text, bool last)
+{
+    if (m_pendingCarriageReturn) {
+        text.prepend(QLatin1Char('\r'));
+        m_pendingCarriageReturn = false;
+    }
+
+    if (!last && text.endsWith(QLatin1Char('\r'))) {
+        text.chop(1);
+        m_pendingCarriageReturn = true;
+    }
+
+    text.replace(QStringLiteral("\r\n"), QStringLiteral("\n"));
+    if (text.isEmpty() || !m_document) {
+        return;
+    }
+
+    /**
+     * follow mode: views at the end stay at the end
+     */
+    QList<KTextEditor::View *> following;
+    if (m_follow) {
+        const KTextEditor::Cursor end = m_document->documentEnd();
+        for (KTextEditor::View *view : m_document->views()) {
+            if (view->cursorPosition() == end) {
+                following << view;
+            }
+        }
+    }
+
+    m_document->insertText(m_document->documentEnd(), text);
+    clearUndoHistory(m_document);
+
+    for (KTextEditor::View *view : qAsConst(following)) {
+        view->setCursorPosition(m_document->documentEnd());
+    }
+}
+
+void KateStdinReader::finish()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+    }
+
+    emit finished();
+    deleteLater();
+}
+
+QString KateStdinReader::readAll(QTextCodec *codec, int fd)
+{
+    QScopedPointer<QTextDecoder> decoder((codec ? codec : QTextCodec::codecForLocale())->makeDecoder());
+
+    QString text;
+    QByteArray buffer(BlockSize, Qt::Uninitialized);
+    qint64 size;
+    while ((size = readChunk(fd, buffer.data(), buffer.size())) > 0) {
+        text.append(decoder->toUnicode(buffer.constData(), int(size)));
+    }
+
+    text.replace(QStringLiteral("\r\n"), QStringLiteral("\n"));
+    return text;
+}
@@ -0,0 +1,117 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_STDIN_READER_H
+#define KATE_STDIN_READER_H
+
+#include "kateprivate_export.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QScopedPointer>
+
+class QSocketNotifier;
+class QTextCodec;
+class QTextDecoder;
+
+namespace KTextEditor
+{
+class Document;
+}
+
+/**
+ * Streams piped input into a document.
+ *
+ * The input is read in large blocks from the event loop and decoded
+ * incrementally, each block is appended to the document right away:
+ * the first screen shows up at once and huge input is never held twice,
+ * the undo history is cleared after each block.
+ * Reading stops at the end of the input or if the document is closed.
+ *
+ * In follow mode the views showing the end of the document stay there,
+ * like tail -f, for input that is still growing.
+ */
+class KATE_TESTS_EXPORT KateStdinReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Start reading, the reader deletes itself once done.
+     * @param document document to fill, parent of the reader
+     * @param codec codec of the input, nullptr for the locale codec
+     * @param follow keep views at the end of the document while input arrives
+     * @param fd file descriptor to read, stdin if not given
+     */
+    KateStdinReader(KTextEditor::Document *document, QTextCodec *codec, bool follow, int fd = 0);
+    ~KateStdinReader() override;
+
+    /**
+     * Read the complete input at once, blockwise.
+     * Used if the input goes to another process.
+     * @param codec codec of the input, nullptr for the locale codec
+     * @param fd file descriptor to read, stdin if not given
+     * @return decoded input
+     */
+    static QString readAll(QTextCodec *codec, int fd = 0);
+
+Q_SIGNALS:
+    /**
+     * All input was read, emitted right before the reader deletes itself.
+     */
+    void finished();
+
+private Q_SLOTS:
+    /**
+     * read and append the next block
+     */
+    void readBlock();
+
+private:
+    /**
+     * Append decoded text, carriage returns of CR LF pairs are dropped.
+     * @param text text to append
+     * @param last no more text follows
+     */
+    void append(QString text, bool last);
+
+    /**
+     * done, stop reading and delete this
+     */
+    void finish();
+
+private:
+    QPointer<KTextEditor::Document> m_document;
+    QScopedPointer<QTextDecoder> m_decoder;
+    const bool m_follow;
+    const int m_fd;
+
+    /**
+     * readiness of the input, nullptr if the input can't be watched
+     */
+    QSocketNotifier *m_notifier;
+
+    /**
+     * trailing carriage return of the last block, its line feed might follow
+     */
+    bool m_pendingCarriageReturn;
+};
+
+#endif
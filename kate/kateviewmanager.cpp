@@ -56,6 +56,7 @@ KateViewManager::KateViewManager(QWidget *parentW, KateMainWindow *parent)
     : QSplitter(parentW)
     , m_mainWindow(parent)
     , m_blockViewCreationAndActivation(false)
+    , m_creatingDocuments(false)
     , m_activeViewRunning(false)
     , m_minAge(0)
     , m_guiMergedView(nullptr)
@@ -92,6 +93,15 @@ KateViewManager::KateViewManager(QWidget *parentW, KateMainWindow *parent)
     connect(KateApp::self()->documentManager(), &KateDocManager::documentsDeleted
         , this, &KateViewManager::documentsDeleted);
 
+    /**
+     * handle document creation transactions
+     * register the new documents at once afterwards
+     */
+    connect(KateApp::self()->documentManager(), &KateDocManager::aboutToCreateDocuments
+        , this, &KateViewManager::aboutToCreateDocuments);
+    connect(KateApp::self()->documentManager(), &KateDocManager::documentsCreated
+        , this, &KateViewManager::documentsCreated);
+
     // register all already existing documents
     m_blockViewCreationAndActivation = true;
 
@@ -348,12 +358,18 @@ KateMainWindow *KateViewManager::mainWindow()
 
 void KateViewManager::documentCreated(KTextEditor::Document *doc)
 {
-    // forward to currently active view space
-    activeViewSpace()->registerDocument(doc);
-
     // to update open recent files on saving
     connect(doc, &KTextEditor::Document::documentSavedOrUploaded, this, &KateViewManager::documentSavedOrUploaded);
 
+    // part of a batch: register all of them at once in documentsCreated()
+    if (m_creatingDocuments) {
+        m_createdDocuments.append(doc);
+        return;
+    }
+
+    // forward to currently active view space
+    activeViewSpace()->registerDocument(doc);
+
     if (m_blockViewCreationAndActivation) {
         return;
     }
@@ -423,6 +439,50 @@ void KateViewManager::documentsDeleted(const QList<KTextEditor::Document *> &)
     mainWindow()->setUpdatesEnabled(true);
 }
 
+void KateViewManager::aboutToCreateDocuments()
+{
+    /**
+     * collect the new documents until the transaction is done
+     * this shall not stack!
+     */
+    Q_ASSERT(!m_creatingDocuments);
+    m_creatingDocuments = true;
+}
+
+void KateViewManager::documentsCreated(const QList<KTextEditor::Document *> &)
+{
+    m_creatingDocuments = false;
+
+    const QVector<KTextEditor::Document *> docs = m_createdDocuments;
+    m_createdDocuments.clear();
+    if (docs.isEmpty()) {
+        return;
+    }
+
+    /**
+     * forward to currently active view space, one update of the tab bar for all of them
+     * the documents stay without views until they are activated
+     */
+    activeViewSpace()->registerDocuments(docs);
+
+    if (m_blockViewCreationAndActivation) {
+        return;
+    }
+
+    if (!activeView()) {
+        activateView(docs.first());
+    }
+
+    /**
+     * check if we have any empty viewspaces and give them a view
+     */
+    Q_FOREACH(KateViewSpace * vs, m_viewSpaceList) {
+        if (!vs->currentView()) {
+            createView(activeView()->document(), vs);
+        }
+    }
+}
+
 void KateViewManager::documentSavedOrUploaded(KTextEditor::Document *doc, bool)
 {
     if (!doc->url().isEmpty()) {
@@ -718,6 +778,9 @@ void KateViewManager::documentWillBeDeleted(KTextEditor::Document *doc)
     while (!closeList.isEmpty()) {
         deleteView(closeList.takeFirst());
     }
+
+    // not registered yet if closed within its creation batch
+    m_createdDocuments.removeAll(doc);
 }
 
 void KateViewManager::closeView(KTextEditor::View *view)
@@ -27,6 +27,7 @@
 #include <QList>
 #include <QSplitter>
 #include <QMap>
+#include <QVector>
 
 #include <config.h>
 
@@ -167,6 +168,21 @@ private Q_SLOTS:
      */
     void documentsDeleted(const QList<KTextEditor::Document *> &documents);
 
+    /**
+     * This signal is emitted before the batch of documents is being created
+     *
+     * the new documents are collected and registered at once in documentsCreated()
+     */
+    void aboutToCreateDocuments();
+
+    /**
+     * This signal is emitted after the batch of documents is created
+     *
+     * This is the batch closing signal for aboutToCreateDocuments
+     * @param documents the documents that have been created
+     */
+    void documentsCreated(const QList<KTextEditor::Document *> &documents);
+
 public Q_SLOTS:
     /**
      * Splits a KateViewSpace into two in the following steps:
@@ -290,6 +306,12 @@ private:
 
     bool m_blockViewCreationAndActivation;
 
+    /**
+     * documents created in the running batch, see aboutToCreateDocuments()
+     */
+    bool m_creatingDocuments;
+    QVector<KTextEditor::Document *> m_createdDocuments;
+
     bool m_activeViewRunning;
 
     int m_splitterIndex; // used during saving splitter config.
@@ -39,6 +39,7 @@
 #include <QHelpEvent>
 #include <QMenu>
 #include <QMessageBox>
+#include <QSet>
 #include <QStackedWidget>
 #include <QToolButton>
 #include <QToolTip>
@@ -204,6 +205,11 @@ KTextEditor::View *KateViewSpace::createView(KTextEditor::Document *doc)
     // should only be called if a view does not yet exist
     Q_ASSERT(! m_docToView.contains(doc));
 
+    /**
+     * lazy restored documents are loaded once they are shown
+     */
+    KateApp::self()->documentManager()->loadDocument(doc);
+
     /**
      * Create a fresh view
      */
@@ -347,8 +353,8 @@ void KateViewSpace::insertTab(int index, KTextEditor::Document * doc)
     // doc should not have a id
     Q_ASSERT(! m_docToTabId.contains(doc));
 
-    const int id = m_tabBar->insertTab(index, doc->documentName());
-    m_tabBar->setTabToolTip(id, doc->url().toDisplayString());
+    const int id = m_tabBar->insertTab(index, KateApp::self()->documentManager()->documentName(doc));
+    m_tabBar->setTabToolTip(id, KateApp::self()->documentManager()->documentUrl(doc).toDisplayString());
     m_docToTabId[doc] = id;
     updateDocumentState(doc);
 
@@ -457,6 +463,51 @@ void KateViewSpace::registerDocument(KTextEditor::Document *doc, bool append)
     }
 }
 
+void KateViewSpace::registerDocuments(const QVector<KTextEditor::Document *> &docs)
+{
+    QSet<KTextEditor::Document *> known;
+    known.reserve(m_lruDocList.size() + docs.size());
+    Q_FOREACH(KTextEditor::Document *doc, m_lruDocList) {
+        known.insert(doc);
+    }
+
+    const int oldSize = m_lruDocList.size();
+    Q_FOREACH(KTextEditor::Document *doc, docs) {
+        if (known.contains(doc)) {
+            continue;
+        }
+        known.insert(doc);
+
+        Q_ASSERT(! m_docToView.contains(doc));
+        Q_ASSERT(! m_docToTabId.contains(doc));
+
+        m_lruDocList.append(doc);
+        connect(doc, &QObject::destroyed, this, &KateViewSpace::documentDestroyed);
+    }
+
+    if (m_lruDocList.size() == oldSize) {
+        return;
+    }
+
+    // same result as registerDocument() one by one: the newest documents are
+    // shown, remove the buttons of the old ones that don't fit anymore
+    const int firstShown = qMax(0, m_lruDocList.size() - m_tabBar->maxTabCount());
+    for (int i = qMax(0, oldSize - m_tabBar->maxTabCount()); i < qMin(oldSize, firstShown); ++i) {
+        if (m_docToTabId.contains(m_lruDocList[i])) {
+            removeTab(m_lruDocList[i], false);
+        }
+    }
+
+    // add the new ones that fit, the newest first
+    for (int i = qMax(oldSize, firstShown); i < m_lruDocList.size(); ++i) {
+        if (m_tabBar->count() < m_tabBar->maxTabCount()) {
+            insertTab(0, m_lruDocList[i]);
+        }
+    }
+
+    updateQuickOpen();
+}
+
 void KateViewSpace::documentDestroyed(QObject *doc)
 {
     // WARNING: this pointer is half destroyed
@@ -493,15 +544,15 @@ void KateViewSpace::updateDocumentName(KTextEditor::Document *doc)
 {
     const int buttonId = m_docToTabId[doc];
     Q_ASSERT(buttonId >= 0);
-    m_tabBar->setTabText(buttonId, doc->documentName());
-    m_tabBar->setTabToolTip(buttonId, doc->url().toDisplayString());
+    m_tabBar->setTabText(buttonId, KateApp::self()->documentManager()->documentName(doc));
+    m_tabBar->setTabToolTip(buttonId, KateApp::self()->documentManager()->documentUrl(doc).toDisplayString());
 }
 
 void KateViewSpace::updateDocumentUrl(KTextEditor::Document *doc)
 {
     const int buttonId = m_docToTabId[doc];
     Q_ASSERT(buttonId >= 0);
-    m_tabBar->setTabUrl(buttonId, doc->url());
+    m_tabBar->setTabUrl(buttonId, KateApp::self()->documentManager()->documentUrl(doc));
 }
 
 void KateViewSpace::updateDocumentState(KTextEditor::Document *doc)
@@ -608,7 +659,9 @@ void KateViewSpace::showContextMenu(int id, const QPoint & globalPos)
         aCloseOthers->setEnabled(false);
     }
 
-    if (doc->url().isEmpty()) {
+    // placeholders of lazily loaded documents have no url yet, ask the document manager
+    KateDocManager *docManager = KateApp::self()->documentManager();
+    if (docManager->documentUrl(doc).isEmpty()) {
         aCopyPath->setEnabled(false);
         aOpenFolder->setEnabled(false);
         aRenameFile->setEnabled(false);
@@ -619,7 +672,7 @@ void KateViewSpace::showContextMenu(int id, const QPoint & globalPos)
 
     auto activeDocument = KTextEditor::Editor::instance()->application()->activeMainWindow()->activeView()->document(); // used for mCompareWithActive which is used with another tab which is not active
     // both documents must have urls and must not be the same to have the compare feature enabled
-    if (activeDocument->url().isEmpty() || activeDocument == doc) {
+    if (docManager->documentUrl(activeDocument).isEmpty() || activeDocument == doc) {
         mCompareWithActive->setEnabled(false);
     }
 
@@ -669,7 +722,7 @@ void KateViewSpace::saveConfig(KConfigBase *config, int myIndex , const QString
     QVector<KTextEditor::View*> views;
     QStringList lruList;
     Q_FOREACH(KTextEditor::Document* doc, m_lruDocList) {
-        lruList << doc->url().toString();
+        lruList << KateApp::self()->documentManager()->documentUrl(doc).toString();
         if (m_docToView.contains(doc)) {
             views.append(m_docToView[doc]);
         }
@@ -704,18 +757,20 @@ void KateViewSpace::restoreConfig(KateViewManager *viewMan, const KConfigBase *c
     KConfigGroup group(config, groupname);
 
     // restore Document lru list so that all tabs from the last session reappear
+    // the documents get no views here, they are created once a tab is activated
     const QStringList lruList = group.readEntry("Documents", QStringList());
+    QVector<KTextEditor::Document *> lruDocs;
+    lruDocs.reserve(lruList.size());
     for (int i = 0; i < lruList.size(); ++i) {
-        // ignore non-existing documents and documents we already added to the LRU list
-        // no wild m_lruDocList modifications to keep list + tabs in sync even for restore
+        // ignore non-existing documents, registerDocuments() skips the ones we already added
         auto doc = KateApp::self()->documentManager()->findDocument(QUrl(lruList[i]));
-        if (doc && !m_lruDocList.contains(doc)) {
-            registerDocument(doc);
-            Q_ASSERT(m_lruDocList.contains(doc));
+        if (doc) {
+            lruDocs.append(doc);
         }
     }
+    registerDocuments(lruDocs);
 
-    // restore active view properties
+    // restore active view properties, the only view created eagerly
     const QString fn = group.readEntry("Active View");
     if (!fn.isEmpty()) {
         KTextEditor::Document *doc = KateApp::self()->documentManager()->findDocument(QUrl(fn));
@@ -89,6 +89,13 @@ public:
      */
     void registerDocument(KTextEditor::Document *doc, bool append = true);
 
+    /**
+     * Like registerDocument() for many documents, the @p docs are appended in
+     * the given order, already known ones are skipped. The tab bar is updated
+     * once, only documents that get a tab are touched.
+     */
+    void registerDocuments(const QVector<KTextEditor::Document *> &docs);
+
     /**
      * Event filter to catch events from view space tool buttons.
      */
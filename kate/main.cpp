@@ -21,6 +21,9 @@
 
 #include "kateapp.h"
 #include "katerunninginstanceinfo.h"
+#include "katehandoff.h"
+#include "katestartuptrace.h"
+#include "katestdinreader.h"
 #include "katewaiter.h"
 
 #include <KAboutData>
@@ -42,6 +45,10 @@
 #include <QDBusReply>
 #include <QApplication>
 #include <QDir>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QSessionManager>
 
 #include "../urlinfo.h"
@@ -55,9 +62,72 @@
 #endif
 #include <iostream>
 
+#ifndef USE_QT_SINGLE_APP
+/**
+ * a running instance not answering the handoff in this time is assumed to hang
+ */
+static const int HandoffTimeout = 5000;
+
+/**
+ * hand over to an instance without handleMessage(), e.g. of an older version, one call per item
+ * @param serviceName dbus service of the instance
+ * @param message message as for handleMessage()
+ * @return tokens of the opened documents
+ */
+static QStringList legacyHandoff(const QString &serviceName, const QJsonObject &message)
+{
+    auto call = [&serviceName](const QString &method, const QList<QVariant> &args) {
+        QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
+                        QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), method);
+        m.setArguments(args);
+        return QDBusConnection::sessionBus().call(m);
+    };
+
+    const QString session = message.value(QLatin1String("session")).toString();
+    if (!session.isEmpty()) {
+        call(QStringLiteral("activateSession"), {session});
+    }
+
+    const QString enc = message.value(QLatin1String("encoding")).toString();
+    const bool tempfileSet = message.value(QLatin1String("tempfile")).toBool();
+
+    QStringList tokens;
+    const QJsonArray urls = message.value(QLatin1String("urls")).toArray();
+    for (const QJsonValue &urlObject : urls) {
+        const QJsonObject url = urlObject.toObject();
+        const QDBusMessage res = call(QStringLiteral("tokenOpenUrlAt"), {url.value(QLatin1String("url")).toString(),
+                                      url.value(QLatin1String("line")).toInt(), url.value(QLatin1String("column")).toInt(), enc, tempfileSet});
+        if (res.type() == QDBusMessage::ReplyMessage && res.arguments().count() == 1) {
+            const QString s = res.arguments().at(0).toString();
+            if ((!s.isEmpty()) && (s != QStringLiteral("ERROR"))) {
+                tokens << s;
+            }
+        }
+    }
+
+    if (message.contains(QLatin1String("stdin"))) {
+        call(QStringLiteral("openInput"), {message.value(QLatin1String("stdin")).toString(), enc});
+    }
+
+    if (message.contains(QLatin1String("line"))) {
+        call(QStringLiteral("setCursor"), {message.value(QLatin1String("line")).toInt(), message.value(QLatin1String("column")).toInt()});
+    }
+
+    // activate the used instance
+    call(QStringLiteral("activate"), {});
+    return tokens;
+}
+#endif
+
 
 int main(int argc, char **argv)
 {
+    /**
+     * start the clock for the startup trace first, if wanted, see KATE_STARTUP_TRACE
+     */
+    KateStartupTrace::start();
+    KateStartupTrace::Span mainSpan("main");
+
 #ifndef Q_OS_WIN
     // Prohibit using sudo or kdesu (but allow using the root user directly)
     if (getuid() == 0) {
@@ -78,11 +148,13 @@ int main(int argc, char **argv)
     /**
      * Create application first
      */
+    KateStartupTrace::Span applicationSpan("QApplication");
 #ifdef USE_QT_SINGLE_APP
     SharedTools::QtSingleApplication app(QStringLiteral("kate"),argc, argv);
 #else
     QApplication app(argc, argv);
 #endif
+    applicationSpan.finish();
 
     /**
      * Enforce application name even if the executable is renamed
@@ -218,10 +290,18 @@ int main(int argc, char **argv)
     const QCommandLineOption readStdInOption(QStringList() << QStringLiteral("i") << QStringLiteral("stdin"), i18n("Read the contents of stdin."));
     parser.addOption(readStdInOption);
 
+    // --follow option
+    const QCommandLineOption followOption(QStringList() << QStringLiteral("follow"), i18n("Keep the view at the end while input read with --stdin still arrives."));
+    parser.addOption(followOption);
+
     // --tempfile option
     const QCommandLineOption tempfileOption(QStringList() << QStringLiteral("tempfile"), i18n("The files/URLs opened by the application will be deleted after use"));
     parser.addOption(tempfileOption);
 
+    // --startup-trace option
+    const QCommandLineOption startupTraceOption(QStringList() << QStringLiteral("startup-trace"), i18n("Write a trace of the startup phases in Chrome trace-event format to this file."), i18n("file"));
+    parser.addOption(startupTraceOption);
+
     // urls to open
     parser.addPositionalArgument(QStringLiteral("urls"), i18n("Documents to open."), i18n("[urls...]"));
 
@@ -235,6 +315,13 @@ int main(int argc, char **argv)
      */
     aboutData.processCommandLine(&parser);
 
+    /**
+     * enable the startup trace, the spans until here are recorded, too
+     */
+    if (parser.isSet(startupTraceOption)) {
+        KateStartupTrace::enable(parser.value(startupTraceOption));
+    }
+
     /**
      * remember the urls we shall open
      */
@@ -247,6 +334,13 @@ int main(int argc, char **argv)
      * things about already running kate's, like their sessions
      */
     bool force_new = parser.isSet(startNewInstanceOption);
+
+    /**
+     * followed input might never end, it can't be handed over in one piece
+     */
+    if (parser.isSet(readStdInOption) && parser.isSet(followOption)) {
+        force_new = true;
+    }
     if (!force_new) {
         if (!(
                     parser.isSet(startSessionOption) ||
@@ -266,57 +360,92 @@ int main(int argc, char **argv)
      */
     const bool needToBlock = parser.isSet(startBlockingOption) && !urls.isEmpty();
 
+    /**
+     * stdin can be read just once: if it was read for a handoff that failed,
+     * this instance opens the text itself
+     */
+    bool stdinRead = false;
+    QString stdinText;
+
+#ifndef USE_QT_SINGLE_APP
+    /**
+     * everything to hand over to a running instance in one message, see KateApp::handleRemoteMessage()
+     * only built once we hand over
+     */
+    auto handoffMessage = [&]() {
+        QJsonObject message;
+
+        // open given session
+        if (parser.isSet(startSessionOption)) {
+            message.insert(QStringLiteral("session"), parser.value(startSessionOption));
+        }
+
+        if (parser.isSet(useEncodingOption)) {
+            message.insert(QStringLiteral("encoding"), parser.value(useEncodingOption));
+        }
+
+        message.insert(QStringLiteral("tempfile"), parser.isSet(tempfileOption));
+        message.insert(QStringLiteral("tokens"), needToBlock);
+
+        // open given files...
+        // Bug 397913: Reverse the order here so the new tabs are opened in same order as the files were passed in on the command line
+        QJsonArray messageUrls;
+        for (int i = urls.size() - 1; i >= 0; --i) {
+            UrlInfo info(urls[i]);
+            QJsonObject urlMessagePart;
+            urlMessagePart.insert(QStringLiteral("url"), info.url.toString());
+            urlMessagePart.insert(QStringLiteral("line"), info.cursor.line());
+            urlMessagePart.insert(QStringLiteral("column"), info.cursor.column());
+            messageUrls.append(urlMessagePart);
+        }
+        message.insert(QStringLiteral("urls"), messageUrls);
+
+        if (parser.isSet(readStdInOption)) {
+            // set chosen codec
+            QTextCodec *codec = parser.isSet(useEncodingOption) ?
+                                QTextCodec::codecForName(parser.value(useEncodingOption).toUtf8()) : nullptr;
+
+            // the other instance gets the input in one piece
+            if (!stdinRead) {
+                stdinText = KateStdinReader::readAll(codec);
+                stdinRead = true;
+            }
+            message.insert(QStringLiteral("stdin"), stdinText);
+        }
+
+        if (parser.isSet(gotoLineOption) || parser.isSet(gotoColumnOption)) {
+            message.insert(QStringLiteral("line"), parser.isSet(gotoLineOption) ? (parser.value(gotoLineOption).toInt() - 1) : 0);
+            message.insert(QStringLiteral("column"), parser.isSet(gotoColumnOption) ? (parser.value(gotoColumnOption).toInt() - 1) : 0);
+        }
+
+        return message;
+    };
+
     /**
      * use dbus, if available for linux and co.
      * allows for reuse of running Kate instances
      */
-#ifndef USE_QT_SINGLE_APP
-    if (QDBusConnectionInterface * const sessionBusInterface = QDBusConnection::sessionBus().interface()) {
+    QString handoffFallback;
+    if (QDBusConnection::sessionBus().interface()) {
+        KateStartupTrace::Span discoverySpan("instance discovery");
+
         /**
          * try to get the current running kate instances
+         * all instances are asked at once, together with their activity and desktop
          */
         KateRunningInstanceMap mapSessionRii;
-        if (!fillinRunningKateAppInstances(&mapSessionRii)) {
+        if (!fillinRunningKateAppInstances(&mapSessionRii, true)) {
             return 1;
         }
 
-        QString currentActivity;
-        QDBusMessage m = QDBusMessage::createMethodCall(
-                                        QStringLiteral("org.kde.ActivityManager"),
-                                        QStringLiteral("/ActivityManager/Activities"), QStringLiteral("org.kde.ActivityManager.Activities"), QStringLiteral("CurrentActivity"));
-        QDBusMessage res = QDBusConnection::sessionBus().call(m);
-        QList<QVariant> answer = res.arguments();
-        if (answer.size() == 1) {
-            currentActivity = answer.at(0).toString();
-        }
-
+        // If the Kate instance is in a specific activity, add it to
+        // the list of candidate reusable services
         QStringList kateServices;
+        QHash<QString, int> serviceDesktops;
         for (KateRunningInstanceMap::const_iterator it = mapSessionRii.constBegin(); it != mapSessionRii.constEnd(); ++it) {
-            QString serviceName = (*it)->serviceName;
-
-            if (currentActivity.length() != 0) {
-                QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
-                                        QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("isOnActivity"));
-
-                QList<QVariant> dbargs;
-
-                // convert to an url
-                dbargs.append(currentActivity);
-                m.setArguments(dbargs);
-
-                QDBusMessage res = QDBusConnection::sessionBus().call(m);
-                QList<QVariant> answer = res.arguments();
-                if (answer.size() == 1) {
-                    const bool canBeUsed = answer.at(0).toBool();
-
-                    // If the Kate instance is in a specific activity, add it to
-                    // the list of candidate reusable services
-                    if (canBeUsed) {
-                        kateServices << serviceName;
-                    }
-                }
-            } else {
-                kateServices << serviceName;
+            if ((*it)->onActivity) {
+                kateServices << (*it)->serviceName;
+                serviceDesktops.insert((*it)->serviceName, (*it)->desktop);
             }
         }
 
@@ -357,185 +486,113 @@ int main(int argc, char **argv)
         }
 
         // prefer the Kate instance running on the current virtual desktop
-        bool foundRunningService = false;
         if ((!force_new) && (serviceName.isEmpty())) {
             const int desktopnumber = KWindowSystem::currentDesktop();
-            for (int s = 0; s < kateServices.count(); s++) {
-
-                serviceName = kateServices[s];
-
-                if (!serviceName.isEmpty()) {
-                    QDBusReply<bool> there = sessionBusInterface->isServiceRegistered(serviceName);
-
-                    if (there.isValid() && there.value()) {
-                        // query instance current desktop
-                        QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
-                                         QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("desktopNumber"));
-
-                        QDBusMessage res = QDBusConnection::sessionBus().call(m);
-                        QList<QVariant> answer = res.arguments();
-                        if (answer.size() == 1) {
-                            // special case: on all desktops! that is -1 aka NET::OnAllDesktops, see KWindowInfo::desktop() docs
-                            const int sessionDesktopNumber = answer.at(0).toInt();
-                            if (sessionDesktopNumber == desktopnumber || sessionDesktopNumber == NET::OnAllDesktops) {
-                                // stop searching. a candidate instance in the current desktop has been found
-                                foundRunningService = true;
-                                break;
-                            }
-                        }
-                    }
+            for (const QString &s : qAsConst(kateServices)) {
+                // special case: on all desktops! that is -1 aka NET::OnAllDesktops, see KWindowInfo::desktop() docs
+                const int sessionDesktopNumber = serviceDesktops.value(s);
+                if (sessionDesktopNumber == desktopnumber || sessionDesktopNumber == NET::OnAllDesktops) {
+                    // stop searching. a candidate instance in the current desktop has been found
+                    serviceName = s;
+                    break;
                 }
-                serviceName.clear();
             }
         }
+        discoverySpan.finish();
 
-        //check again if service is still running
-        foundRunningService = false;
         if (!serviceName.isEmpty()) {
-            QDBusReply<bool> there = sessionBusInterface->isServiceRegistered(serviceName);
-            foundRunningService = there.isValid() && there.value();
-        }
+            KateStartupTrace::Span handoffSpan("handoff");
 
-        if (foundRunningService) {
-            // open given session
-            if (parser.isSet(startSessionOption) && (!session_already_opened)) {
-                QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
-                                QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("activateSession"));
-
-                QList<QVariant> dbusargs;
-                dbusargs.append(parser.value(startSessionOption));
-                m.setArguments(dbusargs);
-
-                QDBusConnection::sessionBus().call(m);
+            // the session is already open there, nothing to switch
+            QJsonObject message = handoffMessage();
+            if (session_already_opened) {
+                message.remove(QStringLiteral("session"));
             }
 
-            QString enc = parser.isSet(useEncodingOption) ? parser.value(useEncodingOption) : QString();
+            /**
+             * one call for everything, the instance only queues the work and answers at once
+             * a blocking kate needs the tokens and waits for the documents to be opened
+             */
+            QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
+                            QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("handleMessage"));
+            m << QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact));
 
-            bool tempfileSet = parser.isSet(tempfileOption);
+            QDBusMessage res = QDBusConnection::sessionBus().call(m, QDBus::Block, needToBlock ? -1 : HandoffTimeout);
 
+            bool foundRunningService = false;
+            bool handoffTimedOut = false;
             QStringList tokens;
-
-            // open given files...
-            // Bug 397913: Reverse the order here so the new tabs are opened in same order as the files were passed in on the command line
-            for (int i = urls.size() - 1; i >= 0; --i) {
-                const QString &url = urls[i];
-                QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
-                                QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("tokenOpenUrlAt"));
-
-                UrlInfo info(url);
-                QList<QVariant> dbusargs;
-
-                // convert to an url
-                dbusargs.append(info.url.toString());
-                dbusargs.append(info.cursor.line());
-                dbusargs.append(info.cursor.column());
-                dbusargs.append(enc);
-                dbusargs.append(tempfileSet);
-                m.setArguments(dbusargs);
-
-                QDBusMessage res = QDBusConnection::sessionBus().call(m);
-                if (res.type() == QDBusMessage::ReplyMessage) {
-                    if (res.arguments().count() == 1) {
-                        QVariant v = res.arguments()[0];
-                        if (v.isValid()) {
-                            QString s = v.toString();
-                            if ((!s.isEmpty()) && (s != QStringLiteral("ERROR"))) {
-                                tokens << s;
-                            }
-                        }
-                    }
+            if (res.type() == QDBusMessage::ReplyMessage) {
+                foundRunningService = true;
+                if (res.arguments().count() == 1) {
+                    tokens = res.arguments().at(0).toStringList();
                 }
+            } else if (res.errorName() == QStringLiteral("org.freedesktop.DBus.Error.UnknownMethod")) {
+                foundRunningService = true;
+                tokens = legacyHandoff(serviceName, message);
+            } else if (res.errorName() == QStringLiteral("org.freedesktop.DBus.Error.NoReply")) {
+                // the instance is busy but got the message, it will handle it later
+                // starting our own instance would open the files twice
+                foundRunningService = true;
+                handoffTimedOut = true;
+            } else if (!needToBlock && (res.errorName() == QStringLiteral("org.freedesktop.DBus.Error.ServiceUnknown")
+                                        || res.errorName() == QStringLiteral("org.freedesktop.DBus.Error.NameHasNoOwner"))) {
+                // instance gone meanwhile, try the local socket below
+                // not after a timeout: the instance might still handle the call, the files would open twice
+                handoffFallback = QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact));
             }
-
-            if (parser.isSet(readStdInOption)) {
-                QTextStream input(stdin, QIODevice::ReadOnly);
-
-                // set chosen codec
-                QTextCodec *codec = parser.isSet(useEncodingOption) ?
-                                    QTextCodec::codecForName(parser.value(useEncodingOption).toUtf8()) : nullptr;
-
-                if (codec) {
-                    input.setCodec(codec);
+            handoffSpan.finish();
+
+            if (foundRunningService) {
+                // connect dbus signal
+                if (needToBlock) {
+                    KateWaiter *waiter = new KateWaiter(serviceName, tokens);
+                    QDBusConnection::sessionBus().connect(serviceName, QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("exiting"), waiter, SLOT(exiting()));
+                    // without the tokens we can only wait for the instance to exit
+                    if (!handoffTimedOut) {
+                        QDBusConnection::sessionBus().connect(serviceName, QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("documentClosed"), waiter, SLOT(documentClosed(QString)));
+                    }
                 }
 
-                QString line;
-                QString text;
-
-                do {
-                    line = input.readLine();
-                    text.append(line + QLatin1Char('\n'));
-                } while (!line.isNull());
-
-                QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
-                                QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("openInput"));
-
-                QList<QVariant> dbusargs;
-                dbusargs.append(text);
-                dbusargs.append(codec ? QString::fromLatin1(codec->name()) : QString());
-                m.setArguments(dbusargs);
-
-                QDBusConnection::sessionBus().call(m);
-            }
-
-            int line = 0;
-            int column = 0;
-            bool nav = false;
-
-            if (parser.isSet(gotoLineOption)) {
-                line = parser.value(gotoLineOption).toInt() - 1;
-                nav = true;
-            }
-
-            if (parser.isSet(gotoColumnOption)) {
-                column = parser.value(gotoColumnOption).toInt() - 1;
-                nav = true;
-            }
-
-            if (nav) {
-                QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
-                                QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("setCursor"));
-
-                QList<QVariant> args;
-                args.append(line);
-                args.append(column);
-                m.setArguments(args);
-
-                QDBusConnection::sessionBus().call(m);
-            }
-
-            // activate the used instance
-            QDBusMessage activateMsg = QDBusMessage::createMethodCall(serviceName,
-                                    QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("activate"));
-            QDBusConnection::sessionBus().call(activateMsg);
+                // KToolInvocation (and KRun) will wait until we register on dbus
+                KDBusService dbusService(KDBusService::Multiple);
+                dbusService.unregister();
+
+                // make the world happy, we are started, kind of...
+                KStartupInfo::appStarted();
+
+                // We don't want the session manager to restart us on next login
+                // if we block
+                if (needToBlock) {
+                    QObject::connect(qApp, &QGuiApplication::saveStateRequest, qApp,
+                                     [](QSessionManager &session) {
+                                         session.setRestartHint(QSessionManager::RestartNever);
+                                     },
+                                     Qt::DirectConnection
+                             );
+                }
 
-            // connect dbus signal
-            if (needToBlock) {
-                KateWaiter *waiter = new KateWaiter(serviceName, tokens);
-                QDBusConnection::sessionBus().connect(serviceName, QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("exiting"), waiter, SLOT(exiting()));
-                QDBusConnection::sessionBus().connect(serviceName, QStringLiteral("/MainApplication"), QStringLiteral("org.kde.Kate.Application"), QStringLiteral("documentClosed"), waiter, SLOT(documentClosed(QString)));
-            }
+                // the handoff to the running instance is done
+                mainSpan.finish();
+                KateStartupTrace::write();
 
-            // KToolInvocation (and KRun) will wait until we register on dbus
-            KDBusService dbusService(KDBusService::Multiple);
-            dbusService.unregister();
-
-            // make the world happy, we are started, kind of...
-            KStartupInfo::appStarted();
-
-            // We don't want the session manager to restart us on next login
-            // if we block
-            if (needToBlock) {
-                QObject::connect(qApp, &QGuiApplication::saveStateRequest, qApp,
-                                 [](QSessionManager &session) {
-                                     session.setRestartHint(QSessionManager::RestartNever);
-                                 },
-                                 Qt::DirectConnection
-                         );
+                // this will wait until exiting is emitted by the used instance, if wanted...
+                return needToBlock ? app.exec() : 0;
             }
-
-            // this will wait until exiting is emitted by the used instance, if wanted...
-            return needToBlock ? app.exec() : 0;
         }
+    } else if (!force_new && !needToBlock && !parser.isSet(startAnonymousSessionOption)) {
+        // no dbus around, try the local socket, blocking needs the dbus signals
+        handoffFallback = QString::fromUtf8(QJsonDocument(handoffMessage()).toJson(QJsonDocument::Compact));
+    }
+
+    /**
+     * local socket handoff, to the first instance of this user on this display
+     */
+    if (!handoffFallback.isEmpty() && KateHandoffServer::sendMessage(handoffFallback, HandoffTimeout)) {
+        KStartupInfo::appStarted();
+        mainSpan.finish();
+        KateStartupTrace::write();
+        return 0;
     }
 
     /**
@@ -609,15 +666,20 @@ int main(int argc, char **argv)
      * we are passing our local command line parser to it
      */
     KateApp kateApp(parser);
+    if (stdinRead) {
+        kateApp.setStdinText(stdinText);
+    }
 
     /**
      * init kate
      * if this returns false, we shall exit
      * else we may enter the main event loop
      */
+    KateStartupTrace::Span initSpan("KateApp::init");
     if (!kateApp.init()) {
         return 0;
     }
+    initSpan.finish();
 
 #ifndef USE_QT_SINGLE_APP
     /**
@@ -635,6 +697,8 @@ int main(int argc, char **argv)
 
     /**
      * start main event loop for our application
+     * the startup trace ends with the first paint of the main window
      */
+    mainSpan.finish();
     return app.exec();
 }
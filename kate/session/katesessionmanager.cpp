@@ -27,6 +27,7 @@
 #include "kateapp.h"
 #include "katepluginmanager.h"
 #include "katerunninginstanceinfo.h"
+#include "katestartuptrace.h"
 
 #include <KConfigGroup>
 #include <KSharedConfig>
@@ -40,19 +41,33 @@
 
 #include <QApplication>
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QInputDialog>
+#include <QPair>
 #include <QScopedPointer>
+#include <QSet>
 #include <QUrl>
+#include <QVector>
 
-#ifndef Q_OS_WIN
-#include <unistd.h>
-#endif
+#include <algorithm>
 
 //BEGIN KateSessionManager
 
+/**
+ * maximal number of sessions in the jump list
+ */
+static const int MaxJumpListSessions = 10;
+
+/**
+ * delay to collect the change notifications of the sessions dir
+ */
+static const int UpdateDelay = 100;
+
 KateSessionManager::KateSessionManager(QObject *parent, const QString &sessionsDir)
     : QObject(parent)
+    , m_jumpListWritten(false)
 {
     if (sessionsDir.isEmpty()) {
         m_sessionsDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/kate/sessions");
@@ -63,9 +78,15 @@ KateSessionManager::KateSessionManager(QObject *parent, const QString &sessionsD
     // create dir if needed
     QDir().mkpath(m_sessionsDir);
 
+    // watch the files, too: their notifications tell which session files need a new stat
     m_dirWatch = new KDirWatch(this);
-    m_dirWatch->addDir(m_sessionsDir);
-    connect(m_dirWatch, &KDirWatch::dirty, this, &KateSessionManager::updateSessionList);
+    m_dirWatch->addDir(m_sessionsDir, KDirWatch::WatchFiles);
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(UpdateDelay);
+    connect(&m_updateTimer, &QTimer::timeout, this, &KateSessionManager::updateSessionList);
+    connect(m_dirWatch, &KDirWatch::dirty, this, &KateSessionManager::sessionFileChanged);
+    connect(m_dirWatch, &KDirWatch::created, this, &KateSessionManager::sessionFileChanged);
+    connect(m_dirWatch, &KDirWatch::deleted, this, &KateSessionManager::sessionFileChanged);
 
     updateSessionList();
 }
@@ -77,36 +98,65 @@ KateSessionManager::~KateSessionManager()
 
 void KateSessionManager::updateSessionList()
 {
-    QStringList list;
-
-    // Let's get a list of all session we have atm
-    QDir dir(m_sessionsDir, QStringLiteral("*.katesession"), QDir::Time);
+    m_updateTimer.stop();
 
-    for (unsigned int i = 0; i < dir.count(); ++i) {
-        QString name = dir[i];
-        name.chop(12); // .katesession
-        list << QUrl::fromPercentEncoding(name.toLatin1());
-    }
+    // Let's get a list of all session files we have atm, no need to stat them for that
+    const QStringList files = QDir(m_sessionsDir).entryList(QStringList(QStringLiteral("*.katesession")), QDir::Files, QDir::NoSort);
 
-    // write jump list actions to disk in the kate.desktop file
-    updateJumpListActions(list);
+    QSet<QString> current;
+    current.reserve(files.size());
 
     bool changed = false;
 
-    // Add new sessions to our list
-    for (const QString session : qAsConst(list)) {
-        if (!m_sessions.contains(session)) {
-            const QString file = sessionFileForName(session);
-            m_sessions.insert(session, KateSession::create(file, session));
+    // Add new sessions to our list, only their names need decoding, only new and changed files are stat'ed
+    for (const QString &file : files) {
+        current.insert(file);
+        const auto known = m_sessionFiles.find(file);
+        if (known != m_sessionFiles.end()) {
+            if (m_changedSessionFiles.contains(file)) {
+                known.value().lastModified = QFileInfo(m_sessionsDir + QLatin1Char('/') + file).lastModified();
+            }
+            continue;
+        }
+
+        QString name = file;
+        name.chop(12); // .katesession
+        name = QUrl::fromPercentEncoding(name.toLatin1());
+        m_sessionFiles.insert(file, SessionFile{name, QFileInfo(m_sessionsDir + QLatin1Char('/') + file).lastModified()});
+
+        if (!m_sessions.contains(name)) {
+            m_sessions.insert(name, KateSession::create(sessionFileForName(name), name));
             changed = true;
         }
     }
-    // Remove gone sessions from our list
-    for (const QString session : m_sessions.keys()) {
-        if ((list.indexOf(session) < 0) && (m_sessions.value(session) != activeSession())) {
-            m_sessions.remove(session);
+
+    // Remove gone sessions from our list, the active one stays until it is no longer active
+    for (auto it = m_sessionFiles.begin(); it != m_sessionFiles.end();) {
+        if (current.contains(it.key())) {
+            ++it;
+            continue;
+        }
+
+        const auto session = m_sessions.find(it.value().name);
+        if (session != m_sessions.end()) {
+            if (session.value() == activeSession()) {
+                ++it;
+                continue;
+            }
+            m_sessions.erase(session);
             changed = true;
         }
+        it = m_sessionFiles.erase(it);
+    }
+
+    m_changedSessionFiles.clear();
+
+    // write jump list actions to disk in the kate.desktop file, if they changed
+    const QStringList jumpList = jumpListSessions(files);
+    if (!m_jumpListWritten || jumpList != m_jumpListSessions) {
+        m_jumpListSessions = jumpList;
+        m_jumpListWritten = true;
+        updateJumpListActions(jumpList);
     }
 
     if (changed) {
@@ -114,6 +164,40 @@ void KateSessionManager::updateSessionList()
     }
 }
 
+void KateSessionManager::sessionFileChanged(const QString &path)
+{
+    // the dir itself only tells that files appeared or vanished, the listing covers that
+    if (path != m_sessionsDir) {
+        m_changedSessionFiles.insert(QFileInfo(path).fileName());
+    }
+    m_updateTimer.start();
+}
+
+QStringList KateSessionManager::jumpListSessions(const QStringList &files) const
+{
+    QVector<QPair<QDateTime, QString>> times;
+    times.reserve(files.size());
+    for (const QString &file : files) {
+        times.append(qMakePair(m_sessionFiles.value(file).lastModified, file));
+    }
+
+    // newest first, only the first few need an order
+    const int count = std::min(times.size(), MaxJumpListSessions);
+    std::partial_sort(times.begin(), times.begin() + count, times.end(), [](const QPair<QDateTime, QString> &a, const QPair<QDateTime, QString> &b) {
+        return (a.first != b.first) ? (a.first > b.first) : (a.second < b.second);
+    });
+
+    QStringList sessions;
+    sessions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        sessions << m_sessionFiles.value(times.at(i).second).name;
+    }
+
+    // alphabetical to avoid even more a needed update
+    sessions.sort();
+    return sessions;
+}
+
 bool KateSessionManager::activateSession(KateSession::Ptr session,
         const bool closeAndSaveLast,
         const bool loadNew)
@@ -133,7 +217,7 @@ bool KateSessionManager::activateSession(KateSession::Ptr session,
         if (instances.contains(session->name())) {
             if (KMessageBox::questionYesNo(nullptr, i18n("Session '%1' is already opened in another kate instance, change there instead of reopening?", session->name()),
                                            QString(), KStandardGuiItem::yes(), KStandardGuiItem::no(), QStringLiteral("katesessionmanager_switch_instance")) == KMessageBox::Yes) {
-                instances[session->name()]->dbus_if->call(QStringLiteral("activate"));
+                instances[session->name()]->activate();
                 cleanupRunningKateAppInstanceMap(&instances);
                 return false;
             }
@@ -170,8 +254,13 @@ bool KateSessionManager::activateSession(KateSession::Ptr session,
     return true;
 }
 
-void KateSessionManager::loadSession(const KateSession::Ptr &session) const
+void KateSessionManager::loadSession(const KateSession::Ptr &session)
 {
+    KateStartupTrace::Span span("KateSessionManager::loadSession", session->name());
+
+    // the session might just have been saved, read what was saved
+    waitForSaved(session->file());
+
     // open the new session
     KSharedConfigPtr sharedConfig = KSharedConfig::openConfig();
     KConfig *sc = session->config();
@@ -195,6 +284,7 @@ void KateSessionManager::loadSession(const KateSession::Ptr &session) const
         // a new, named session, read settings of the default session.
         if (! sc->hasGroup("Open MainWindows")) {
             delete_cfg = true;
+            waitForSaved(anonymousSessionFile());
             cfg = new KConfig(anonymousSessionFile(), KConfig::SimpleConfig);
         }
 
@@ -245,6 +335,8 @@ KateSession::Ptr KateSessionManager::giveSession(const QString &name)
 
     KateSession::Ptr s = KateSession::create(sessionFileForName(name), name);
     saveSessionTo(s->config());
+    // new sessions show up on disk at once, for other instances, too
+    waitForSaved(s->file());
     m_sessions[name] = s;
     // Due to this add to m_sessions will updateSessionList() no signal emit,
     // but it's importand to add. Otherwise could it be happen that m_activeSession
@@ -260,6 +352,8 @@ bool KateSessionManager::deleteSession(KateSession::Ptr session)
         return false;
     }
 
+    // a pending save must not bring the file back
+    waitForSaved(session->file());
     QFile::remove(session->file());
     m_sessions.remove(session->name());
     // Due to this remove from m_sessions will updateSessionList() no signal emit,
@@ -296,6 +390,7 @@ QString KateSessionManager::renameSession(KateSession::Ptr session, const QStrin
     const QString newFile = sessionFileForName(name);
 
     session->config()->sync();
+    waitForSaved(session->file());
 
     const QUrl srcUrl = QUrl::fromLocalFile(session->file());
     const QUrl dstUrl = QUrl::fromLocalFile(newFile);
@@ -322,7 +417,7 @@ QString KateSessionManager::renameSession(KateSession::Ptr session, const QStrin
     return name;
 }
 
-void KateSessionManager::saveSessionTo(KConfig *sc) const
+void KateSessionManager::saveSessionTo(KConfig *sc)
 {
     // Clear the session file to avoid to accumulate outdated entries
     for (auto group : sc->groupList()) {
@@ -347,22 +442,18 @@ void KateSessionManager::saveSessionTo(KConfig *sc) const
         }
     }
 
-    sc->sync();
+    // the GUI only collects the state, the file is written in the background
+    m_writer.save(sc);
+}
 
-    /**
-     * try to sync file to disk
-     */
-    QFile fileToSync(sc->name());
-    if (fileToSync.open(QIODevice::ReadOnly)) {
-#ifndef Q_OS_WIN
-        // ensure that the file is written to disk
-#ifdef HAVE_FDATASYNC
-        fdatasync(fileToSync.handle());
-#else
-        fsync(fileToSync.handle());
-#endif
-#endif
-    }
+void KateSessionManager::waitForSaved()
+{
+    m_writer.waitForFinished();
+}
+
+void KateSessionManager::waitForSaved(const QString &fileName)
+{
+    m_writer.waitForSaved(fileName);
 }
 
 bool KateSessionManager::saveActiveSession(bool rememberAsLast)
@@ -585,12 +676,9 @@ void KateSessionManager::updateJumpListActions(const QStringList &sessionList)
         return action.startsWith(QLatin1String("Session "));
     }), newActions.end());
 
-    // Limit the number of list entries we like to offer
-    const int maxEntryCount = std::min(sessionList.count(), 10);
-
-    // sessionList is ordered by time, but we like it alphabetical to avoid even more a needed update
-    QStringList sessionSubList = sessionList.mid(0, maxEntryCount);
-    sessionSubList.sort();
+    // Limit the number of list entries we like to offer, see jumpListSessions()
+    const int maxEntryCount = std::min(sessionList.count(), MaxJumpListSessions);
+    const QStringList sessionSubList = sessionList.mid(0, maxEntryCount);
 
     // we compute the new group names in advance so we can tell whether we changed something
     // and avoid touching the desktop file leading to an expensive ksycoca recreation
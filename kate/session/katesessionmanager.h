@@ -22,9 +22,14 @@
 #define __KATE_SESSION_MANAGER_H__
 
 #include "katesession.h"
+#include "katesessionwriter.h"
 
 #include <QObject>
+#include <QDateTime>
 #include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
 
 typedef QList<KateSession::Ptr> KateSessionList;
 
@@ -67,6 +72,17 @@ public:
      */
     bool saveActiveSession(bool rememberAsLast = false);
 
+    /**
+     * Sessions are written in the background, wait until all saved sessions are on disk.
+     */
+    void waitForSaved();
+
+    /**
+     * Wait until the saves of one session file are on disk, not for the other ones.
+     * @param fileName session file
+     */
+    void waitForSaved(const QString &fileName);
+
     /**
      * return the current active session
      * sessionFile == empty means we have no session around for this instance of kate
@@ -181,6 +197,12 @@ private Q_SLOTS:
      */
     void updateSessionList();
 
+    /**
+     * a session file or the sessions dir changed, collect it for the next update
+     * @param path changed file or the sessions dir
+     */
+    void sessionFileChanged(const QString &path);
+
 private:
     /**
      * Ask the user for a new session name, when needed.
@@ -216,18 +238,25 @@ private:
     /**
       * helper function to save the session to a given config object
       */
-    void saveSessionTo(KConfig *sc) const;
+    void saveSessionTo(KConfig *sc);
 
     /**
      * restore sessions documents, windows, etc...
      */
-    void loadSession(const KateSession::Ptr &session) const;
+    void loadSession(const KateSession::Ptr &session);
 
     /**
      * Writes sessions as jump list actions to the kate.desktop file
      */
     void updateJumpListActions(const QStringList &sessionList);
 
+    /**
+     * The sessions offered in the jump list: the most recently modified ones, sorted by name.
+     * @param files session files in the sessions dir
+     * @return session names
+     */
+    QStringList jumpListSessions(const QStringList &files) const;
+
 private:
     /**
      * absolute path to dir in home dir where to store the sessions
@@ -239,12 +268,47 @@ private:
      */
     QHash<QString, KateSession::Ptr> m_sessions;
 
+    /**
+     * a session file seen in the sessions dir
+     */
+    struct SessionFile {
+        QString name;
+        QDateTime lastModified;
+    };
+
+    /**
+     * session files seen in the sessions dir => session name and modification time
+     * only files that appear or vanish are handled on updates, only new and changed ones are stat'ed
+     */
+    QHash<QString, SessionFile> m_sessionFiles;
+
+    /**
+     * session files reported as changed since the last update
+     */
+    QSet<QString> m_changedSessionFiles;
+
+    /**
+     * sessions last written as jump list actions, the desktop file is only touched if they change
+     */
+    QStringList m_jumpListSessions;
+    bool m_jumpListWritten;
+
     /**
      * current active session
      */
     KateSession::Ptr m_activeSession;
 
+    /**
+     * writes the session files in a worker thread
+     */
+    KateSessionWriter m_writer;
+
     class KDirWatch *m_dirWatch;
+
+    /**
+     * collects the change notifications of the dir, saving a session triggers several
+     */
+    QTimer m_updateTimer;
 };
 
 #endif
@@ -0,0 +1,192 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#include "config.h"
+
+#include "katesessionwriter.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
+
+#ifndef Q_OS_WIN
+#include <unistd.h>
+#endif
+
+/**
+ * collect the entries of a group and its nested groups
+ */
+static void snapshotGroup(const KConfigGroup &group, const QStringList &path, KateSessionWriter::Snapshot &snapshot)
+{
+    snapshot.append(qMakePair(path, group.entryMap()));
+
+    for (const QString &name : group.groupList()) {
+        snapshotGroup(group.group(name), path + QStringList(name), snapshot);
+    }
+}
+
+/**
+ * Writes the latest snapshot of one file.
+ */
+class KateSessionWriteJob : public QRunnable
+{
+public:
+    KateSessionWriteJob(KateSessionWriter *writer, const QString &fileName)
+        : m_writer(writer)
+        , m_fileName(fileName)
+    {
+    }
+
+    void run() override
+    {
+        write(m_writer->takePending(m_fileName));
+        m_writer->jobDone(m_fileName);
+    }
+
+private:
+    /**
+     * write the entries to the file and sync it to disk
+     */
+    void write(const KateSessionWriter::Snapshot &snapshot)
+    {
+        /**
+         * own config object for this thread, the file is replaced as whole
+         * clear it first to avoid to accumulate outdated entries
+         */
+        KConfig config(m_fileName, KConfig::SimpleConfig);
+        for (const QString &group : config.groupList()) {
+            config.deleteGroup(group);
+        }
+
+        for (const auto &entries : qAsConst(snapshot)) {
+            const QStringList &path = entries.first;
+            KConfigGroup group(&config, path.first());
+            for (int i = 1; i < path.size(); ++i) {
+                group = group.group(path.at(i));
+            }
+
+            for (auto it = entries.second.constBegin(); it != entries.second.constEnd(); ++it) {
+                group.writeEntry(it.key(), it.value());
+            }
+        }
+
+        config.sync();
+
+        /**
+         * try to sync file to disk
+         */
+        QFile fileToSync(m_fileName);
+        if (fileToSync.open(QIODevice::ReadOnly)) {
+#ifndef Q_OS_WIN
+            // ensure that the file is written to disk
+#ifdef HAVE_FDATASYNC
+            fdatasync(fileToSync.handle());
+#else
+            fsync(fileToSync.handle());
+#endif
+#endif
+        }
+    }
+
+private:
+    KateSessionWriter *const m_writer;
+    const QString m_fileName;
+};
+
+KateSessionWriter::KateSessionWriter()
+    : m_writeCount(0)
+{
+    m_writer.setMaxThreadCount(1);
+}
+
+KateSessionWriter::~KateSessionWriter()
+{
+    waitForFinished();
+}
+
+KateSessionWriter::Snapshot KateSessionWriter::snapshot(const KConfig *config)
+{
+    Snapshot snapshot;
+    for (const QString &name : config->groupList()) {
+        snapshotGroup(KConfigGroup(config, name), QStringList(name), snapshot);
+    }
+    return snapshot;
+}
+
+void KateSessionWriter::save(KConfig *config)
+{
+    const QString fileName = config->name();
+    bool queued;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        queued = m_pending.contains(fileName);
+        m_pending.insert(fileName, snapshot(config));
+
+        // a queued job not yet started will write the new snapshot
+        if (!queued) {
+            ++m_jobs[fileName];
+        }
+    }
+
+    // the file is written by the writer thread, not by this config
+    config->markAsClean();
+
+    if (!queued) {
+        m_writer.start(new KateSessionWriteJob(this, fileName));
+    }
+}
+
+void KateSessionWriter::waitForFinished()
+{
+    m_writer.waitForDone();
+}
+
+void KateSessionWriter::waitForSaved(const QString &fileName)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    while (m_jobs.contains(fileName)) {
+        m_jobDone.wait(&m_pendingMutex);
+    }
+}
+
+int KateSessionWriter::writeCount()
+{
+    QMutexLocker locker(&m_pendingMutex);
+    return m_writeCount;
+}
+
+KateSessionWriter::Snapshot KateSessionWriter::takePending(const QString &fileName)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    return m_pending.take(fileName);
+}
+
+void KateSessionWriter::jobDone(const QString &fileName)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    ++m_writeCount;
+    if (--m_jobs[fileName] == 0) {
+        m_jobs.remove(fileName);
+    }
+    m_jobDone.wakeAll();
+}
@@ -0,0 +1,134 @@
+/* This file is part of the KDE project
+ *
+ *  Copyright (C) 2026 agent <agent@local>
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ *  Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KATE_SESSION_WRITER_H
+#define KATE_SESSION_WRITER_H
+
+#include "kateprivate_export.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+class KConfig;
+
+/**
+ * Writes session files in a worker thread.
+ *
+ * The caller fills the session config in memory, the writer takes a
+ * snapshot of its entries and hands it to a single writer thread. There the
+ * file is written through KConfig, that replaces the file atomically, and
+ * synced to disk. A save of a file that is still queued replaces the queued
+ * snapshot, only the latest state is written.
+ */
+class KATE_TESTS_EXPORT KateSessionWriter
+{
+public:
+    /**
+     * Entries of all groups of a config, nested groups by their path of group names.
+     */
+    typedef QVector<QPair<QStringList, QMap<QString, QString>>> Snapshot;
+
+    KateSessionWriter();
+
+    /**
+     * Waits until all queued saves are written.
+     */
+    ~KateSessionWriter();
+
+    /**
+     * Take a snapshot of all entries of the config.
+     * @param config config to read
+     * @return entries of all groups
+     */
+    static Snapshot snapshot(const KConfig *config);
+
+    /**
+     * Queue writing the config to its file.
+     * The config is marked as clean afterwards, it must not write the file itself.
+     * @param config filled config, in memory
+     */
+    void save(KConfig *config);
+
+    /**
+     * Wait until all queued saves are written.
+     */
+    void waitForFinished();
+
+    /**
+     * Wait until the queued saves of one file are written, saves of other files go on.
+     * Needed before a session file is read, moved or deleted.
+     * @param fileName file to wait for
+     */
+    void waitForSaved(const QString &fileName);
+
+    /**
+     * Number of files written since construction, saves coalesced with a queued one are not counted.
+     * @return written files
+     */
+    int writeCount();
+
+private:
+    friend class KateSessionWriteJob;
+
+    /**
+     * Take the latest snapshot of a file, called by the writer thread.
+     * @param fileName file to write
+     * @return entries to write
+     */
+    Snapshot takePending(const QString &fileName);
+
+    /**
+     * A job for the file is done, wake up those waiting for it.
+     * @param fileName written file
+     */
+    void jobDone(const QString &fileName);
+
+private:
+    /**
+     * single writer thread, one file at a time
+     */
+    QThreadPool m_writer;
+
+    /**
+     * file => latest snapshot not yet written, shared with the writer thread
+     */
+    QMutex m_pendingMutex;
+    QHash<QString, Snapshot> m_pending;
+
+    /**
+     * file => number of queued or running jobs, signalled whenever a job is done
+     */
+    QHash<QString, int> m_jobs;
+    QWaitCondition m_jobDone;
+
+    /**
+     * number of written files
+     */
+    int m_writeCount;
+};
+
+#endif